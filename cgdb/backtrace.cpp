@@ -0,0 +1,233 @@
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#if HAVE_STRING_H
+#include <string.h>
+#endif /* HAVE_STRING_H */
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "sys_util.h"
+#include "sys_win.h"
+#include "backtrace.h"
+#include "pane_list.h"
+#include "cgdb.h"
+#include "highlight_groups.h"
+
+/* The most frames asked for at once */
+#define BACKTRACE_CHUNK 64
+
+struct backtrace {
+    /* The window, cursor and scroll position, a row per frame */
+    struct pane_list list;
+
+    /* The frames gotten so far, frames[i] is frame number i */
+    std::vector<tgdb_frame> frames;
+
+    int requested;              /* The frames before this were asked for */
+    int complete;               /* Non-zero if the outermost frame is known */
+    int error;                  /* Non-zero if gdb had no stack to give */
+
+    int cur;                    /* The frame selected in gdb */
+};
+
+/* The rows the cursor can be on, the frames gotten so far.
+ *
+ * While the stack isn't complete, the row after the last frame gotten
+ * shows the frames are being loaded, and the cursor can be on it too. */
+static int backtrace_nrows(struct backtrace *bt)
+{
+    return (int)bt->frames.size() + (bt->complete ? 0 : 1);
+}
+
+struct backtrace *backtrace_new(SWINDOW *win)
+{
+    struct backtrace *bt = new backtrace();
+
+    pane_list_init(&bt->list, win);
+    backtrace_clear(bt);
+
+    return bt;
+}
+
+void backtrace_free(struct backtrace *bt)
+{
+    swin_delwin(bt->list.win);
+    delete bt;
+}
+
+void backtrace_move(struct backtrace *bt, SWINDOW *win)
+{
+    pane_list_move(&bt->list, win);
+    pane_list_scroll_to_sel(&bt->list, backtrace_nrows(bt));
+}
+
+void backtrace_clear(struct backtrace *bt)
+{
+    bt->frames.clear();
+    bt->requested = 0;
+    bt->complete = 0;
+    bt->error = 0;
+    bt->list.sel_line = 0;
+    bt->list.top = 0;
+    bt->cur = 0;
+}
+
+void backtrace_add_frames(struct backtrace *bt, int low, int high,
+        int error, const std::list<tgdb_frame> &frames)
+{
+    /* Asked for before the stack changed */
+    if (low != (int)bt->frames.size())
+        return;
+
+    if (error) {
+        /* Past the outermost frame, or there is no stack at all */
+        bt->complete = 1;
+        bt->error = bt->frames.empty();
+        return;
+    }
+
+    bt->error = 0;
+    bt->frames.insert(bt->frames.end(), frames.begin(), frames.end());
+
+    if ((int)frames.size() < high - low + 1)
+        bt->complete = 1;
+
+    pane_list_scroll_to_sel(&bt->list, backtrace_nrows(bt));
+}
+
+int backtrace_wants(struct backtrace *bt, int *low, int *high)
+{
+    /* Fill the window, and read ahead another window */
+    int needed = bt->list.top + pane_list_height(&bt->list) * 2;
+
+    if (!bt->list.win || bt->complete || bt->requested >= needed)
+        return 0;
+
+    /* Wait for the frames already asked for, so the frames come back in
+     * order and a deep stack isn't walked more than once at a time */
+    if (bt->requested > (int)bt->frames.size())
+        return 0;
+
+    *low = bt->requested;
+    *high = bt->requested + std::max(needed - bt->requested,
+            BACKTRACE_CHUNK) - 1;
+    bt->requested = *high + 1;
+
+    return 1;
+}
+
+int backtrace_input(struct backtrace *bt, int key, const tgdb_frame **frame)
+{
+    switch (pane_list_input(&bt->list, key, backtrace_nrows(bt))) {
+        case PANE_LIST_KEY_CLOSE:
+            return -1;
+        case PANE_LIST_KEY_SELECT:
+            if (bt->list.sel_line < (int)bt->frames.size()) {
+                bt->cur = bt->list.sel_line;
+                *frame = &bt->frames[bt->list.sel_line];
+                return 1;
+            }
+            break;
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+/* Draw a frame like gdb's backtrace command would */
+static void backtrace_display_frame(struct backtrace *bt,
+        const tgdb_frame &frame, int width)
+{
+    std::string text;
+    char buf[64];
+
+    if (frame.addr) {
+        snprintf(buf, sizeof(buf), "0x%016" PRIx64 " in ", frame.addr);
+        text = buf;
+    }
+
+    text += frame.func.empty() ? "??" : frame.func;
+
+    if (!frame.path.empty()) {
+        const char *base = strrchr(frame.path.c_str(), '/');
+
+        text += " at ";
+        text += base ? base + 1 : frame.path.c_str();
+        snprintf(buf, sizeof(buf), ":%d", frame.line);
+        text += buf;
+    } else if (!frame.from.empty()) {
+        text += " from " + frame.from;
+    }
+
+    if ((int)text.size() > width)
+        text.resize(std::max(width, 0));
+
+    swin_wprintw(bt->list.win, "%s", text.c_str());
+}
+
+void backtrace_display(struct backtrace *bt, int focus,
+        enum win_refresh dorefresh)
+{
+    SWINDOW *win = bt->list.win;
+    int rows, width, lwidth, i;
+    int exe_attr;
+    char title[64];
+
+    if (!win)
+        return;
+
+    rows = pane_list_height(&bt->list);
+    width = swin_getmaxx(win);
+
+    exe_attr = hl_groups_get_attr(hl_groups_instance,
+            HLG_EXECUTING_LINE_ARROW);
+
+    /* The title, with how deep the stack is known to be */
+    if (bt->error)
+        snprintf(title, sizeof(title), "Backtrace: No stack.");
+    else if (bt->complete)
+        snprintf(title, sizeof(title), "Backtrace: %d frames",
+                (int)bt->frames.size());
+    else
+        snprintf(title, sizeof(title), "Backtrace: %d+ frames",
+                (int)bt->frames.size());
+
+    pane_list_display_title(&bt->list, title);
+
+    lwidth = log10_uint(std::max(bt->list.top + rows, 1)) + 1;
+
+    for (i = 0; i < rows; ++i) {
+        int level = bt->list.top + i;
+
+        swin_wmove(win, i + 1, 0);
+        swin_wclrtoeol(win);
+
+        if (level < (int)bt->frames.size()) {
+            int attr = (level == bt->cur) ? exe_attr : 0;
+
+            swin_wattron(win, attr);
+            swin_wprintw(win, "#%-*d", lwidth, level);
+            swin_wattroff(win, attr);
+
+            pane_list_display_cursor(&bt->list, level, focus);
+            backtrace_display_frame(bt, bt->frames[level],
+                    width - lwidth - 3);
+        } else if (level == (int)bt->frames.size() && !bt->complete) {
+            swin_wprintw(win, "#%-*d", lwidth, level);
+            pane_list_display_cursor(&bt->list, level, focus);
+            swin_wprintw(win, "...");
+        } else {
+            swin_waddch(win, '~');
+        }
+    }
+
+    pane_list_refresh(&bt->list, dorefresh);
+}
@@ -0,0 +1,103 @@
+#ifndef _BACKTRACE_H_
+#define _BACKTRACE_H_
+
+/* backtrace.h:
+ * ------------
+ *
+ * The backtrace pane shows the frames of the stack of the selected thread.
+ *
+ * The frames are asked for from gdb a window at a time, only as far as the
+ * user has scrolled plus a little more. A stack of many thousand frames
+ * costs only the frames that were looked at. The frames are kept until the
+ * program stops again.
+ */
+
+#include <list>
+
+#include "sys_win.h"
+#include "tgdb.h"
+
+struct backtrace;
+
+/* backtrace_new: Create a new backtrace pane.
+ * ______________
+ *
+ *   win: The window to draw in, OK to pass NULL
+ *
+ * return value: a new backtrace pane.
+ */
+struct backtrace *backtrace_new(SWINDOW *win);
+
+/* backtrace_free: Release the memory associated with a backtrace pane.
+ * ---------------
+ *
+ *   bt: The backtrace pane to free.
+ */
+void backtrace_free(struct backtrace *bt);
+
+/* backtrace_move: Draw the backtrace pane in another window.
+ * ---------------
+ *
+ *   bt:  The backtrace pane
+ *   win: The new window, the old one is deleted. OK to pass NULL.
+ */
+void backtrace_move(struct backtrace *bt, SWINDOW *win);
+
+/* backtrace_clear: Forget the frames, the stack changed.
+ * ----------------
+ *
+ *   bt: The backtrace pane
+ */
+void backtrace_clear(struct backtrace *bt);
+
+/* backtrace_add_frames: Add the frames gdb sent for a backtrace_wants range.
+ * ---------------------
+ *
+ *   bt:     The backtrace pane
+ *   low:    The first frame that was asked for
+ *   high:   The last frame that was asked for
+ *   error:  Non-zero if gdb could not get the frames
+ *   frames: The frames, fewer than asked for at the end of the stack
+ *
+ * Frames for a range that is no longer wanted are ignored.
+ */
+void backtrace_add_frames(struct backtrace *bt, int low, int high,
+        int error, const std::list<tgdb_frame> &frames);
+
+/* backtrace_wants: Determine the frames to ask gdb for next.
+ * ----------------
+ *
+ *   bt:   The backtrace pane
+ *   low:  Set to the first frame to ask for
+ *   high: Set to the last frame to ask for
+ *
+ * The frames are marked as asked for, they are not asked for again.
+ *
+ * Return Value: 1 if frames are needed to fill the window, otherwise 0.
+ */
+int backtrace_wants(struct backtrace *bt, int *low, int *high);
+
+/* backtrace_input: Send a key to the backtrace pane.
+ * ----------------
+ *
+ *   bt:    The backtrace pane
+ *   key:   The key the user typed
+ *   frame: Set to the frame the user chose
+ *
+ *  returns -1 when the user closed the pane.
+ *  returns 0 when the key was handled, or not for the pane.
+ *  returns 1 when the user chose a frame.
+ */
+int backtrace_input(struct backtrace *bt, int key, const tgdb_frame **frame);
+
+/* backtrace_display: Redraw the backtrace pane.
+ * ------------------
+ *
+ *   bt:        The backtrace pane
+ *   focus:     Non-zero if the pane has focus
+ *   dorefresh: How to refresh the window
+ */
+void backtrace_display(struct backtrace *bt, int focus,
+        enum win_refresh dorefresh);
+
+#endif /* _BACKTRACE_H_ */
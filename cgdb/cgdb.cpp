@@ -30,10 +30,6 @@
 #include <sys/time.h>
 #endif
 
-#ifdef HAVE_SYS_SELECT_H
-#include <sys/select.h>
-#endif /* HAVE_SYS_SELECT_H */
-
 #if HAVE_SYS_STAT_H
 #include <sys/stat.h>
 #endif
@@ -85,6 +81,7 @@
 #include "terminal.h"
 #include "rline.h"
 #include "usage.h"
+#include "event_loop.h"
 
 /* --------- */
 /* Constants */
@@ -110,6 +107,9 @@ static char *debugger_path = NULL;  /* Path to debugger to use */
 /* Set to 1 if the user requested cgdb to wait for the debugger to attach. */
 static int wait_for_debugger_to_attach = 0;
 
+/* File to record the traffic to and from gdb to, or NULL */
+static char *record_path = NULL;
+
 std::unique_ptr<kui_manager> kui_ctx; /* The key input package */
 
 std::shared_ptr<kui_map_set> kui_map;
@@ -172,6 +172,21 @@ int signal_pipe[2] = { -1, -1 };
 /* Original terminal attributes */
 static struct termios term_attributes;
 
+/**
+ * Turn the terminal's bracketed paste mode on or off.
+ *
+ * When it is on, the terminal surrounds pasted text with the
+ * CGDB_KEY_PASTE_START and CGDB_KEY_PASTE_END sequences.
+ * Terminals that don't support it ignore the request.
+ */
+static void set_bracketed_paste(bool enable)
+{
+    const char *seq = enable ? "\033[?2004h" : "\033[?2004l";
+
+    if (io_writen(STDOUT_FILENO, seq, strlen(seq)) == -1)
+        clog_error(CLOG_CGDB, "could not set bracketed paste mode");
+}
+
 /**
  * Runs a command in the shell.  The shell may be interactive, and CGDB
  * will be paused for the duration of the shell.  Any leading stuff, like
@@ -192,6 +207,7 @@ int run_shell_command(const char *command)
     printf("\n");
 
     /* Put the terminal in cooked mode and turn on echo */
+    set_bracketed_paste(false);
     swin_endwin();
     tty_set_attributes(STDIN_FILENO, &term_attributes);
 
@@ -213,6 +229,7 @@ int run_shell_command(const char *command)
 
     /* Turn off echo and put the terminal back into raw mode */
     tty_cbreak(STDIN_FILENO, &term_attributes);
+    set_bracketed_paste(true);
     if_draw();
 
     return rv;
@@ -248,7 +265,7 @@ static char *version_info(void)
 static void parse_long_options(int *argc, char ***argv)
 {
     int c, option_index = 0, n = 1;
-    const char *args = "wd:hv";
+    const char *args = "wd:r:hv";
 
 #ifdef HAVE_GETOPT_H
     static struct option long_options[] = {
@@ -301,6 +318,14 @@ static void parse_long_options(int *argc, char ***argv)
                     n++;
                 }
                 break;
+            case 'r':
+                record_path = strdup(optarg);
+                if (optarg == (*argv)[n + 1]) {
+                    n += 2;
+                } else {
+                    n++;
+                }
+                break;
             case 'h':
                 usage();
                 exit(0);
@@ -377,13 +402,40 @@ static void inferiors_source_files(void *context,
         const std::list<std::string> &source_files);
 static void disassemble_func(void *context,
         uint64_t addr_start, uint64_t addr_end, bool error,
-        const std::list<std::string> &disasm);
+        const std::list<tgdb_disasm_line> &disasm);
 static void disassemble_pc(void *context,
         uint64_t addr_start, uint64_t addr_end, bool error,
-        const std::list<std::string> &disasm);
+        const std::list<tgdb_disasm_line> &disasm);
+static void disassemble_range(void *context,
+        uint64_t addr_start, uint64_t addr_end, bool error,
+        const std::list<tgdb_disasm_line> &disasm);
 static
 void update_file_pos(void *context,
         const tgdb_file_position &file_position);
+static void stack_frames(void *context, int low, int high, bool error,
+        const std::list<tgdb_frame> &frames);
+static void stack_changed(void *context);
+static void frame_changed(void *context);
+static void stack_variables(void *context, bool error,
+        const std::list<std::string> &names);
+static void var_created(void *context, const std::string &name, bool error,
+        const tgdb_varobj &varobj);
+static void var_children(void *context, const std::string &name, bool error,
+        const std::list<tgdb_varobj> &children);
+static void var_changes(void *context, bool error,
+        const std::list<tgdb_varobj_change> &changes);
+static void register_names(void *context, bool error,
+        const std::list<tgdb_register> &registers);
+static void changed_registers(void *context, bool error,
+        const std::list<int> &numbers);
+static void register_values(void *context, bool error,
+        const std::list<tgdb_register> &registers);
+static void memory(void *context, const std::string &addr, uint64_t start,
+        int count, bool error, const std::list<tgdb_memory_block> &blocks);
+static void threads_changed(void *context);
+static void thread_info(void *context, int id, bool error,
+        const tgdb_thread_info &info);
+static void gdb_started(void *context);
             
 tgdb_callbacks callbacks = { 
     NULL,       
@@ -393,7 +445,22 @@ tgdb_callbacks callbacks = {
     inferiors_source_files,
     disassemble_func,
     disassemble_pc,
-    update_file_pos
+    disassemble_range,
+    update_file_pos,
+    stack_frames,
+    stack_changed,
+    frame_changed,
+    stack_variables,
+    var_created,
+    var_children,
+    var_changes,
+    register_names,
+    changed_registers,
+    register_values,
+    memory,
+    threads_changed,
+    thread_info,
+    gdb_started
 };
 
 
@@ -409,13 +476,38 @@ static int start_gdb(int argc, char *argv[])
             get_gdb_width(), &gdb_console_fd, &gdb_mi_fd);
 }
 
-static void send_key(int focus, char key)
+static void send_keys(int focus, const char *keys, size_t n)
 {
     if (focus == 1) {
-        tgdb_send_char(tgdb, key);
+        tgdb_send_chars(tgdb, keys, n);
     }
 }
 
+/* user_input_paste: Handle text the user pasted into the terminal.
+ *
+ * When the GDB window would pass every key on to gdb anyways, the whole
+ * paste is written to gdb at once, without going through the mappings.
+ * Otherwise, the text is put back into the kui and processed as if the
+ * user typed it.
+ *
+ *  Returns:  -1 on error, 0 on success
+ */
+static int user_input_paste(void)
+{
+    std::string text;
+
+    if (kui_ctx->get_paste(text) == -1) {
+        clog_error(CLOG_CGDB, "kui_manager get_paste error");
+        return -1;
+    }
+
+    if (if_paste_to_gdb())
+        return tgdb_send_chars(tgdb, text.data(), text.size());
+
+    kui_ctx->unget_input(text);
+    return 0;
+}
+
 /* user_input: This function will get a key from the user and process it.
  *
  *  Returns:  -1 on error, 0 on success
@@ -437,6 +529,16 @@ static int user_input(void)
         return -1;
     }
 
+    /* Pasted text is handled in one piece. A paste end seen on its
+     * own has nothing left to do. */
+    if (key == CGDB_KEY_PASTE_START)
+        return user_input_paste();
+    else if (key == CGDB_KEY_PASTE_END)
+        return 0;
+
+    /* Let the interface skip drawing while more keys are queued */
+    if_set_input_pending(kui_ctx->cangetkey());
+
     val = if_input(key);
 
     if (val == -1) {
@@ -453,14 +555,12 @@ static int user_input(void)
             clog_error(CLOG_CGDB,
                 "kui_term_get_ascii_char_sequence_from_key error %d", key);
             return -1;
-        } else {
-            int length = strlen(seqbuf), i;
-
-            for (i = 0; i < length; i++)
-                send_key(val, seqbuf[i]);
-        }
-    } else
-        send_key(val, key);
+        } else
+            send_keys(val, seqbuf, strlen(seqbuf));
+    } else {
+        char c = key;
+        send_keys(val, &c, 1);
+    }
 
     return 0;
 }
@@ -483,7 +583,7 @@ static int user_input_loop()
         /* There are reasons that CGDB should wait to get more info from the kui.
          * See the documentation for kui_input_acceptable */
         if (!kui_input_acceptable)
-            return 0;
+            break;
 
         if (user_input() == -1) {
             clog_error(CLOG_CGDB, "user_input_loop failed");
@@ -491,6 +591,9 @@ static int user_input_loop()
         }
     } while (kui_ctx->cangetkey());
 
+    /* Draw whatever was skipped while keys were queued */
+    if_set_input_pending(0);
+
     return 0;
 }
 
@@ -606,22 +709,25 @@ static void update_source_files(const std::list<std::string> &source_files)
 }
 
 static void update_disassemble(bool pc, uint64_t addr_start, uint64_t addr_end,
-        bool error, const std::list<std::string> &disasm)
+        bool error, const std::list<tgdb_disasm_line> &disasm)
 {
     if (error) {
         //$ TODO mikesart: Get module name in here somehow? Passed in when calling tgdb_request_disassemble?
         //      or info sharedlibrary?
-        //$ TODO mikesart: Need way to make sure we don't recurse here on error.
-        //$ TODO mikesart: 100 lines? Way to load more at end?
 
         if (pc) {
-            /* Spew out a warning about disassemble failing
-             * and disasm next 100 instructions. */
+            /* Spew out a warning about disassemble failing */
             if_print_message(
                     "\nWarning: disassemble address 0x%" PRIx64 " failed.\n",
                     addr_start);
-        } else {
-            tgdb_request_disassemble_pc(tgdb, 100);
+        } else if (if_get_sview()->addr_frame) {
+            /* There is no function around the pc, or gdb can't look one
+             * up, disassemble the memory around it a window at a time.
+             * A function is always shown whole, gdb has no cheap way to
+             * tell how big it is before disassembling all of it. */
+            uint64_t addr = if_get_sview()->addr_frame;
+            tgdb_request_disassemble_range(tgdb, addr,
+                    addr + DISASM_WINDOW_BYTES);
         }
     } else {
         //$ TODO: If addr_start is equal to addr_end of some other
@@ -638,9 +744,9 @@ static void update_disassemble(bool pc, uint64_t addr_start, uint64_t addr_end,
             if (addr_start) {
                 path = sys_aprintf(
                     "** %s (%" PRIx64 " - %" PRIx64 ") **",
-                    disasm.front().c_str(), addr_start, addr_end);
+                    disasm.front().text.c_str(), addr_start, addr_end);
             } else {
-                path = sys_aprintf("** %s **", disasm.front().c_str());
+                path = sys_aprintf("** %s **", disasm.front().text.c_str());
             }
 
             node = source_get_node(sview, path);
@@ -652,8 +758,8 @@ static void update_disassemble(bool pc, uint64_t addr_start, uint64_t addr_end,
                 node->addr_start = addr_start;
                 node->addr_end = addr_end;
 
-                for (auto iter : disasm) {
-                    source_add_disasm_line(node, iter.c_str());
+                for (const auto &iter : disasm) {
+                    source_add_disasm_line(node, iter);
                 }
 
                 source_highlight(node);
@@ -667,6 +773,77 @@ static void update_disassemble(bool pc, uint64_t addr_start, uint64_t addr_end,
     }
 }
 
+/* A window of disassembly, requested by address, has arrived */
+static void update_disassemble_range(uint64_t addr_start, uint64_t addr_end,
+        bool error, const std::list<tgdb_disasm_line> &disasm)
+{
+    sviewer *sview = if_get_sview();
+    struct list_node *node;
+    bool backward = false;
+    int added;
+
+    /* Find the windowed node this window was requested for */
+    for (node = sview->list_head; node != NULL; node = node->next) {
+        if (!node->disasm_window || !node->disasm_loading)
+            continue;
+
+        if (addr_start == node->addr_end)
+            break;
+        if (addr_end == node->addr_start + 1) {
+            backward = true;
+            break;
+        }
+    }
+
+    if (!node) {
+        char *path;
+
+        if (error) {
+            if_print_message(
+                    "\nWarning: disassemble address 0x%" PRIx64 " failed.\n",
+                    addr_start);
+            return;
+        }
+
+        /* The first window, starting at the pc */
+        path = sys_aprintf("** 0x%" PRIx64 " **", addr_start);
+        node = source_add(sview, path);
+        free(path);
+
+        if (!node->disasm_window) {
+            node->language = TOKENIZER_LANGUAGE_ASM;
+            node->disasm_window = true;
+        }
+    }
+
+    node->disasm_loading = false;
+    added = error ? 0 : source_merge_disasm(sview, node, disasm);
+
+    /* Nothing came back, so there is nothing more that way */
+    if (added == 0) {
+        if (backward)
+            node->disasm_head_done = true;
+        else
+            node->disasm_tail_done = true;
+    }
+
+    source_highlight(node);
+
+    if (sview->cur != node && sview->addr_frame >= node->addr_start &&
+        sview->addr_frame <= node->addr_end)
+        source_set_exec_addr(sview, sview->addr_frame);
+
+    /* Keep loading until there is a window's height to scroll in */
+    if (sview->cur == node) {
+        uint64_t start, end;
+
+        if (source_disasm_wants(sview, &start, &end))
+            tgdb_request_disassemble_range(tgdb, start, end);
+    }
+
+    if_draw();
+}
+
 static void command_response(void *context, struct tgdb_response *response)
 {
     switch (response->header)
@@ -692,24 +869,109 @@ static void inferiors_source_files(void *context,
 
 static void disassemble_func(void *context,
         uint64_t addr_start, uint64_t addr_end, bool error,
-        const std::list<std::string> &disasm)
+        const std::list<tgdb_disasm_line> &disasm)
 {
     update_disassemble(false, addr_start, addr_end, error, disasm);
 }
 
 static void disassemble_pc(void *context,
         uint64_t addr_start, uint64_t addr_end, bool error,
-        const std::list<std::string> &disasm)
+        const std::list<tgdb_disasm_line> &disasm)
 {
     update_disassemble(true, addr_start, addr_end, error, disasm);
 }
 
+static void disassemble_range(void *context,
+        uint64_t addr_start, uint64_t addr_end, bool error,
+        const std::list<tgdb_disasm_line> &disasm)
+{
+    update_disassemble_range(addr_start, addr_end, error, disasm);
+}
+
 static void update_file_pos(void *context,
         const tgdb_file_position &file_position)
 {
     update_file_position(file_position);
 }
 
+static void stack_frames(void *context, int low, int high, bool error,
+        const std::list<tgdb_frame> &frames)
+{
+    if_backtrace_frames(low, high, error, frames);
+}
+
+static void stack_changed(void *context)
+{
+    if_backtrace_changed();
+}
+
+static void frame_changed(void *context)
+{
+    if_variables_frame_changed();
+    if_registers_frame_changed();
+    if_memory_frame_changed();
+    if_threads_frame_changed();
+}
+
+static void stack_variables(void *context, bool error,
+        const std::list<std::string> &names)
+{
+    if_variables_locals(error, names);
+}
+
+static void var_created(void *context, const std::string &name, bool error,
+        const tgdb_varobj &varobj)
+{
+    if_variables_created(name, error, varobj);
+}
+
+static void var_children(void *context, const std::string &name, bool error,
+        const std::list<tgdb_varobj> &children)
+{
+    if_variables_children(name, error, children);
+}
+
+static void var_changes(void *context, bool error,
+        const std::list<tgdb_varobj_change> &changes)
+{
+    if_variables_changes(error, changes);
+}
+
+static void register_names(void *context, bool error,
+        const std::list<tgdb_register> &registers)
+{
+    if_registers_names(error, registers);
+}
+
+static void changed_registers(void *context, bool error,
+        const std::list<int> &numbers)
+{
+    if_registers_changed(error, numbers);
+}
+
+static void register_values(void *context, bool error,
+        const std::list<tgdb_register> &registers)
+{
+    if_registers_values(error, registers);
+}
+
+static void memory(void *context, const std::string &addr, uint64_t start,
+        int count, bool error, const std::list<tgdb_memory_block> &blocks)
+{
+    if_memory_read(addr, start, count, error, blocks);
+}
+
+static void threads_changed(void *context)
+{
+    if_threads_changed();
+}
+
+static void thread_info(void *context, int id, bool error,
+        const tgdb_thread_info &info)
+{
+    if_threads_info(id, error, info);
+}
+
 /* gdb_input: Receives data from tgdb:
  *
  *  Returns:  -1 on error, 0 on success
@@ -785,111 +1047,243 @@ static int cgdb_handle_signal_in_main_loop(int fd)
     return 0;
 }
 
+/* The event loop main_loop runs */
+static struct event_loop *loop;
+
+/* Milliseconds gdb output may wait to be drawn while more is arriving */
+#define CGDB_DRAW_DEADLINE_MS 16
+
+/* The timer that draws the gdb output by its deadline, or 0 if not set */
+static int draw_timer = 0;
+
+/* Milliseconds to wait before writing to gdb again when it isn't reading */
+#define CGDB_WRITE_RETRY_MS 10
+
+/* The timer that writes to gdb again, or 0 if not set */
+static int write_timer = 0;
+
+/* Milliseconds between updates of gdb's startup progress */
+#define CGDB_STARTUP_TICK_MS 250
+
+/* The timer that shows gdb's startup progress, or 0 once gdb started */
+static int startup_timer = 0;
+
+/* When gdb was started, and how many times the progress was shown since */
+static time_t startup_time;
+static int startup_ticks = 0;
+
+static int main_loop_write_retry(void *context);
+
+/* Write what this pass through the loop sent to gdb */
+static int main_loop_flush(void)
+{
+    if (tgdb_flush(tgdb) == -1)
+        return -1;
+
+    /* gdb didn't take all of it, try again without blocking the user */
+    if (tgdb_has_pending_output(tgdb) && !write_timer)
+        write_timer = event_loop_add_timer(loop, CGDB_WRITE_RETRY_MS,
+                main_loop_write_retry, NULL);
+
+    return 0;
+}
+
+static int main_loop_write_retry(void *context)
+{
+    write_timer = 0;
+
+    return main_loop_flush();
+}
+
+static int main_loop_draw_deadline(void *context)
+{
+    draw_timer = 0;
+    if_print_flush();
+
+    return 0;
+}
+
+/* Show that gdb is still loading the program in the status bar, the user
+ * can use cgdb and queue up commands in the meantime */
+static int main_loop_startup_tick(void *context)
+{
+    static const char spinner[] = "|/-\\";
+    char status[64];
+
+    snprintf(status, sizeof(status), "Starting gdb %c %lds",
+            spinner[startup_ticks++ % 4], (long)(time(NULL) - startup_time));
+    if_startup_status(status);
+
+    startup_timer = event_loop_add_timer(loop, CGDB_STARTUP_TICK_MS,
+            main_loop_startup_tick, NULL);
+
+    return 0;
+}
+
+static void gdb_started(void *context)
+{
+    if (startup_timer) {
+        event_loop_remove_timer(loop, startup_timer);
+        startup_timer = 0;
+    }
+
+    /* Back to showing the current file */
+    if_startup_status(NULL);
+}
+
+static int main_loop_signal(void *context, int fd)
+{
+    /* A signal occurred (besides SIGWINCH) */
+    return cgdb_handle_signal_in_main_loop(fd);
+}
+
+static int main_loop_resize(void *context, int fd)
+{
+    /* A resize signal occurred */
+    return cgdb_resize_term(fd);
+}
+
+static int main_loop_stdin(void *context, int fd)
+{
+    int val = user_input_loop();
+
+    /* The below condition happens on cygwin when user types ctrl-z
+     * select returns (when it shouldn't) with the value of 1. the
+     * user input loop gets called, the kui gets called and does a
+     * non blocking read which returns EAGAIN. The kui then passes
+     * the -1 up the stack with out making any more system calls. */
+    if (val == -1 && errno == EAGAIN)
+        return 0;
+
+    return val;
+}
+
+static int main_loop_gdb(void *context, int fd)
+{
+    if (gdb_input(fd) == -1)
+        return -1;
+
+    /* While gdb keeps sending output, draw it at least this often */
+    if (if_print_pending() && !draw_timer)
+        draw_timer = event_loop_add_timer(loop, CGDB_DRAW_DEADLINE_MS,
+                main_loop_draw_deadline, NULL);
+
+    return 0;
+}
+
+static int main_loop_watch(void *context, int fd)
+{
+    /* A source file changed on disk */
+    source_watch_read(if_get_sview());
+
+    return 0;
+}
+
+static int main_loop_idle(void *context)
+{
+    /* Commands sent before the loop started are written here */
+    if (main_loop_flush() == -1)
+        return -1;
+
+    /* gdb has gone quiet, draw what it sent right away */
+    if (draw_timer) {
+        event_loop_remove_timer(loop, draw_timer);
+        draw_timer = 0;
+    }
+    if_print_flush();
+
+    /* Write out the logs before waiting, the screen is up to date */
+    clog_flush_all();
+
+    return 0;
+}
+
 static int main_loop(void)
 {
-    fd_set rset;
-    int max;
+    int watch_fd = if_get_sview()->watch_fd;
 
     /* Main (infinite) loop:
      *   Sits and waits for input on either stdin (user input) or the
      *   GDB file descriptor.  When input is received, wrapper functions
      *   are called to process the input, and handle it appropriately.
      *   This will result in calls to the curses interface, typically. */
+    loop = event_loop_create();
+    if (!loop)
+        return -1;
 
-    for (;;) {
-        max = (gdb_console_fd > STDIN_FILENO) ? gdb_console_fd : STDIN_FILENO;
-        max = (max > resize_pipe[0]) ? max : resize_pipe[0];
-        max = (max > signal_pipe[0]) ? max : signal_pipe[0];
-        max = (max > gdb_mi_fd) ? max :gdb_mi_fd;
-
-        /* Reset the fd_set, and watch for input from GDB or stdin */
-        FD_ZERO(&rset);
-        FD_SET(STDIN_FILENO, &rset);
-        FD_SET(gdb_console_fd, &rset);
-        FD_SET(resize_pipe[0], &rset);
-        FD_SET(signal_pipe[0], &rset);
-        FD_SET(gdb_mi_fd, &rset);
-
-        /* Wait for input */
-        if (select(max + 1, &rset, NULL, NULL, NULL) == -1) {
-            if (errno == EINTR)
-                continue;
-            else {
-                clog_error(CLOG_CGDB, "select failed: %s", strerror(errno));
-                return -1;
-            }
-        }
+    /* Signals and the user's keys are handled before gdb's output, so a
+     * flood of output is read a piece at a time in between keystrokes.
+     *
+     * The mi output stream from gdb is handled before the console output.
+     *
+     * At one point, this was processed after the gdb console output.
+     * I suspect the order should not matter, however it does in the
+     * case described below.
+     *
+     * I ran across this issue,
+     *   https://github.com/cgdb/cgdb/issues/352
+     * where the target output wasn't being displayed by cgdb.
+     * cgdb was ignoring the target output. Once fixed, the target
+     * output and the gdb prompt were intermixed somewhat randomly.
+     *
+     * For instance, when running the command 'monitor help', 
+     * gdb returns two things,
+     *   - the gdb prompt on the console output
+     *   - the target output on the mi output
+     *
+     * If cgdb processes all the mi output first, the target output
+     * appears to show up before the gdb prompt. I fully expect to
+     * find a situation where the console output needs to be handled
+     * first one day. I've left this documentation to aid in the thought
+     * process when that day approaches.
+     */
+    if (event_loop_add_fd(loop, signal_pipe[0], EVENT_LOOP_PRIORITY_HIGH,
+                main_loop_signal, NULL) == -1 ||
+        event_loop_add_fd(loop, resize_pipe[0], EVENT_LOOP_PRIORITY_HIGH,
+                main_loop_resize, NULL) == -1 ||
+        event_loop_add_fd(loop, STDIN_FILENO, EVENT_LOOP_PRIORITY_HIGH,
+                main_loop_stdin, NULL) == -1 ||
+        event_loop_add_fd(loop, gdb_mi_fd, EVENT_LOOP_PRIORITY_DEFAULT,
+                main_loop_gdb, NULL) == -1 ||
+        event_loop_add_fd(loop, gdb_console_fd, EVENT_LOOP_PRIORITY_LOW,
+                main_loop_gdb, NULL) == -1)
+        return -1;
 
-        /* A signal occurred (besides SIGWINCH) */
-        if (FD_ISSET(signal_pipe[0], &rset))
-            if (cgdb_handle_signal_in_main_loop(signal_pipe[0]) == -1)
-                return -1;
+    if (watch_fd != -1 && event_loop_add_fd(loop, watch_fd,
+                EVENT_LOOP_PRIORITY_LOW, main_loop_watch, NULL) == -1)
+        return -1;
 
-        /* A resize signal occurred */
-        if (FD_ISSET(resize_pipe[0], &rset))
-            if (cgdb_resize_term(resize_pipe[0]) == -1)
-                return -1;
+    event_loop_add_idle(loop, main_loop_idle, NULL);
 
-        /* Input received:  Handle it */
-        if (FD_ISSET(STDIN_FILENO, &rset)) {
-            int val = user_input_loop();
-
-            /* The below condition happens on cygwin when user types ctrl-z
-             * select returns (when it shouldn't) with the value of 1. the
-             * user input loop gets called, the kui gets called and does a
-             * non blocking read which returns EAGAIN. The kui then passes
-             * the -1 up the stack with out making any more system calls. */
-            if (val == -1 && errno == EAGAIN)
-                continue;
-            else if (val == -1)
-                return -1;
-        }
+    /* gdb loads the program in the background, until its first prompt */
+    startup_time = time(NULL);
+    main_loop_startup_tick(NULL);
 
-        /* This processes the mi output stream from gdb.
-         * 
-         * At one point, this was processed after the gdb console output.
-         * I suspect the order should not matter, however it does in the
-         * case described below.
-         *
-         * I ran across this issue,
-         *   https://github.com/cgdb/cgdb/issues/352
-         * where the target output wasn't being displayed by cgdb.
-         * cgdb was ignoring the target output. Once fixed, the target
-         * output and the gdb prompt were intermixed somewhat randomly.
-         *
-         * For instance, when running the command 'monitor help', 
-         * gdb returns two things,
-         *   - the gdb prompt on the console output
-         *   - the target output on the mi output
+    /* gdb output is drawn by the idle callback or the deadline timer */
+    if_set_print_deferred(1);
+
+    for (;;) {
+        if (event_loop_run_once(loop) == -1)
+            return -1;
+
+        /* When the file dialog is opened, the user input is blocked, 
+         * until GDB returns all the files that should be displayed,
+         * and the file dialog can open, and be prepared to receive 
+         * input. So, if we are in the file dialog, and are no longer
+         * waiting for the gdb command, then read the input.
          *
-         * If cgdb processes all the mi output first, the target output
-         * appears to show up before the gdb prompt. I fully expect to
-         * find a situation where the console output needs to be handled
-         * first one day. I've left this documentation to aid in the thought
-         * process when that day approaches.
+         * The kui reads all of the available input at once, so the keys
+         * typed after the blocking key are already buffered. Nothing is
+         * left on stdin to wake up the event loop.
          */
-        if (FD_ISSET(gdb_mi_fd, &rset)) {
-            if (gdb_input(gdb_mi_fd) == -1) {
+        if (kui_input_acceptable && kui_ctx->cangetkey()) {
+            if (user_input_loop() == -1)
                 return -1;
-            }
         }
 
-        /* This processes the console output stream from gdb.  */
-        if (FD_ISSET(gdb_console_fd, &rset)) {
-            if (gdb_input(gdb_console_fd) == -1) {
-                return -1;
-            }
-
-            /* When the file dialog is opened, the user input is blocked, 
-             * until GDB returns all the files that should be displayed,
-             * and the file dialog can open, and be prepared to receive 
-             * input. So, if we are in the file dialog, and are no longer
-             * waiting for the gdb command, then read the input.
-             */
-            if (kui_ctx->cangetkey()) {
-                user_input_loop();
-            }
-        }
+        /* The keys and commands for gdb are written together */
+        if (main_loop_flush() == -1)
+            return -1;
 
     }
     return 0;
@@ -913,6 +1307,7 @@ void cgdb_cleanup_and_exit(int val)
      * started, is the reverse order in which they should be shutdown 
      */
 
+    set_bracketed_paste(false);
     swin_endwin();
 
     /* Shut down interface */
@@ -1082,6 +1477,12 @@ static void cgdb_start_logging()
        by default. */
     clog_set_level(CLOG_CGDB_ID, CLOG_DEBUG);
     clog_set_fmt(CLOG_CGDB_ID, CGDB_CLOG_FORMAT);
+
+    /* Keep the log writes off the path between input and the screen
+     * update. The logs are written out when the main loop goes idle. */
+    clog_set_buffered(CLOG_CGDB_ID, 1);
+    clog_set_buffered(CLOG_GDBIO_ID, 1);
+    clog_set_buffered(CLOG_GDBMIIO_ID, 1);
 }
 
 int main(int argc, char *argv[])
@@ -1119,6 +1520,12 @@ int main(int argc, char *argv[])
         exit(-1);
     }
 
+    if (record_path && tgdb_record_start(tgdb, record_path) == -1) {
+        fprintf(stderr, "%s:%d Unable to record to %s\n",
+                __FILE__, __LINE__, record_path);
+        exit(-1);
+    }
+
     /* From here on, the logger is initialized */
     if (rline_initialize() == -1) {
         clog_error(CLOG_CGDB, "Unable to init readline");
@@ -1140,6 +1547,8 @@ int main(int argc, char *argv[])
         clog_error(CLOG_CGDB, "Unable to start curses");
     }
 
+    set_bracketed_paste(true);
+
     /* Initialize the highlighting groups */
     hl_groups_instance = hl_groups_initialize();
     if (!hl_groups_instance)
@@ -0,0 +1,350 @@
+/* cgdb_bench: Measures how long cgdb takes to draw its windows.
+ *
+ * Usage: cgdb_bench [-n frames] [-r rows] [-c cols] [-l lines] [-f files]
+ *
+ * The windows are drawn with the headless sys_win backend, so no terminal
+ * is needed and the numbers are repeatable. For each scenario a generated
+ * source file, gdb output or file list is loaded, and a frame is drawn
+ * after each scripted key or chunk of output. The CPU time, the bytes a
+ * terminal would have been sent and the allocations are reported per
+ * frame.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#if HAVE_STDIO_H
+#include <stdio.h>
+#endif /* HAVE_STDIO_H */
+
+#if HAVE_STDLIB_H
+#include <stdlib.h>
+#endif /* HAVE_STDLIB_H */
+
+#if HAVE_STRING_H
+#include <string.h>
+#endif /* HAVE_STRING_H */
+
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif /* HAVE_UNISTD_H */
+
+#if HAVE_TIME_H
+#include <time.h>
+#endif /* HAVE_TIME_H */
+
+#include <memory>
+#include <string>
+
+#include "sys_util.h"
+#include "sys_win.h"
+#include "sys_win_headless.h"
+#include "cgdb.h"
+#include "cgdbrc.h"
+#include "highlight_groups.h"
+#include "sources.h"
+#include "scroller.h"
+#include "filedlg.h"
+#include "kui_cgdb_key.h"
+#include "kui_map_set.h"
+#include "kui_manager.h"
+#include "cgdb_clog.h"
+
+/* The parts of cgdb.cpp the windows use */
+struct tgdb *tgdb;
+std::string cgdb_home_dir;
+std::string cgdb_log_dir;
+std::unique_ptr<kui_manager> kui_ctx;
+std::shared_ptr<kui_map_set> kui_map;
+std::shared_ptr<kui_map_set> kui_imap;
+int kui_input_acceptable = 1;
+int resize_pipe[2] = { -1, -1 };
+int signal_pipe[2] = { -1, -1 };
+
+void cgdb_cleanup_and_exit(int val)
+{
+    swin_endwin();
+    exit(val);
+}
+
+int run_shell_command(const char *command)
+{
+    return -1;
+}
+
+/* Count every allocation, including the ones made by the C++ library. */
+#ifdef __GLIBC__
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t nmemb, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+static size_t allocations;
+
+void *malloc(size_t size) noexcept
+{
+    allocations++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size) noexcept
+{
+    allocations++;
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size) noexcept
+{
+    allocations++;
+    return __libc_realloc(ptr, size);
+}
+}
+#define ALLOCATIONS() allocations
+#else
+#define ALLOCATIONS() ((size_t)0)
+#endif
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* What was measured while drawing the frames of a scenario */
+struct bench_stats {
+    const char *name;
+    int frames;
+    double start, worst;
+    size_t bytes, allocs;
+};
+
+static void bench_start(struct bench_stats *stats, const char *name)
+{
+    stats->name = name;
+    stats->frames = 0;
+    stats->worst = 0;
+    stats->bytes = swin_headless_bytes_emitted();
+    stats->allocs = ALLOCATIONS();
+    stats->start = now();
+}
+
+/* Call after each frame has been drawn, with the time it started */
+static void bench_frame(struct bench_stats *stats, double frame_start)
+{
+    double elapsed = now() - frame_start;
+
+    if (elapsed > stats->worst)
+        stats->worst = elapsed;
+    stats->frames++;
+}
+
+static void bench_report(struct bench_stats *stats)
+{
+    double elapsed = now() - stats->start;
+    int frames = stats->frames > 0 ? stats->frames : 1;
+
+    printf("%-14s %6d frames %9.1f us/frame %9.1f us worst "
+           "%9.1f bytes/frame %8.1f allocs/frame\n",
+            stats->name, stats->frames,
+            elapsed * 1e6 / frames, stats->worst * 1e6,
+            (double)(swin_headless_bytes_emitted() - stats->bytes) / frames,
+            (double)(ALLOCATIONS() - stats->allocs) / frames);
+}
+
+/* Write a C file of the given number of lines, returns 0 on success */
+static int write_source(const char *path, int lines)
+{
+    static const char *const body[] = {
+        "    for (i = 0; i < count; ++i) {\n",
+        "        /* Add up the values that are in range */\n",
+        "        if (values[i] > min && values[i] < max)\n",
+        "            total += values[i] * scale;\n",
+        "    }\n",
+        "    printf(\"total %d of %d\\n\", total, count);\n",
+    };
+    FILE *fp = fopen(path, "w");
+    int line = 0;
+
+    if (!fp)
+        return -1;
+
+    while (line < lines) {
+        fprintf(fp, "static int function_%d(int *values, int count)\n{\n",
+                line);
+        fprintf(fp, "    int i, total = 0;\n");
+        line += 3;
+
+        for (size_t i = 0; i < sizeof(body) / sizeof(*body); ++i, ++line)
+            fputs(body[i], fp);
+
+        fprintf(fp, "    return total;\n}\n\n");
+        line += 3;
+    }
+
+    fclose(fp);
+    return 0;
+}
+
+/* Scroll through a source file a line at a time, then a page at a time */
+static void bench_source(const char *path, int frames, int rows, int cols)
+{
+    struct bench_stats stats;
+    SWINDOW *win = swin_newwin(rows, cols, 0, 0);
+    struct sviewer *sview = source_new(win);
+    int i;
+
+    source_set_exec_line(sview, path, 1, 1);
+    source_display(sview, 1, WIN_NO_REFRESH, 0);
+    swin_doupdate();
+
+    bench_start(&stats, "source-line");
+    for (i = 0; i < frames; ++i) {
+        double frame_start = now();
+        source_vscroll(sview, (i / 100) % 2 ? -1 : 1);
+        source_display(sview, 1, WIN_NO_REFRESH, 0);
+        swin_doupdate();
+        bench_frame(&stats, frame_start);
+    }
+    bench_report(&stats);
+
+    bench_start(&stats, "source-page");
+    for (i = 0; i < frames; ++i) {
+        double frame_start = now();
+        source_vscroll(sview, (i / 20) % 2 ? -rows : rows);
+        source_display(sview, 1, WIN_NO_REFRESH, 0);
+        swin_doupdate();
+        bench_frame(&stats, frame_start);
+    }
+    bench_report(&stats);
+
+    source_free(sview);
+}
+
+/* Draw the gdb window after each chunk of output */
+static void bench_scroller(int frames, int rows, int cols)
+{
+    static const char *const output[] = {
+        "Breakpoint 1, main (argc=1, argv=0x7fffffffe4a8) at main.c:12\r\n"
+        "12\t    int result = compute(argc, argv);\r\n(gdb) ",
+        "next\r\n13\t    printf(\"%d\\n\", result);\r\n(gdb) ",
+        "\033[1;32m#0\033[m  \033[33mcompute\033[m (n=42) at "
+        "\033[32mcompute.c\033[m:87\r\n"
+        "#1  0x0000555555555189 in main () at main.c:12\r\n(gdb) ",
+        "$1 = {x = 10, y = 20, name = 0x555555556004 \"origin\"}\r\n(gdb) ",
+    };
+    struct bench_stats stats;
+    struct scroller *scr = scr_new(swin_newwin(rows, cols, 0, 0));
+    int i;
+
+    bench_start(&stats, "scroller");
+    for (i = 0; i < frames; ++i) {
+        double frame_start = now();
+        scr_add(scr, output[i % (sizeof(output) / sizeof(*output))]);
+        scr_refresh(scr, 1, WIN_NO_REFRESH);
+        swin_doupdate();
+        bench_frame(&stats, frame_start);
+    }
+    bench_report(&stats);
+
+    scr_free(scr);
+}
+
+/* Move through a long file dialog a line at a time */
+static void bench_filedlg(int frames, int files, int rows, int cols)
+{
+    struct bench_stats stats;
+    struct filedlg *fd = filedlg_new(0, 0, rows, cols);
+    char file[MAX_LINE];
+    int i;
+
+    for (i = 0; i < files; ++i) {
+        char path[128];
+        snprintf(path, sizeof(path), "/src/project/module%d/file%d.c",
+                i % 97, i);
+        filedlg_add_file_choice(fd, path);
+    }
+    filedlg_display(fd);
+
+    bench_start(&stats, "filedlg");
+    for (i = 0; i < frames; ++i) {
+        double frame_start = now();
+        filedlg_recv_char(fd, (i / 100) % 2 ? 'k' : 'j', file, 0);
+        filedlg_display(fd);
+        bench_frame(&stats, frame_start);
+    }
+    bench_report(&stats);
+
+    filedlg_free(fd);
+}
+
+int main(int argc, char *argv[])
+{
+    char dir[] = "/tmp/cgdb_benchXXXXXX";
+    std::string path;
+    int frames = 1000;
+    int rows = 50;
+    int cols = 200;
+    int lines = 20000;
+    int files = 20000;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+            rows = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            cols = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+            lines = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+            files = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Usage: cgdb_bench [-n frames] [-r rows] "
+                    "[-c cols] [-l lines] [-f files]\n");
+            return 1;
+        }
+    }
+
+    /* cgdb logs as it draws, the messages are thrown away */
+    clog_init_path(CLOG_CGDB_ID, "/dev/null");
+    clog_init_path(CLOG_GDBIO_ID, "/dev/null");
+    clog_init_path(CLOG_GDBMIIO_ID, "/dev/null");
+
+    if (!mkdtemp(dir)) {
+        fprintf(stderr, "cgdb_bench: can't create %s\n", dir);
+        return 1;
+    }
+    path = std::string(dir) + "/bench.c";
+    if (write_source(path.c_str(), lines) == -1) {
+        fprintf(stderr, "cgdb_bench: can't write %s\n", path.c_str());
+        rmdir(dir);
+        return 1;
+    }
+
+    cgdbrc_init();
+
+    swin_headless_set_size(rows, cols);
+    swin_start();
+
+    hl_groups_instance = hl_groups_initialize();
+    if (!hl_groups_instance) {
+        fprintf(stderr, "cgdb_bench: can't set up the highlight groups\n");
+        return 1;
+    }
+
+    bench_source(path.c_str(), frames, rows, cols);
+    bench_scroller(frames, rows, cols);
+    bench_filedlg(frames, files, rows, cols);
+
+    hl_groups_shutdown(hl_groups_instance);
+    swin_endwin();
+
+    unlink(path.c_str());
+    rmdir(dir);
+
+    return 0;
+}
@@ -16,6 +16,10 @@
 #include <stdlib.h>
 #endif /* HAVE_STDLIB_H */
 
+#if HAVE_CTYPE_H
+#include <ctype.h>
+#endif /* HAVE_CTYPE_H */
+
 #include "cgdbrc.h"
 #include "command_lexer.h"
 #include "tgdb.h"
@@ -67,18 +71,27 @@ struct cgdbrc_attach_item {
 
 static std::list<struct cgdbrc_attach_item> cgdbrc_attach_list;
 
+/* The command being parsed, for commands that take the rest of the line */
+static const char *command_line = "";
+
 static int command_do_tgdbcommand(enum tgdb_command_type param);
 
 static int command_focus_cgdb(int param);
 static int command_focus_gdb(int param);
 
+static int command_do_backtrace(int param);
 static int command_do_bang(int param);
 static int command_do_focus(int param);
 static int command_do_help(int param);
+static int command_do_locals(int param);
 static int command_do_logo(int param);
+static int command_do_memory(int param);
 static int command_do_noh(int param);
 static int command_do_quit(int param);
+static int command_do_registers(int param);
 static int command_do_shell(int param);
+static int command_do_threads(int param);
+static int command_do_watch(int param);
 static int command_source_reload(int param);
 
 static int command_parse_syntax(int param);
@@ -96,12 +109,16 @@ typedef struct COMMANDS {
 } COMMANDS;
 
 COMMANDS commands[] = {
+    /* backtrace    */ {"backtrace", (action_t)command_do_backtrace, 0},
+    /* backtrace    */ {"bt", (action_t)command_do_backtrace, 0},
     /* bang         */ {"bang", (action_t)command_do_bang, 0},
     /* edit         */ {"edit", (action_t)command_source_reload, 0},
     /* edit         */ {"e", (action_t)command_source_reload, 0},
     /* focus        */ {"focus", (action_t)command_do_focus, 0},
     /* help         */ {"help", (action_t)command_do_help, 0},
+    /* locals       */ {"locals", (action_t)command_do_locals, 0},
     /* logo         */ {"logo", (action_t)command_do_logo, 0},
+    /* memory       */ {"memory", (action_t)command_do_memory, 0},
     /* highlight    */ {"highlight", (action_t)command_parse_highlight, 0},
     /* highlight    */ {"hi", (action_t)command_parse_highlight, 0},
     /* imap         */ {"imap", (action_t)command_parse_map, 0},
@@ -112,12 +129,15 @@ COMMANDS commands[] = {
     /* map          */ {"map", (action_t)command_parse_map, 0},
     /* noh          */ {"noh", (action_t)command_do_noh, 0},
     /* quit         */ {"quit", (action_t)command_do_quit, 0},
+    /* registers    */ {"registers", (action_t)command_do_registers, 0},
     /* quit         */ {"q", (action_t)command_do_quit, 0},
     /* shell        */ {"shell", (action_t)command_do_shell, 0},
     /* shell        */ {"sh", (action_t)command_do_shell, 0},
     /* syntax       */ {"syntax", (action_t)command_parse_syntax, 0},
+    /* threads      */ {"threads", (action_t)command_do_threads, 0},
     /* unmap        */ {"unmap", (action_t)command_parse_unmap, 0},
     /* unmap        */ {"unm", (action_t)command_parse_unmap, 0},
+    /* watch        */ {"watch", (action_t)command_do_watch, 0},
     /* continue     */ {"continue", (action_t)command_do_tgdbcommand, TGDB_CONTINUE},
     /* continue     */ {"c", (action_t)command_do_tgdbcommand, TGDB_CONTINUE},
     /* down         */ {"down", (action_t)command_do_tgdbcommand, TGDB_DOWN},
@@ -691,6 +711,12 @@ int command_focus_gdb(int param)
     return 0;
 }
 
+int command_do_backtrace(int param)
+{
+    if_show_backtrace();
+    return 0;
+}
+
 int command_do_bang(int param)
 {
     return 0;
@@ -727,6 +753,12 @@ int command_do_help(int param)
     return 0;
 }
 
+int command_do_locals(int param)
+{
+    if_show_variables();
+    return 0;
+}
+
 int command_do_logo(int param)
 {
     if_display_logo(1);
@@ -739,6 +771,18 @@ int command_do_noh(int param)
     return 0;
 }
 
+int command_do_registers(int param)
+{
+    if_show_registers();
+    return 0;
+}
+
+int command_do_threads(int param)
+{
+    if_show_threads();
+    return 0;
+}
+
 int command_do_quit(int param)
 {
     /* FIXME: Test to see if debugged program is still running */
@@ -751,6 +795,42 @@ int command_do_shell(int param)
     return run_shell_command(NULL);
 }
 
+/* The rest of the command line after the command name, for commands that
+ * take an expression, which may have spaces in it */
+static std::string command_rest_of_line(void)
+{
+    const char *rest = command_line + strspn(command_line, " \t");
+    std::string str;
+
+    rest += strcspn(rest, " \t");
+    rest += strspn(rest, " \t");
+
+    str = rest;
+    while (!str.empty() && isspace((unsigned char)*str.rbegin()))
+        str.erase(str.size() - 1);
+
+    return str;
+}
+
+int command_do_watch(int param)
+{
+    std::string watch = command_rest_of_line();
+
+    if (watch.empty())
+        return 1;
+
+    if_add_watch(watch.c_str());
+    return 0;
+}
+
+int command_do_memory(int param)
+{
+    std::string addr = command_rest_of_line();
+
+    if_show_memory(addr.empty() ? NULL : addr.c_str());
+    return 0;
+}
+
 int command_source_reload(int param)
 {
     struct sviewer *sview = if_get_sview();
@@ -1042,6 +1122,8 @@ int command_parse_string(const char *buffer)
     int rv = 1;
     YY_BUFFER_STATE state = yy_scan_string((char *) buffer);
 
+    command_line = buffer;
+
     switch (yylex()) {
         case SET:
             /* get the next token */
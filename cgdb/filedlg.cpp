@@ -10,7 +10,14 @@
 #include <string.h>
 #endif /* HAVE_STRING_H */
 
+#include <stdint.h>
+
+#include <algorithm>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 #include "fs_util.h"
 
@@ -26,8 +33,15 @@
 #include "kui_manager.h"
 #include "highlight_groups.h"
 
+struct file_choice {
+    char *path;                 /* The file name to display */
+    int exists;                 /* 1 if the file exists, 0 if it's missing,
+                                   -1 if it hasn't been checked yet */
+};
+
 struct file_buffer {
-    char **files;               /* Array containing file */
+    struct file_choice *files;  /* Array containing file */
+    int sorted;                 /* Non-zero if files is in display order */
     int max_width;              /* Width of longest line in file */
 
     int sel_line;               /* Current line selected in file dialog */
@@ -35,12 +49,34 @@ struct file_buffer {
     int sel_rline;              /* Current line used by regex */
 };
 
+/* The most matches the fuzzy finder ranks and lets the user pick from */
+#define FUZZY_MAX_HITS 1000
+
+/* Below this many files the fuzzy finder scores them on a single thread */
+#define FUZZY_THREAD_MIN 16384
+
+/* The most threads the fuzzy finder splits the files across */
+#define FUZZY_MAX_THREADS 8
+
+struct fuzzy_hit {
+    int file;                   /* Index of the file in buf->files */
+    int score;                  /* How well the file matched, higher is better */
+    int length;                 /* Length of the file name */
+};
+
 struct filedlg {
     struct file_buffer *buf;    /* All of the widget's data ( files ) */
     struct hl_regex_info *last_hlregex;
     struct hl_regex_info *hlregex;
     SWINDOW *win;               /* Curses window */
     std::string G_line_number;  /* Line number user wants to 'G' to */
+    std::unordered_set<std::string> file_set; /* Files already added */
+
+    std::vector<uint64_t> fuzzy_masks; /* Characters in each file, see
+                                          fuzzy_char_bit */
+    std::vector<int> fuzzy_matches; /* Files matching the fuzzy pattern */
+    std::vector<struct fuzzy_hit> fuzzy_hits; /* Best matches, best first */
+    int fuzzy_sel;              /* The selected entry in fuzzy_hits */
 };
 
 static char regex_line[MAX_LINE];   /* The regex the user enters */
@@ -48,6 +84,10 @@ static int regex_line_pos;      /* The index into the current regex */
 static int regex_search;        /* Currently searching text ? */
 static int regex_direction;     /* Direction to search */
 
+static char fuzzy_line[MAX_LINE];   /* The fuzzy pattern the user enters */
+static int fuzzy_line_pos;      /* The index into the current pattern */
+static int fuzzy_search;        /* Currently finding a file ? */
+
 /* print_in_middle: Prints the message 'string' centered at line in win 
  * ----------------
  *
@@ -92,7 +132,9 @@ struct filedlg *filedlg_new(int pos_r, int pos_c, int height, int width)
 
     fd->last_hlregex = NULL;
     fd->hlregex = NULL;
+    fd->fuzzy_sel = 0;
     fd->buf->files = NULL;
+    fd->buf->sorted = 1;
     fd->buf->max_width = 0;
     fd->buf->sel_line = 0;
     fd->buf->sel_col = 0;
@@ -122,71 +164,87 @@ void filedlg_free(struct filedlg *fdlg)
 
 int filedlg_add_file_choice(struct filedlg *fd, const char *file_choice)
 {
+    struct file_choice choice;
     int length;
-    int index, i;
-    int equal = 1;              /* Not set to 0, because 0 *is* equal */
 
     if (file_choice == NULL || *file_choice == '\0')
         return -1;
 
-    /* Make sure file exists. If temp files are used to create an
-     * executable, and the temp files are deleted, they pollute the
-     * file open dialog with files you can't actually open.
-     *
-     * The downside to not showing them all is that a user might
-     * not understand why certain files aren't showing up. O well.
-     */
-    if (file_choice[0] != '*') {
-        if (fs_verify_file_exists(file_choice) == 0)
-            return -4;
-    }
+    /* Don't add duplicate entry's ... gdb outputs duplicates */
+    if (!fd->file_set.insert(file_choice).second)
+        return -3;
 
-    /* find index to insert by comparing:
-     * Absolute paths go to the end
-     * Relative paths go before the absolute paths 
-     */
-    for (i = 0; i < sbcount(fd->buf->files); i++) {
-        /* Don't add duplicate entry's ... gdb outputs duplicates */
-        if ((equal = strcmp(fd->buf->files[i], file_choice)) == 0)
-            return -3;
-        else if (equal < 0) {
-            /* Inserting filename, stop before relative path */
-            if ((file_choice[0] != '.' && file_choice[0] != '/')
-                    && fd->buf->files[i][0] == '.')
-                break;
+    /* Whether the file exists is checked when it is displayed. Programs
+     * can have tens of thousands of files, most of which the user never
+     * scrolls to, so there is no sense waiting on a stat for each one. */
+    choice.path = cgdb_strdup(file_choice);
+    choice.exists = (file_choice[0] == '*') ? 1 : -1;
+    sbpush(fd->buf->files, choice);
 
-            /* Inserting filename, stop before absolute path */
-            if (file_choice[0] != '/' && fd->buf->files[i][0] == '/')
-                break;
+    /* The files are sorted once, when the dialog is next used */
+    fd->buf->sorted = 0;
 
-        } else if (equal > 0) { /* Found ( file_choice is greater ) */
-            /* Inserting Absolute path, it goes to the end */
-            if (file_choice[0] == '/' && fd->buf->files[i][0] != '/')
-                continue;
+    if ((length = strlen(file_choice)) > fd->buf->max_width)
+        fd->buf->max_width = length;
 
-            /* Inserting relative path, continue until before absolute or relative path */
-            if (file_choice[0] == '.' && (fd->buf->files[i][0] != '.'
-                            && fd->buf->files[i][0] != '/'))
-                continue;
+    return 0;
+}
 
-            break;
-        }
-    }
+/* file_choice_group: The section of the file dialog a file is listed in.
+ * ------------------
+ *
+ * File names come first, then relative paths, then absolute paths.
+ */
+static int file_choice_group(const char *path)
+{
+    if (path[0] == '/')
+        return 2;
+    else if (path[0] == '.')
+        return 1;
 
-    index = i;
+    return 0;
+}
 
-    sbpush(fd->buf->files, NULL);
+static bool file_choice_less(const struct file_choice &a,
+        const struct file_choice &b)
+{
+    int group_a = file_choice_group(a.path);
+    int group_b = file_choice_group(b.path);
 
-    /* shift everything down and then insert into index */
-    for (i = sbcount(fd->buf->files) - 1; i > index; i--)
-        fd->buf->files[i] = fd->buf->files[i - 1];
+    if (group_a != group_b)
+        return group_a < group_b;
 
-    fd->buf->files[index] = cgdb_strdup(file_choice);
+    return strcmp(a.path, b.path) < 0;
+}
 
-    if ((length = strlen(file_choice)) > fd->buf->max_width)
-        fd->buf->max_width = length;
+/* filedlg_sort: Put the files added since the last sort in display order.
+ * -------------
+ */
+static void filedlg_sort(struct filedlg *fd)
+{
+    if (fd->buf->sorted)
+        return;
 
-    return 0;
+    std::sort(fd->buf->files, fd->buf->files + sbcount(fd->buf->files),
+            file_choice_less);
+    fd->buf->sorted = 1;
+}
+
+/* file_choice_exists: Check if a file in the dialog exists, once.
+ * -------------------
+ *
+ * If temp files are used to create an executable, and the temp files are
+ * deleted, they pollute the file open dialog with files you can't actually
+ * open. Those files are marked as missing when they are first displayed.
+ *
+ * Return Value: 1 if the file exists, 0 otherwise.
+ */
+static int file_choice_exists(struct file_choice *choice)
+{
+    if (choice->exists == -1)
+        choice->exists = fs_verify_file_exists(choice->path);
+
+    return choice->exists;
 }
 
 void filedlg_clear(struct filedlg *fd)
@@ -196,10 +254,17 @@ void filedlg_clear(struct filedlg *fd)
     fd->G_line_number.clear();
 
     for (i = 0; i < sbcount(fd->buf->files); i++)
-        free(fd->buf->files[i]);
+        free(fd->buf->files[i].path);
 
     sbfree(fd->buf->files);
     fd->buf->files = NULL;
+    fd->buf->sorted = 1;
+    fd->file_set.clear();
+
+    fd->fuzzy_masks.clear();
+    fd->fuzzy_matches.clear();
+    fd->fuzzy_hits.clear();
+    fd->fuzzy_sel = 0;
 
     fd->buf->max_width = 0;
     fd->buf->sel_line = 0;
@@ -299,7 +364,7 @@ static int filedlg_search_regex(struct filedlg *fd, const char *regex,
         for(;;) {
             int ret;
             int start, end;
-            char *file = fd->buf->files[line];
+            char *file = fd->buf->files[line].path;
 
             ret = hl_regex_search(&fd->hlregex, file, regex, icase, &start, &end);
             if (ret > 0) {
@@ -326,6 +391,428 @@ static int filedlg_search_regex(struct filedlg *fd, const char *regex,
     return 0;
 }
 
+/* Fuzzy finder scores, see fuzzy_match */
+enum {
+    FUZZY_SCORE_MATCH = 16,         /* Each character matched */
+    FUZZY_BONUS_CONSECUTIVE = 16,   /* Matched right after the last match */
+    FUZZY_BONUS_SLASH = 24,         /* Matched at the start of a directory */
+    FUZZY_BONUS_WORD = 16,          /* Matched at the start of a word */
+    FUZZY_BONUS_BASENAME = 8        /* Matched in the file's base name */
+};
+
+/* fuzzy_char_bit: The bit standing for a character in a fuzzy mask.
+ * ---------------
+ *
+ * Each file gets a mask of the characters it contains, so the files that
+ * can't possibly match a pattern are thrown out with a single AND rather
+ * than by walking the file name. Letters are folded to lower case, which
+ * keeps the masks valid whether or not the match ignores case, and the
+ * characters other than letters and digits share the remaining bits.
+ *
+ *  c: The character
+ *
+ * Return Value: The bit for c.
+ */
+static inline uint64_t fuzzy_char_bit(unsigned char c)
+{
+    if (c >= 'a' && c <= 'z')
+        return (uint64_t)1 << (c - 'a');
+    else if (c >= 'A' && c <= 'Z')
+        return (uint64_t)1 << (c - 'A');
+    else if (c >= '0' && c <= '9')
+        return (uint64_t)1 << (26 + c - '0');
+
+    return (uint64_t)1 << (36 + c % 28);
+}
+
+static uint64_t fuzzy_mask(const char *s)
+{
+    uint64_t mask = 0;
+
+    for (; *s; s++)
+        mask |= fuzzy_char_bit(*s);
+
+    return mask;
+}
+
+struct fuzzy_pattern {
+    char text[MAX_LINE];        /* The pattern, in lower case if icase is set */
+    int len;                    /* The length of text */
+    int icase;                  /* Non-zero to ignore the case of file names */
+    uint64_t mask;              /* The characters in text */
+};
+
+/* fuzzy_pattern_init: Prepare the pattern the user entered for matching.
+ * -------------------
+ *
+ * The pattern ignores case unless it has an upper case letter in it.
+ *
+ *  pattern: The pattern to initialize
+ *  line:    The pattern the user entered
+ */
+static void fuzzy_pattern_init(struct fuzzy_pattern *pattern, const char *line)
+{
+    int i;
+
+    pattern->icase = 1;
+    for (i = 0; line[i]; i++) {
+        if (line[i] >= 'A' && line[i] <= 'Z')
+            pattern->icase = 0;
+    }
+
+    for (i = 0; line[i] && i < MAX_LINE - 1; i++) {
+        pattern->text[i] = line[i];
+        if (pattern->icase && line[i] >= 'A' && line[i] <= 'Z')
+            pattern->text[i] += 'a' - 'A';
+    }
+    pattern->text[i] = '\0';
+    pattern->len = i;
+    pattern->mask = fuzzy_mask(pattern->text);
+}
+
+static inline int fuzzy_char_eq(char p, char c, int icase)
+{
+    if (icase && c >= 'A' && c <= 'Z')
+        c += 'a' - 'A';
+
+    return p == c;
+}
+
+static inline int fuzzy_word_start(const char *path, int i)
+{
+    char prev = path[i - 1];
+
+    return prev == '_' || prev == '-' || prev == '.' || prev == ' ' ||
+           (prev >= 'a' && prev <= 'z' && path[i] >= 'A' && path[i] <= 'Z');
+}
+
+/* fuzzy_match: Score how well a file matches a fuzzy pattern.
+ * ------------
+ *
+ * The pattern matches if its characters appear in order in the file name.
+ * The first match is found, then the pattern is matched backwards from its
+ * end to find the shortest run of the file name holding the pattern. Matches
+ * at the start of a directory or word, matches next to each other and
+ * matches in the base name score higher. Gaps within the run score lower.
+ *
+ *  path:      The file name
+ *  pattern:   The pattern to match
+ *  score:     How well the file matched, higher is better
+ *  positions: If not NULL, the indexes into path that matched
+ *
+ * Return Value: 1 if the file matches, 0 otherwise.
+ */
+static int fuzzy_match(const char *path, const struct fuzzy_pattern *pattern,
+        int *score, int *positions)
+{
+    int i, j;
+    int start, end;
+    int prev = -2;
+    int basename = 0;
+    int plen = pattern->len;
+    int icase = pattern->icase;
+    const char *text = pattern->text;
+    const char *slash;
+
+    for (i = 0, j = 0; path[i] && j < plen; i++) {
+        if (fuzzy_char_eq(text[j], path[i], icase))
+            j++;
+    }
+    if (j < plen)
+        return 0;
+
+    end = i;
+    for (i = end - 1, j = plen - 1; j >= 0; i--) {
+        if (fuzzy_char_eq(text[j], path[i], icase))
+            j--;
+    }
+    start = i + 1;
+    *score = 0;
+
+    slash = strrchr(path, '/');
+    if (slash)
+        basename = slash - path + 1;
+
+    for (i = start, j = 0; j < plen; i++) {
+        if (!fuzzy_char_eq(text[j], path[i], icase))
+            continue;
+
+        *score += FUZZY_SCORE_MATCH;
+        if (i == prev + 1)
+            *score += FUZZY_BONUS_CONSECUTIVE;
+
+        if (i == 0 || path[i - 1] == '/')
+            *score += FUZZY_BONUS_SLASH;
+        else if (fuzzy_word_start(path, i))
+            *score += FUZZY_BONUS_WORD;
+
+        if (i >= basename)
+            *score += FUZZY_BONUS_BASENAME;
+
+        if (positions)
+            positions[j] = i;
+        prev = i;
+        j++;
+    }
+
+    *score -= end - start - plen;
+    return 1;
+}
+
+static bool fuzzy_hit_better(const struct fuzzy_hit &a,
+        const struct fuzzy_hit &b)
+{
+    if (a.score != b.score)
+        return a.score > b.score;
+    else if (a.length != b.length)
+        return a.length < b.length;
+
+    return a.file < b.file;
+}
+
+/* fuzzy_scan: Score some of the files against a fuzzy pattern.
+ * -----------
+ *
+ * This only reads the file dialog, so many can run at once.
+ *
+ *  fd:      The file dialog
+ *  pattern: The pattern to match
+ *  files:   The indexes of the files to score
+ *  count:   The number of files
+ *  hits:    The files that matched are appended here, in order
+ */
+static void fuzzy_scan(const struct filedlg *fd,
+        const struct fuzzy_pattern *pattern, const int *files, int count,
+        std::vector<struct fuzzy_hit> *hits)
+{
+    int i;
+
+    for (i = 0; i < count; i++) {
+        struct fuzzy_hit hit;
+        const char *path;
+
+        hit.file = files[i];
+        if (pattern->mask & ~fd->fuzzy_masks[hit.file])
+            continue;
+
+        path = fd->buf->files[hit.file].path;
+        if (fuzzy_match(path, pattern, &hit.score, NULL)) {
+            hit.length = strlen(path);
+            hits->push_back(hit);
+        }
+    }
+}
+
+/* filedlg_fuzzy_find: Find and rank the files matching fuzzy_line.
+ * -------------------
+ *
+ * Large programs are split across threads. Only the best FUZZY_MAX_HITS
+ * matches are put in order, as that is all the user can pick from.
+ *
+ *  fd:     The file dialog
+ *  narrow: Non-zero if fuzzy_line only grew since the last call. Only the
+ *          files that matched then have to be looked at again.
+ */
+static void filedlg_fuzzy_find(struct filedlg *fd, int narrow)
+{
+    int i;
+    int count = sbcount(fd->buf->files);
+    int nfiles, nthreads, chunk;
+    const int *files;
+    struct fuzzy_pattern pattern;
+    std::vector<std::thread> threads;
+
+    /* The files don't move once sorted, until more are added */
+    filedlg_sort(fd);
+    if ((int)fd->fuzzy_masks.size() != count) {
+        fd->fuzzy_masks.resize(count);
+        for (i = 0; i < count; i++)
+            fd->fuzzy_masks[i] = fuzzy_mask(fd->buf->files[i].path);
+        narrow = 0;
+    }
+
+    if (!narrow) {
+        fd->fuzzy_matches.resize(count);
+        for (i = 0; i < count; i++)
+            fd->fuzzy_matches[i] = i;
+    }
+
+    fuzzy_pattern_init(&pattern, fuzzy_line);
+
+    files = fd->fuzzy_matches.data();
+    nfiles = fd->fuzzy_matches.size();
+    nthreads = 1;
+    if (nfiles >= FUZZY_THREAD_MIN) {
+        nthreads = std::min((int)std::thread::hardware_concurrency(),
+                FUZZY_MAX_THREADS);
+        nthreads = std::max(nthreads, 1);
+    }
+    chunk = (nfiles + nthreads - 1) / nthreads;
+
+    std::vector<std::vector<struct fuzzy_hit>> parts(nthreads);
+    for (i = 1; i < nthreads; i++) {
+        int begin = std::min(i * chunk, nfiles);
+        int n = std::min(chunk, nfiles - begin);
+
+        try {
+            threads.emplace_back(fuzzy_scan, fd, &pattern, files + begin, n,
+                    &parts[i]);
+        } catch (const std::system_error &) {
+            fuzzy_scan(fd, &pattern, files + begin, n, &parts[i]);
+        }
+    }
+    fuzzy_scan(fd, &pattern, files, std::min(chunk, nfiles), &parts[0]);
+
+    for (std::thread &thread : threads)
+        thread.join();
+
+    fd->fuzzy_matches.clear();
+    fd->fuzzy_hits.clear();
+    for (const std::vector<struct fuzzy_hit> &part : parts) {
+        for (const struct fuzzy_hit &hit : part)
+            fd->fuzzy_matches.push_back(hit.file);
+        fd->fuzzy_hits.insert(fd->fuzzy_hits.end(), part.begin(), part.end());
+    }
+
+    if (fd->fuzzy_hits.size() > FUZZY_MAX_HITS) {
+        std::partial_sort(fd->fuzzy_hits.begin(),
+                fd->fuzzy_hits.begin() + FUZZY_MAX_HITS,
+                fd->fuzzy_hits.end(), fuzzy_hit_better);
+        fd->fuzzy_hits.resize(FUZZY_MAX_HITS);
+    } else {
+        std::sort(fd->fuzzy_hits.begin(), fd->fuzzy_hits.end(),
+                fuzzy_hit_better);
+    }
+
+    fd->fuzzy_sel = 0;
+}
+
+/* filedlg_display_fuzzy: Display the fuzzy finder's best matches.
+ * ----------------------
+ *
+ * The matches are listed best first, a page at a time, with the characters
+ * that matched highlighted.
+ */
+static void filedlg_display_fuzzy(struct filedlg *fd)
+{
+    char fmt[16];
+    char matches[32];
+    int width, height;
+    int lwidth;
+    int hit;
+    int i, j;
+    int nhits = fd->fuzzy_hits.size();
+    int statusbar = hl_groups_get_attr(hl_groups_instance, HLG_STATUS_BAR);
+    int arrow_attr = hl_groups_get_attr(hl_groups_instance,
+            HLG_SELECTED_LINE_ARROW);
+    int positions[MAX_LINE];
+    struct fuzzy_pattern pattern;
+    static const char label[] = "Type to find a file or press ESC to cancel.";
+
+    height = swin_getmaxy(fd->win) - 2;
+    width = swin_getmaxx(fd->win);
+
+    fuzzy_pattern_init(&pattern, fuzzy_line);
+
+    lwidth = log10_uint(sbcount(fd->buf->files)) + 1;
+    snprintf(fmt, sizeof(fmt), "%%%dd", lwidth);
+
+    print_in_middle(fd->win, 0, width, label);
+
+    hit = (height > 0) ? fd->fuzzy_sel - fd->fuzzy_sel % height : 0;
+    for (i = 1; i < height + 1; i++, hit++) {
+        int x, y;
+        int score;
+        int file;
+        char *filename;
+        std::vector<hl_line_attr> file_attrs;
+        std::vector<hl_line_attr> attrs;
+
+        swin_wmove(fd->win, i, 0);
+
+        /* Past the last match, just finish drawing the vertical line */
+        if (hit >= nhits) {
+            for (j = 1; j < lwidth; j++)
+                swin_waddch(fd->win, ' ');
+            swin_waddch(fd->win, '~');
+
+            swin_wattron(fd->win, SWIN_A_BOLD);
+            swin_waddch(fd->win, SWIN_SYM_VLINE);
+            swin_wattroff(fd->win, SWIN_A_BOLD);
+
+            for (j = 2 + lwidth; j < width; j++)
+                swin_waddch(fd->win, ' ');
+            continue;
+        }
+
+        file = fd->fuzzy_hits[hit].file;
+        filename = fd->buf->files[file].path;
+
+        /* Dim the files that can't be opened */
+        if (!file_choice_exists(&fd->buf->files[file]))
+            file_attrs.push_back(hl_line_attr(0, SWIN_A_DIM));
+
+        /* Mark the selected match with an arrow */
+        if (hit == fd->fuzzy_sel) {
+            swin_wattron(fd->win, SWIN_A_BOLD);
+            swin_wprintw(fd->win, fmt, file + 1);
+            swin_wattroff(fd->win, SWIN_A_BOLD);
+
+            swin_wattron(fd->win, arrow_attr);
+            swin_waddch(fd->win, '-');
+            swin_waddch(fd->win, '>');
+            swin_wattroff(fd->win, arrow_attr);
+        } else {
+            swin_wprintw(fd->win, fmt, file + 1);
+
+            swin_wattron(fd->win, SWIN_A_BOLD);
+            swin_waddch(fd->win, SWIN_SYM_VLINE);
+            swin_wattroff(fd->win, SWIN_A_BOLD);
+
+            swin_waddch(fd->win, ' ');
+        }
+
+        y = swin_getcury(fd->win);
+        x = swin_getcurx(fd->win);
+
+        hl_printline(fd->win, filename, strlen(filename), file_attrs,
+                     -1, -1, fd->buf->sel_col, width - lwidth - 2);
+
+        if (pattern.len == 0 ||
+                !fuzzy_match(filename, &pattern, &score, positions))
+            continue;
+
+        /* Highlight each run of matched characters */
+        for (j = 0; j < pattern.len; j++) {
+            if (j == 0 || positions[j] != positions[j - 1] + 1)
+                attrs.push_back(hl_line_attr(positions[j], HLG_INCSEARCH));
+            if (j == pattern.len - 1 || positions[j + 1] != positions[j] + 1)
+                attrs.push_back(hl_line_attr(positions[j] + 1, 0));
+        }
+
+        hl_printline_highlight(fd->win, filename, strlen(filename),
+                     attrs, x, y, fd->buf->sel_col, width - lwidth - 2);
+    }
+
+    /* Update status bar */
+    swin_wattron(fd->win, statusbar);
+
+    for (i = 0; i < width; i++)
+        swin_mvwprintw(fd->win, height + 1, i, " ");
+
+    swin_mvwprintw(fd->win, height + 1, 0, "Find:%s", fuzzy_line);
+
+    snprintf(matches, sizeof(matches), "%d/%d",
+            (int)fd->fuzzy_matches.size(), sbcount(fd->buf->files));
+    if ((int)strlen(matches) + 1 < width)
+        swin_mvwprintw(fd->win, height + 1, width - strlen(matches) - 1,
+                "%s", matches);
+
+    swin_wattroff(fd->win, statusbar);
+
+    swin_wrefresh(fd->win);
+}
+
 int filedlg_display(struct filedlg *fd)
 {
     char fmt[16];
@@ -350,6 +837,13 @@ int filedlg_display(struct filedlg *fd)
         return 0;
     }
 
+    filedlg_sort(fd);
+
+    if (fuzzy_search) {
+        filedlg_display_fuzzy(fd);
+        return 0;
+    }
+
     /* Initialize variables */
     height = swin_getmaxy(fd->win);
     width = swin_getmaxx(fd->win);
@@ -398,7 +892,12 @@ int filedlg_display(struct filedlg *fd)
         }
 
         int x, y;
-        char *filename = fd->buf->files[file];
+        char *filename = fd->buf->files[file].path;
+        std::vector<hl_line_attr> file_attrs;
+
+        /* Dim the files that can't be opened */
+        if (!file_choice_exists(&fd->buf->files[file]))
+            file_attrs.push_back(hl_line_attr(0, SWIN_A_DIM));
 
         /* Mark the current file with an arrow */
         if (file == fd->buf->sel_line) {
@@ -426,8 +925,7 @@ int filedlg_display(struct filedlg *fd)
         y = swin_getcury(fd->win);
         x = swin_getcurx(fd->win);
 
-        std::vector<hl_line_attr> empty_attrs;
-        hl_printline(fd->win, filename, strlen(filename), empty_attrs,
+        hl_printline(fd->win, filename, strlen(filename), file_attrs,
                      -1, -1, fd->buf->sel_col, width - lwidth - 2);
 
         // if highlight search is on
@@ -581,11 +1079,121 @@ static int capture_regex(struct filedlg *fd)
     return 0;
 }
 
+/* capture_fuzzy: Lets the user find a file by typing part of its name.
+ * --------------
+ *
+ * The matches are narrowed and ranked as each character is typed. Keys
+ * typed ahead are all taken before the files are matched and drawn again.
+ *
+ *  Side Effect:
+ *
+ *  fuzzy_line: The pattern the user has entered.
+ *  buf->sel_line: The file the user picked, if any.
+ *
+ * Return Value: 0 if user picked a file, otherwise 1.
+ */
+static int capture_fuzzy(struct filedlg *fd)
+{
+    int c;
+    int find = 0;
+    int narrow = 1;
+    extern kui_manager *kui_ctx;
+
+    /* Initialize the function for finding a file and tell user */
+    fuzzy_search = 1;
+    fuzzy_line_pos = 0;
+    fuzzy_line[fuzzy_line_pos] = '\0';
+    filedlg_fuzzy_find(fd, 0);
+    filedlg_display(fd);
+
+    do {
+        c = kui_ctx->getkey_blocking();
+
+        /* Quit finding if the user hit escape */
+        if (c == CGDB_KEY_ESC) {
+            fuzzy_search = 0;
+            filedlg_display(fd);
+            return 1;
+        }
+
+        /* If the user hit enter, then pick the selected match */
+        if (c == '\r' || c == '\n' || c == CGDB_KEY_CTRL_M) {
+            if (find)
+                filedlg_fuzzy_find(fd, narrow);
+            break;
+        }
+
+        if (c == CGDB_KEY_UP || c == CGDB_KEY_CTRL_P) {
+            if (fd->fuzzy_sel > 0)
+                fd->fuzzy_sel--;
+        } else if (c == CGDB_KEY_DOWN || c == CGDB_KEY_CTRL_N) {
+            if (fd->fuzzy_sel < (int)fd->fuzzy_hits.size() - 1)
+                fd->fuzzy_sel++;
+        } else if (c == 8 || c == 127) {
+            /* If the user hit backspace or delete remove a char */
+            if (fuzzy_line_pos > 0) {
+                fuzzy_line[--fuzzy_line_pos] = '\0';
+                find = 1;
+                narrow = 0;
+            }
+        } else if (c >= ' ' && c <= 0xff && fuzzy_line_pos < MAX_LINE - 1) {
+            /* Add a char, the files matching now are all that can match */
+            fuzzy_line[fuzzy_line_pos++] = c;
+            fuzzy_line[fuzzy_line_pos] = '\0';
+            if (!find)
+                narrow = 1;
+            find = 1;
+        }
+
+        if (kui_ctx->cangetkey())
+            continue;
+
+        if (find) {
+            filedlg_fuzzy_find(fd, narrow);
+            find = 0;
+        }
+        filedlg_display(fd);
+    } while (1);
+
+    /* Finished */
+    fuzzy_search = 0;
+    if (fd->fuzzy_hits.empty()) {
+        filedlg_display(fd);
+        return 1;
+    }
+
+    fd->buf->sel_line = fd->fuzzy_hits[fd->fuzzy_sel].file;
+    filedlg_display(fd);
+    return 0;
+}
+
+/* filedlg_choose: Pick the selected file, if it exists.
+ * ---------------
+ *
+ *  file: The selected file is copied here
+ *
+ * Return Value: 1 if the file was picked, 0 otherwise.
+ */
+static int filedlg_choose(struct filedlg *fd, char *file)
+{
+    static char missing[] = "The selected file does not exist.";
+    struct file_choice *choice = &fd->buf->files[fd->buf->sel_line];
+
+    if (!file_choice_exists(choice)) {
+        filedlg_display_message(fd, missing);
+        return 0;
+    }
+
+    strcpy(file, choice->path);
+    return 1;
+}
+
 int filedlg_recv_char(struct filedlg *fd, int key, char *file, int last_key_pressed)
 {
     /* Initialize size variables */
     int height = swin_getmaxy(fd->win);
 
+    filedlg_sort(fd);
     filedlg_display(fd);
 
     switch (key) {
@@ -637,12 +1245,16 @@ int filedlg_recv_char(struct filedlg *fd, int key, char *file, int last_key_pres
         case 'N':
             filedlg_search_regex(fd, regex_line, 2, !regex_direction, 1);
             break;
+        case CGDB_KEY_CTRL_P:
+            /* Finding a file by part of its name */
+            if (capture_fuzzy(fd) == 0)
+                return filedlg_choose(fd, file);
+            break;
             /* User selected a file */
         case '\n':
         case '\r':
         case CGDB_KEY_CTRL_M:
-            strcpy(file, fd->buf->files[fd->buf->sel_line]);
-            return 1;
+            return filedlg_choose(fd, file);
 
         case 'g':              /* beginning of file */
             if (last_key_pressed == 'g')
@@ -117,6 +117,7 @@ static const struct default_hl_group_info default_groups_for_background_dark[]
     {HLG_SCROLL_MODE_STATUS, SWIN_A_BOLD, SWIN_A_BOLD, -1, -1},
     {HLG_LOGO, SWIN_A_BOLD, SWIN_A_BOLD, COLOR_BLUE, -1},
     {HLG_MARK, SWIN_A_BOLD, SWIN_A_BOLD, COLOR_WHITE, -1},
+    {HLG_CHANGED_VALUE, SWIN_A_BOLD, SWIN_A_BOLD, COLOR_RED, -1},
     {HLG_LAST, SWIN_A_NORMAL, SWIN_A_NORMAL, -1, -1}
 };
 
@@ -154,6 +155,7 @@ static struct hl_group_name hl_group_names[] = {
     {HLG_SCROLL_MODE_STATUS, "ScrollModeStatus"},
     {HLG_LOGO, "Logo"},
     {HLG_MARK, "Mark"},
+    {HLG_CHANGED_VALUE, "ChangedValue"},
     {HLG_LAST, NULL}
 };
 
@@ -574,6 +576,7 @@ hl_groups_get_attr(hl_groups_ptr hl_groups, enum hl_group_kind kind)
         case HLG_SCROLL_MODE_STATUS:
         case HLG_LOGO:
         case HLG_MARK:
+        case HLG_CHANGED_VALUE:
         case HLG_LAST:
         case HLG_INCSEARCH:
             break;
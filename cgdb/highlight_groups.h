@@ -51,6 +51,7 @@ enum hl_group_kind {
     HLG_SCROLL_MODE_STATUS,
     HLG_LOGO,
     HLG_MARK,
+    HLG_CHANGED_VALUE,
     HLG_LAST,
 
     /* Straight colors - not configurable */
@@ -83,6 +83,11 @@
 #include "sources.h"
 #include "tgdb.h"
 #include "filedlg.h"
+#include "backtrace.h"
+#include "variables.h"
+#include "registers.h"
+#include "memview.h"
+#include "threadview.h"
 #include "cgdbrc.h"
 #include "highlight.h"
 #include "highlight_groups.h"
@@ -128,6 +133,18 @@ static struct scroller *gdb_scroller = NULL;
 static struct sviewer *src_viewer = NULL;  /* The source viewer window */
 static SWINDOW *status_win = NULL;   /* The status line */
 static SWINDOW *vseparator_win = NULL;   /* Separator gets own window */
+static struct backtrace *bt_pane = NULL;  /* The backtrace pane */
+static struct variables *var_pane = NULL;  /* The variables pane */
+static struct registers *reg_pane = NULL;  /* The registers pane */
+static struct memview *mem_pane = NULL;  /* The memory pane */
+static struct threadview *thr_pane = NULL;  /* The threads pane */
+
+/* The pane shown below the source window, if any */
+enum pane_kind {
+    PANE_NONE, PANE_BACKTRACE, PANE_VARIABLES, PANE_REGISTERS, PANE_MEMORY,
+    PANE_THREADS
+};
+static enum pane_kind cur_pane = PANE_NONE;
 static enum Focus focus = GDB;  /* Which pane is currently focused */
 static struct winsize screen_size;  /* Screen size */
 
@@ -193,9 +210,30 @@ static char last_key_pressed = 0;   /* Last key user entered in cgdb mode */
 /* Line number user wants to 'G' to */
 static std::string G_line_number;
 
+/* Non-zero while more keys are queued, see if_set_input_pending */
+static int input_pending = 0;
+
+/* Non-zero if the source window moved and has not been drawn since */
+static int draw_pending = 0;
+
+/* Non-zero while printing does not draw, see if_set_print_deferred */
+static int print_deferred = 0;
+
+/* Non-zero if the GDB window was printed to and has not been drawn since */
+static int print_pending = 0;
+
+/* Non-zero if gdb changed the shown pane and it has not been drawn since */
+static int pane_pending = 0;
+
+/* Non-zero if gdb's threads changed and the threads pane wasn't told yet */
+static int threads_pending = 0;
+
 /* The cgdb status bar command */
 static std::string cur_sbc;
 
+/* What the status bar shows while gdb is starting, see if_startup_status */
+static std::string startup_status;
+
 enum StatusBarCommandKind {
     /* This is represented by a : */
     SBC_NORMAL,
@@ -245,6 +283,26 @@ static int get_src_height(void)
     return result;
 }
 
+/* A pane shares the source area, taking the bottom half */
+static int get_pane_height(void)
+{
+    if (cur_pane == PANE_NONE || get_src_height() < 4)
+        return 0;
+
+    return get_src_height() / 2;
+}
+
+static int get_pane_row(void)
+{
+    return get_src_row() + get_src_height() - get_pane_height();
+}
+
+/* The source viewer gets what's left of the source area */
+static int get_src_viewer_height(void)
+{
+    return get_src_height() - get_pane_height();
+}
+
 static int get_src_width(void)
 {
     int result;
@@ -441,7 +499,9 @@ static void update_status_win(enum win_refresh dorefresh)
     /* Show the user which window is focused */
     if (focus == GDB)
         swin_mvwprintw(status_win, 0, WIDTH - 1, "*");
-    else if (focus == CGDB || focus == CGDB_STATUS_BAR)
+    else if (focus == CGDB || focus == CGDB_STATUS_BAR ||
+             focus == BACKTRACE || focus == VARIABLES || focus == REGISTERS ||
+             focus == MEMORY || focus == THREADS)
         swin_mvwprintw(status_win, 0, WIDTH - 1, " ");
 
     swin_wattroff(status_win, attr);
@@ -461,6 +521,14 @@ static void update_status_win(enum win_refresh dorefresh)
         if_display_message(dorefresh, ":", cur_sbc.c_str());
         swin_curs_set(1);
     }
+    /* gdb is still loading the program. Printed on the background
+     * directly, as this is redrawn while the cursor is in another window. */
+    else if (!startup_status.empty()) {
+        swin_wattron(status_win, attr);
+        swin_mvwprintw(status_win, 0, 0, "%.*s", get_src_status_width(),
+                startup_status.c_str());
+        swin_wattroff(status_win, attr);
+    }
     /* Default: Current Filename */
     else {
         /* Print filename */
@@ -516,11 +584,41 @@ void if_display_message(enum win_refresh dorefresh,
         swin_wnoutrefresh(status_win);
 }
 
+/* Tell the threads pane about a burst of thread events at once */
+static void if_threads_update(void)
+{
+    if (threads_pending && thr_pane)
+        threadview_changed(thr_pane);
+
+    threads_pending = 0;
+}
+
+/* Draw the pane shown below the source window, if any */
+static void if_pane_display(void)
+{
+    if (cur_pane == PANE_BACKTRACE)
+        backtrace_display(bt_pane, focus == BACKTRACE, WIN_NO_REFRESH);
+    else if (cur_pane == PANE_VARIABLES)
+        variables_display(var_pane, focus == VARIABLES, WIN_NO_REFRESH);
+    else if (cur_pane == PANE_REGISTERS)
+        registers_display(reg_pane, focus == REGISTERS, WIN_NO_REFRESH);
+    else if (cur_pane == PANE_MEMORY)
+        memview_display(mem_pane, focus == MEMORY, WIN_NO_REFRESH);
+    else if (cur_pane == PANE_THREADS)
+        threadview_display(thr_pane, focus == THREADS, WIN_NO_REFRESH);
+}
+
 /* if_draw: Draws the interface on the screen.
  * --------
  */
 void if_draw(void)
 {
+    draw_pending = 0;
+    print_pending = 0;
+    pane_pending = 0;
+
+    if_threads_update();
+
     /* Only redisplay the filedlg if it is up */
     if (focus == FILE_DLG) {
         filedlg_display(fd);
@@ -535,6 +633,8 @@ void if_draw(void)
     if (get_src_height() > 0)
         source_display(src_viewer, focus == CGDB, WIN_NO_REFRESH, no_hlsearch);
 
+    if_pane_display();
+
     separator_display(cur_split_orientation == WSO_VERTICAL);
 
     if (get_gdb_height() > 0)
@@ -589,12 +689,13 @@ int if_layout()
 {
     SWINDOW *gdb_scroller_win = NULL;
     SWINDOW *src_viewer_win = NULL;
+    SWINDOW *pane_win = NULL;
 
     /* Verify the window size is reasonable */
     validate_window_sizes();
 
     /* Resize the source viewer window */
-    create_swindow(&src_viewer_win, get_src_height(), get_src_width(),
+    create_swindow(&src_viewer_win, get_src_viewer_height(), get_src_width(),
         get_src_row(), get_src_col());
     if (src_viewer) {
         source_move(src_viewer, src_viewer_win);
@@ -602,6 +703,26 @@ int if_layout()
         src_viewer = source_new(src_viewer_win);
     }
 
+    /* Resize the pane, only the pane that is shown has a window */
+    create_swindow(&pane_win, get_pane_height(), get_src_width(),
+        get_pane_row(), get_src_col());
+    if (!bt_pane)
+        bt_pane = backtrace_new(NULL);
+    if (!var_pane)
+        var_pane = variables_new(NULL);
+    if (!reg_pane)
+        reg_pane = registers_new(NULL);
+    if (!mem_pane)
+        mem_pane = memview_new(NULL);
+    if (!thr_pane)
+        thr_pane = threadview_new(NULL);
+    backtrace_move(bt_pane, cur_pane == PANE_BACKTRACE ? pane_win : NULL);
+    variables_move(var_pane, cur_pane == PANE_VARIABLES ? pane_win : NULL);
+    registers_move(reg_pane, cur_pane == PANE_REGISTERS ? pane_win : NULL);
+    memview_move(mem_pane, cur_pane == PANE_MEMORY ? pane_win : NULL);
+    threadview_move(thr_pane, cur_pane == PANE_THREADS ? pane_win : NULL);
+    if_backtrace_request();
+
     tgdb_resize_console(tgdb, get_gdb_height(), get_gdb_width());
 
     /* Resize the GDB I/O window */
@@ -778,6 +899,12 @@ static void if_run_command(struct sviewer *sview, const std::string &command)
         update_status_win(WIN_NO_REFRESH);
     }
 
+    /* The command may have changed colors the source viewer can't see */
+    source_invalidate(sview);
+    if (var_pane)
+        variables_invalidate(var_pane);
+    if (reg_pane)
+        registers_invalidate(reg_pane);
     if_draw();
 }
 
@@ -1110,7 +1237,10 @@ static int status_bar_normal_input(int key)
 
     if (done) {
         cur_sbc.clear();
-        if_set_focus(CGDB);
+
+        /* The command may have focused another window */
+        if (focus == CGDB_STATUS_BAR)
+            if_set_focus(CGDB);
     }
 
     return 0;
@@ -1189,6 +1319,39 @@ toggle_breakpoint(struct sviewer *sview, enum tgdb_breakpoint_action t)
     return 0;
 }
 
+/* source_input_is_navigation: Check if a key only moves around the source.
+ * ---------------------------
+ *
+ *   key:       Keystroke received.
+ *
+ * Return Value: 1 if the key only changes the position in the source window,
+ *               0 otherwise.
+ */
+static int source_input_is_navigation(int key)
+{
+    switch (key) {
+        case CGDB_KEY_UP:
+        case 'k':
+        case CGDB_KEY_DOWN:
+        case 'j':
+        case CGDB_KEY_LEFT:
+        case 'h':
+        case CGDB_KEY_RIGHT:
+        case 'l':
+        case CGDB_KEY_CTRL_U:
+        case CGDB_KEY_PPAGE:
+        case CGDB_KEY_CTRL_B:
+        case CGDB_KEY_CTRL_D:
+        case CGDB_KEY_NPAGE:
+        case CGDB_KEY_CTRL_F:
+        case 'g':
+        case 'G':
+            return 1;
+    }
+
+    return 0;
+}
+
 /* source_input: Handles user input to the source window.
  * -------------
  *
@@ -1221,18 +1384,18 @@ static void source_input(struct sviewer *sview, int key)
             source_hscroll(sview, 1);
             break;
         case CGDB_KEY_CTRL_U:  /* VI-style 1/2 page up */
-            source_vscroll(sview, -(get_src_height() / 2));
+            source_vscroll(sview, -(get_src_viewer_height() / 2));
             break;
         case CGDB_KEY_PPAGE:
         case CGDB_KEY_CTRL_B:  /* VI-style page up */
-            source_vscroll(sview, -(get_src_height() - 1));
+            source_vscroll(sview, -(get_src_viewer_height() - 1));
             break;
         case CGDB_KEY_CTRL_D:  /* VI-style 1/2 page down */
-            source_vscroll(sview, (get_src_height() / 2));
+            source_vscroll(sview, (get_src_viewer_height() / 2));
             break;
         case CGDB_KEY_NPAGE:
         case CGDB_KEY_CTRL_F:  /* VI-style page down */
-            source_vscroll(sview, get_src_height() - 1);
+            source_vscroll(sview, get_src_viewer_height() - 1);
             break;
         case 'g':              /* beginning of file */
             if (last_key_pressed == 'g')
@@ -1302,6 +1465,20 @@ static void source_input(struct sviewer *sview, int key)
         G_line_number.clear();
     }
 
+    /* Load more of a windowed disassembly as the selection nears its edge */
+    if (source_input_is_navigation(key)) {
+        uint64_t start, end;
+
+        if (source_disasm_wants(sview, &start, &end))
+            tgdb_request_disassemble_range(tgdb, start, end);
+    }
+
+    /* Let the last of a burst of queued navigation keys do the drawing */
+    if (input_pending && source_input_is_navigation(key)) {
+        draw_pending = 1;
+        return;
+    }
+
     /* Some extended features that are set by :set sc */
     if_draw();
 }
@@ -1513,6 +1690,16 @@ static int cgdb_input(int key, int *last_key)
     return 0;
 }
 
+/* if_close_pane: The user closed the pane, go back to the source window.
+ * --------------
+ */
+static void if_close_pane(void)
+{
+    cur_pane = PANE_NONE;
+    if_set_focus(CGDB);
+    if_layout();
+}
+
 int internal_if_input(int key, int *last_key)
 {
     /* Normally, CGDB_KEY_ESC, but can be configured by the user */
@@ -1583,6 +1770,62 @@ int internal_if_input(int key, int *last_key)
             }
         }
             return 0;
+        case BACKTRACE:
+        {
+            const tgdb_frame *frame = NULL;
+            int ret = backtrace_input(bt_pane, key, &frame);
+
+            /* The user closed the pane */
+            if (ret == -1) {
+                if_close_pane();
+                return 0;
+                /* The user picked a frame */
+            } else if (ret == 1) {
+                tgdb_request_select_frame(tgdb, frame->level);
+            }
+
+            if_backtrace_request();
+            if_draw();
+        }
+            return 0;
+        case VARIABLES:
+            /* The user closed the pane */
+            if (variables_input(var_pane, key) == -1) {
+                if_close_pane();
+                return 0;
+            }
+
+            if_draw();
+            return 0;
+        case REGISTERS:
+            /* The user closed the pane */
+            if (registers_input(reg_pane, key) == -1) {
+                if_close_pane();
+                return 0;
+            }
+
+            if_draw();
+            return 0;
+        case MEMORY:
+            /* The user closed the pane */
+            if (memview_input(mem_pane, key) == -1) {
+                if_close_pane();
+                return 0;
+            }
+
+            if_draw();
+            return 0;
+        case THREADS:
+            if_threads_update();
+
+            /* The user closed the pane */
+            if (threadview_input(thr_pane, key) == -1) {
+                if_close_pane();
+                return 0;
+            }
+
+            if_draw();
+            return 0;
         case CGDB_STATUS_BAR:
             return status_bar_input(src_viewer, key);
     }
@@ -1591,6 +1834,20 @@ int internal_if_input(int key, int *last_key)
     return 0;
 }
 
+int if_paste_to_gdb(void)
+{
+    return focus == GDB && !scr_search_mode(gdb_scroller) &&
+        !scr_scroll_mode(gdb_scroller);
+}
+
+void if_set_input_pending(int pending)
+{
+    input_pending = pending;
+
+    if (!input_pending && draw_pending)
+        if_draw();
+}
+
 int if_input(int key)
 {
     int last_key = key;
@@ -1610,21 +1867,66 @@ static void if_print_internal(const char *buf)
     /* Print it to the scroller */
     scr_add(gdb_scroller, buf);
 
-    if (get_gdb_height() > 0) {
+    print_pending = 1;
+    if (!print_deferred)
+        if_print_flush();
+}
+
+void if_print(const char *buf)
+{
+    if_print_internal(buf);
+}
+
+void if_set_print_deferred(int deferred)
+{
+    print_deferred = deferred;
+
+    if (!print_deferred)
+        if_print_flush();
+}
+
+int if_print_pending(void)
+{
+    return print_pending || pane_pending;
+}
+
+void if_print_flush(void)
+{
+    int drawn = 0;
+
+    if_threads_update();
+
+    if (print_pending && get_gdb_height() > 0) {
         scr_refresh(gdb_scroller, focus == GDB, WIN_NO_REFRESH);
+        drawn = 1;
+    }
+
+    if (pane_pending) {
+        if_pane_display();
+        drawn = 1;
+    }
+
+    print_pending = 0;
+    pane_pending = 0;
 
+    if (drawn) {
         /* Make sure cursor reappears in source window if focus is there */
         if (focus == CGDB)
             swin_wnoutrefresh(src_viewer->win);
 
         swin_doupdate();
     }
-
 }
 
-void if_print(const char *buf)
+/* Draw a pane gdb changed along with gdb's output, if the pane is shown */
+static void if_pane_changed(enum pane_kind pane)
 {
-    if_print_internal(buf);
+    if (cur_pane != pane)
+        return;
+
+    pane_pending = 1;
+    if (!print_deferred)
+        if_print_flush();
 }
 
 void if_sdc_print(const char *buf)
@@ -1729,10 +2031,44 @@ void if_shutdown(void)
         swin_delwin(vseparator_win);
         vseparator_win = NULL;
     }
+
+    if (bt_pane) {
+        backtrace_free(bt_pane);
+        bt_pane = NULL;
+    }
+
+    if (var_pane) {
+        variables_free(var_pane);
+        var_pane = NULL;
+    }
+
+    if (reg_pane) {
+        registers_free(reg_pane);
+        reg_pane = NULL;
+    }
+
+    if (mem_pane) {
+        memview_free(mem_pane);
+        mem_pane = NULL;
+    }
+
+    if (thr_pane) {
+        threadview_free(thr_pane);
+        thr_pane = NULL;
+    }
 }
 
 void if_set_focus(Focus f)
 {
+    /* The file dialog was drawn on top of the source window */
+    if (focus == FILE_DLG && f != FILE_DLG && src_viewer) {
+        source_invalidate(src_viewer);
+        if (var_pane)
+            variables_invalidate(var_pane);
+        if (reg_pane)
+            registers_invalidate(reg_pane);
+    }
+
     switch (f) {
         case GDB:
             focus = f;
@@ -1746,6 +2082,14 @@ void if_set_focus(Focus f)
             focus = f;
             if_draw();
             break;
+        case BACKTRACE:
+        case VARIABLES:
+        case REGISTERS:
+        case MEMORY:
+        case THREADS:
+            focus = f;
+            if_draw();
+            break;
         case CGDB_STATUS_BAR:
             focus = f;
             if_draw();
@@ -1759,6 +2103,242 @@ Focus if_get_focus(void)
     return focus;
 }
 
+/* Show a pane below the source window, in place of the one shown */
+static void if_show_pane(enum pane_kind pane)
+{
+    if (cur_pane != pane) {
+        cur_pane = pane;
+        if_layout();
+    }
+}
+
+void if_show_backtrace(void)
+{
+    if_show_pane(PANE_BACKTRACE);
+    if_set_focus(BACKTRACE);
+}
+
+void if_backtrace_request(void)
+{
+    int low, high;
+
+    if (bt_pane && backtrace_wants(bt_pane, &low, &high))
+        tgdb_request_stack_frames(tgdb, low, high);
+}
+
+void if_backtrace_frames(int low, int high, bool error,
+        const std::list<tgdb_frame> &frames)
+{
+    if (!bt_pane)
+        return;
+
+    backtrace_add_frames(bt_pane, low, high, error, frames);
+
+    /* The user may have scrolled past these already */
+    if_backtrace_request();
+
+    if_pane_changed(PANE_BACKTRACE);
+}
+
+void if_backtrace_changed(void)
+{
+    if (!bt_pane)
+        return;
+
+    backtrace_clear(bt_pane);
+
+    /* Don't walk the stack on every stop unless someone is looking */
+    if (cur_pane == PANE_BACKTRACE) {
+        if_backtrace_request();
+        if_pane_changed(PANE_BACKTRACE);
+    }
+}
+
+void if_show_variables(void)
+{
+    if_show_pane(PANE_VARIABLES);
+    if_set_focus(VARIABLES);
+}
+
+void if_add_watch(const char *expr)
+{
+    /* The cgdbrc may add watches before the interface is up */
+    if (!var_pane)
+        var_pane = variables_new(NULL);
+
+    variables_add_watch(var_pane, expr);
+
+    if (src_viewer) {
+        if_show_pane(PANE_VARIABLES);
+        if_draw();
+    } else {
+        cur_pane = PANE_VARIABLES;
+    }
+}
+
+void if_variables_frame_changed(void)
+{
+    if (var_pane)
+        variables_frame_changed(var_pane);
+}
+
+void if_variables_locals(bool error, const std::list<std::string> &names)
+{
+    if (var_pane) {
+        variables_set_locals(var_pane, error, names);
+        if_pane_changed(PANE_VARIABLES);
+    }
+}
+
+void if_variables_created(const std::string &name, bool error,
+        const tgdb_varobj &varobj)
+{
+    if (var_pane) {
+        variables_created(var_pane, name, error, varobj);
+        if_pane_changed(PANE_VARIABLES);
+    }
+}
+
+void if_variables_children(const std::string &name, bool error,
+        const std::list<tgdb_varobj> &children)
+{
+    if (var_pane) {
+        variables_children(var_pane, name, error, children);
+        if_pane_changed(PANE_VARIABLES);
+    }
+}
+
+void if_variables_changes(bool error,
+        const std::list<tgdb_varobj_change> &changes)
+{
+    if (var_pane) {
+        variables_changes(var_pane, error, changes);
+        if_pane_changed(PANE_VARIABLES);
+    }
+}
+
+void if_show_registers(void)
+{
+    if_show_pane(PANE_REGISTERS);
+    if_set_focus(REGISTERS);
+}
+
+void if_registers_frame_changed(void)
+{
+    if (reg_pane)
+        registers_frame_changed(reg_pane);
+}
+
+void if_registers_names(bool error,
+        const std::list<tgdb_register> &registers)
+{
+    if (reg_pane) {
+        registers_set_names(reg_pane, error, registers);
+        if_pane_changed(PANE_REGISTERS);
+    }
+}
+
+void if_registers_changed(bool error, const std::list<int> &numbers)
+{
+    if (reg_pane) {
+        registers_changed(reg_pane, error, numbers);
+        if_pane_changed(PANE_REGISTERS);
+    }
+}
+
+void if_registers_values(bool error,
+        const std::list<tgdb_register> &registers)
+{
+    if (reg_pane) {
+        registers_set_values(reg_pane, error, registers);
+        if_pane_changed(PANE_REGISTERS);
+    }
+}
+
+void if_show_memory(const char *expr)
+{
+    /* The cgdbrc may show memory before the interface is up */
+    if (!mem_pane)
+        mem_pane = memview_new(NULL);
+
+    if (expr)
+        memview_set_address(mem_pane, expr);
+
+    if (src_viewer) {
+        if_show_pane(PANE_MEMORY);
+        if_set_focus(MEMORY);
+    } else {
+        cur_pane = PANE_MEMORY;
+    }
+}
+
+void if_memory_frame_changed(void)
+{
+    if (mem_pane)
+        memview_frame_changed(mem_pane);
+}
+
+void if_memory_read(const std::string &addr, uint64_t start, int count,
+        bool error, const std::list<tgdb_memory_block> &blocks)
+{
+    if (!mem_pane)
+        return;
+
+    memview_read(mem_pane, addr, start, count, error, blocks);
+
+    if_pane_changed(PANE_MEMORY);
+}
+
+void if_show_threads(void)
+{
+    if_show_pane(PANE_THREADS);
+    if_set_focus(THREADS);
+}
+
+void if_threads_changed(void)
+{
+    /* The pane catches up once, when it is next drawn */
+    threads_pending = 1;
+    if_pane_changed(PANE_THREADS);
+}
+
+void if_threads_frame_changed(void)
+{
+    if (thr_pane)
+        threadview_frame_changed(thr_pane);
+}
+
+void if_threads_info(int id, bool error, const tgdb_thread_info &info)
+{
+    if (thr_pane) {
+        threadview_info(thr_pane, id, error, info);
+        if_pane_changed(PANE_THREADS);
+    }
+}
+
+void if_startup_status(const char *status)
+{
+    int y, x;
+
+    startup_status = status ? status : "";
+
+    /* The file dialog is drawn over the status bar */
+    if (!status_win || focus == FILE_DLG)
+        return;
+
+    /* Back to the current file, drawn like any other time */
+    if (!status) {
+        if_draw();
+        return;
+    }
+
+    /* Only the status bar changes, the cursor stays where it was */
+    swin_getsyx(&y, &x);
+    update_status_win(WIN_NO_REFRESH);
+    swin_setsyx(y, x);
+    swin_doupdate();
+}
+
 void reset_window_shift(void)
 {
     int h_or_w = cur_split_orientation == WSO_HORIZONTAL ? HEIGHT : WIDTH;
@@ -43,6 +43,25 @@ int if_resize_term(void);
 
 int if_input(int key);
 
+/* if_paste_to_gdb: Check if pasted text can be sent straight to gdb.
+ * ----------------
+ *
+ * Return Value: 1 if the GDB window has focus and passes every key it
+ *               receives on to gdb, 0 otherwise.
+ */
+int if_paste_to_gdb(void);
+
+/* if_set_input_pending: Tell the interface if more keys are already queued.
+ * ---------------------
+ *
+ * While keys are pending, keys that only move around the source window
+ * update the position without drawing, so a burst of repeated navigation
+ * keys is drawn once. Clearing the flag draws anything that was skipped.
+ *
+ *   pending:  Non-zero if more keys will be passed to if_input right away
+ */
+void if_set_input_pending(int pending);
+
 /* if_print: Prints data to the GDB input/output window.
  * ---------
  *
@@ -50,6 +69,28 @@ int if_input(int key);
  */
 void if_print(const char *buf);
 
+/* if_set_print_deferred: Put off drawing what is printed until asked to.
+ * ----------------------
+ *
+ * While set, if_print adds to the GDB window without drawing it, so a
+ * burst of output is drawn once by if_print_flush.
+ *
+ *   deferred:  Non-zero to put off drawing, zero to draw as printed
+ */
+void if_set_print_deferred(int deferred);
+
+/* if_print_pending: Check if printed data, or a pane gdb changed, has not
+ * -----------------  been drawn yet.
+ *
+ * Return Value: 1 if if_print_flush has something to draw, 0 otherwise.
+ */
+int if_print_pending(void);
+
+/* if_print_flush: Draw the GDB window if data was printed since it was drawn,
+ * ---------------  and the pane if gdb changed it since it was drawn.
+ */
+void if_print_flush(void);
+
 /* if_print_message: Prints data to the GDB input/output window.
  * -----------------
  *
@@ -138,8 +179,16 @@ void if_shutdown(void);
  *  CGDB: focus on source window, accepts command input.
  *  CGDB_STATUS_BAR: focus on the status bar, accepts commands.
  *  FILE_DLG: focus on file dialog window
+ *  BACKTRACE: focus on the backtrace pane
+ *  VARIABLES: focus on the variables pane
+ *  REGISTERS: focus on the registers pane
+ *  MEMORY: focus on the memory pane
+ *  THREADS: focus on the threads pane
  */
-typedef enum Focus { GDB, CGDB, CGDB_STATUS_BAR, FILE_DLG } Focus;
+typedef enum Focus {
+    GDB, CGDB, CGDB_STATUS_BAR, FILE_DLG, BACKTRACE, VARIABLES, REGISTERS,
+    MEMORY, THREADS
+} Focus;
 
 /* if_set_focus: Sets the current input focus to a different window 
  * ------------
@@ -153,6 +202,188 @@ void if_set_focus(Focus f);
  */
 Focus if_get_focus(void);
 
+/* if_show_backtrace: Shows the backtrace pane below the source window.
+ * ------------------
+ *
+ * The pane takes the focus, 'q' closes it.
+ */
+void if_show_backtrace(void);
+
+/* if_backtrace_request: Asks gdb for the frames the backtrace pane needs.
+ * ---------------------
+ */
+void if_backtrace_request(void);
+
+/* if_backtrace_frames: Gives the backtrace pane the frames gdb sent.
+ * --------------------
+ *
+ *  low:    The first frame asked for
+ *  high:   The last frame asked for
+ *  error:  True if gdb couldn't list the frames
+ *  frames: The frames gdb sent
+ */
+void if_backtrace_frames(int low, int high, bool error,
+        const std::list<tgdb_frame> &frames);
+
+/* if_backtrace_changed: The stack changed, the frames shown are stale.
+ * ---------------------
+ */
+void if_backtrace_changed(void);
+
+/* if_show_variables: Shows the variables pane below the source window.
+ * ------------------
+ *
+ * The pane takes the focus, 'q' closes it.
+ */
+void if_show_variables(void);
+
+/* if_add_watch: Adds an expression to the watches of the variables pane.
+ * -------------
+ *
+ *  expr: The expression to watch
+ */
+void if_add_watch(const char *expr);
+
+/* if_variables_frame_changed: The locals and watches may have changed.
+ * ---------------------------
+ */
+void if_variables_frame_changed(void);
+
+/* if_variables_locals: Gives the variables pane the names of the locals.
+ * --------------------
+ *
+ *  error: True if gdb couldn't list the locals
+ *  names: The names of the locals and arguments of the selected frame
+ */
+void if_variables_locals(bool error, const std::list<std::string> &names);
+
+/* if_variables_created: Gives the variables pane a new variable object.
+ * ---------------------
+ *
+ *  name:   The name the variable object was asked for with
+ *  error:  True if gdb couldn't create the variable object
+ *  varobj: The variable object
+ */
+void if_variables_created(const std::string &name, bool error,
+        const tgdb_varobj &varobj);
+
+/* if_variables_children: Gives the variables pane the children of a variable.
+ * ----------------------
+ *
+ *  name:     The variable object the children are of
+ *  error:    True if gdb couldn't list the children
+ *  children: The children
+ */
+void if_variables_children(const std::string &name, bool error,
+        const std::list<tgdb_varobj> &children);
+
+/* if_variables_changes: Gives the variables pane the values that changed.
+ * ---------------------
+ *
+ *  error:   True if gdb couldn't update the variable objects
+ *  changes: The variable objects that changed
+ */
+void if_variables_changes(bool error,
+        const std::list<tgdb_varobj_change> &changes);
+
+/* if_show_registers: Shows the registers pane below the source window.
+ * ------------------
+ *
+ * The pane takes the focus, 'q' closes it.
+ */
+void if_show_registers(void);
+
+/* if_registers_frame_changed: The registers may have changed.
+ * ---------------------------
+ */
+void if_registers_frame_changed(void);
+
+/* if_registers_names: Gives the registers pane the names of the registers.
+ * -------------------
+ *
+ *  error:     True if gdb couldn't list the registers
+ *  registers: The registers, by number
+ */
+void if_registers_names(bool error,
+        const std::list<tgdb_register> &registers);
+
+/* if_registers_changed: Gives the registers pane the registers that changed.
+ * ---------------------
+ *
+ *  error:   True if gdb couldn't list them
+ *  numbers: The numbers of the registers that changed
+ */
+void if_registers_changed(bool error, const std::list<int> &numbers);
+
+/* if_registers_values: Gives the registers pane the values of registers.
+ * --------------------
+ *
+ *  error:     True if gdb couldn't get the values
+ *  registers: The registers, with their values
+ */
+void if_registers_values(bool error,
+        const std::list<tgdb_register> &registers);
+
+/* if_show_memory: Shows the memory pane below the source window.
+ * ---------------
+ *
+ * The pane takes the focus, 'q' closes it.
+ *
+ *  expr: An expression for the address to show, or NULL to show the
+ *        address shown before
+ */
+void if_show_memory(const char *expr);
+
+/* if_memory_frame_changed: The memory may have changed.
+ * ------------------------
+ */
+void if_memory_frame_changed(void);
+
+/* if_memory_read: Gives the memory pane memory gdb read.
+ * ---------------
+ *
+ *  addr:   The address expression the memory was asked for with
+ *  start:  The address addr evaluated to
+ *  count:  The number of bytes asked for
+ *  error:  True if none of the memory could be read
+ *  blocks: The memory that could be read
+ */
+void if_memory_read(const std::string &addr, uint64_t start, int count,
+        bool error, const std::list<tgdb_memory_block> &blocks);
+
+/* if_show_threads: Shows the threads pane below the source window.
+ * ----------------
+ *
+ * The pane takes the focus, 'q' closes it.
+ */
+void if_show_threads(void);
+
+/* if_threads_changed: Threads were created, exited, ran or stopped.
+ * -------------------
+ */
+void if_threads_changed(void);
+
+/* if_threads_frame_changed: The frames of the threads may have changed.
+ * -------------------------
+ */
+void if_threads_frame_changed(void);
+
+/* if_threads_info: Gives the threads pane the details of a thread.
+ * ----------------
+ *
+ *  id:    The thread the details were asked for
+ *  error: True if gdb couldn't give them
+ *  info:  The details of the thread
+ */
+void if_threads_info(int id, bool error, const tgdb_thread_info &info);
+
+/* if_startup_status: Shows how gdb's startup is going in the status bar.
+ * ------------------
+ *
+ *  status: The text to show, or NULL once gdb started
+ */
+void if_startup_status(const char *status);
+
 /* if_display_help: Displays the help on the screen.
  * ------------
  */
@@ -0,0 +1,522 @@
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#if HAVE_STDLIB_H
+#include <stdlib.h>
+#endif /* HAVE_STDLIB_H */
+
+#if HAVE_STRING_H
+#include <string.h>
+#endif /* HAVE_STRING_H */
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "sys_util.h"
+#include "sys_win.h"
+#include "memview.h"
+#include "pane_list.h"
+#include "cgdb.h"
+#include "highlight_groups.h"
+
+extern struct tgdb *tgdb;
+
+/* The bytes read from gdb at once, and kept together in the cache */
+#define MEMVIEW_PAGE 256
+
+/* The most pages kept in the cache */
+#define MEMVIEW_CACHE_PAGES 1024
+
+/* The most bytes drawn on a row */
+#define MEMVIEW_MAX_ROW 16
+
+struct memview_page {
+    unsigned char bytes[MEMVIEW_PAGE];
+    char readable[MEMVIEW_PAGE];    /* Non-zero if the byte could be read */
+    char changed[MEMVIEW_PAGE];     /* Non-zero if it changed at the stop */
+
+    /* The page before it was last read, to find what changed */
+    unsigned char prev_bytes[MEMVIEW_PAGE];
+    char prev_readable[MEMVIEW_PAGE];
+
+    int fetched;                /* Non-zero if it was read */
+    int stale;                  /* Non-zero if the program ran since */
+    int requested;              /* Non-zero while it is being read */
+
+    /* Where the page is in the least recently used list */
+    std::list<uint64_t>::iterator lru;
+};
+
+struct memview {
+    /* The window and the keys. The rows are addresses, so the cursor and
+     * the scroll position are kept below. list.sel_line is the row of the
+     * window the cursor is on. */
+    struct pane_list list;
+
+    std::string expr;           /* The address the user asked for */
+    int expr_pending;           /* Non-zero while expr is looked up */
+    int expr_error;             /* Non-zero if expr couldn't be read */
+    int have_base;              /* Non-zero once expr was looked up */
+    uint64_t base;              /* The address expr evaluated to */
+
+    int bytes_per_row;          /* The bytes drawn on a row */
+    uint64_t top;               /* The address of the first row */
+    uint64_t sel;               /* The address of the row the cursor is on */
+
+    /* The pages read so far, by address */
+    std::map<uint64_t, memview_page *> pages;
+
+    /* The page addresses, the most recently used first */
+    std::list<uint64_t> lru;
+};
+
+static uint64_t memview_page_addr(uint64_t addr)
+{
+    return addr & ~(uint64_t)(MEMVIEW_PAGE - 1);
+}
+
+/* The most bytes that fit on a row, a power of two so rows line up
+ * with pages. A row is the cursor, the address, and 4 columns per byte,
+ * 3 for the hex and 1 for the character. */
+static int memview_fit_bytes_per_row(struct memview *mv)
+{
+    int width = mv->list.win ? swin_getmaxx(mv->list.win) : 0;
+    int bytes = MEMVIEW_MAX_ROW;
+
+    while (bytes > 1 && 2 + 18 + 2 + bytes * 4 + 1 > width)
+        bytes /= 2;
+
+    return bytes;
+}
+
+/* Find a page in the cache, and mark it as the most recently used */
+static struct memview_page *memview_find_page(struct memview *mv,
+        uint64_t addr)
+{
+    std::map<uint64_t, memview_page *>::iterator iter =
+        mv->pages.find(memview_page_addr(addr));
+
+    if (iter == mv->pages.end())
+        return NULL;
+
+    mv->lru.splice(mv->lru.begin(), mv->lru, iter->second->lru);
+
+    return iter->second;
+}
+
+/* Find a page in the cache, adding it if it isn't there */
+static struct memview_page *memview_get_page(struct memview *mv,
+        uint64_t addr)
+{
+    struct memview_page *page = memview_find_page(mv, addr);
+
+    if (page)
+        return page;
+
+    page = new memview_page();
+    page->fetched = 0;
+    page->stale = 0;
+    page->requested = 0;
+
+    mv->lru.push_front(memview_page_addr(addr));
+    page->lru = mv->lru.begin();
+    mv->pages[memview_page_addr(addr)] = page;
+
+    /* Drop the least recently used pages */
+    while ((int)mv->pages.size() > MEMVIEW_CACHE_PAGES) {
+        std::map<uint64_t, memview_page *>::iterator iter =
+            mv->pages.find(mv->lru.back());
+
+        delete iter->second;
+        mv->pages.erase(iter);
+        mv->lru.pop_back();
+    }
+
+    return page;
+}
+
+static void memview_clear_pages(struct memview *mv)
+{
+    std::map<uint64_t, memview_page *>::iterator iter;
+
+    for (iter = mv->pages.begin(); iter != mv->pages.end(); ++iter)
+        delete iter->second;
+
+    mv->pages.clear();
+    mv->lru.clear();
+}
+
+/* The address of the last byte on screen */
+static uint64_t memview_last_addr(struct memview *mv)
+{
+    uint64_t size = (uint64_t)pane_list_height(&mv->list) * mv->bytes_per_row;
+
+    if (UINT64_MAX - mv->top < size - 1)
+        return UINT64_MAX;
+
+    return mv->top + size - 1;
+}
+
+/* Read a run of pages */
+static void memview_request_pages(struct memview *mv, uint64_t addr,
+        int count)
+{
+    char buf[32];
+
+    snprintf(buf, sizeof(buf), "0x%" PRIx64, addr);
+    tgdb_request_read_memory(tgdb, buf, count * MEMVIEW_PAGE);
+}
+
+/* Ask gdb for the pages on screen that aren't read or are out of date,
+ * and for the pages next to them that were never read. Pages next to
+ * each other are read together. */
+static void memview_request(struct memview *mv)
+{
+    uint64_t first, last, addr, run_addr = 0;
+    uint64_t vis_first, vis_last, npages, i;
+    int run_count = 0;
+
+    if (!mv->list.win || !mv->have_base)
+        return;
+
+    vis_first = memview_page_addr(mv->top);
+    vis_last = memview_page_addr(memview_last_addr(mv));
+
+    first = vis_first >= MEMVIEW_PAGE ? vis_first - MEMVIEW_PAGE : vis_first;
+    last = vis_last <= UINT64_MAX - MEMVIEW_PAGE ?
+        vis_last + MEMVIEW_PAGE : vis_last;
+    npages = (last - first) / MEMVIEW_PAGE + 1;
+
+    for (i = 0, addr = first; i < npages; ++i, addr += MEMVIEW_PAGE) {
+        struct memview_page *page = memview_find_page(mv, addr);
+        int visible = addr >= vis_first && addr <= vis_last;
+        int wanted = !page || (!page->requested &&
+                (!page->fetched || (visible && page->stale)));
+
+        if (wanted) {
+            page = memview_get_page(mv, addr);
+            page->requested = 1;
+
+            if (run_count == 0)
+                run_addr = addr;
+            ++run_count;
+        } else if (run_count > 0) {
+            memview_request_pages(mv, run_addr, run_count);
+            run_count = 0;
+        }
+    }
+
+    if (run_count > 0)
+        memview_request_pages(mv, run_addr, run_count);
+}
+
+/* Scroll so the cursor is on a row of the window */
+static void memview_scroll_to_sel(struct memview *mv)
+{
+    uint64_t rows = pane_list_height(&mv->list);
+
+    if (mv->sel < mv->top)
+        mv->top = mv->sel;
+    else if ((mv->sel - mv->top) / mv->bytes_per_row >= rows)
+        mv->top = mv->sel - (rows - 1) * mv->bytes_per_row;
+
+    mv->list.sel_line = (mv->sel - mv->top) / mv->bytes_per_row;
+
+    memview_request(mv);
+}
+
+/* Move the cursor by delta rows, without wrapping around memory */
+static void memview_move_sel(struct memview *mv, int delta)
+{
+    uint64_t step = (uint64_t)std::abs(delta) * mv->bytes_per_row;
+    uint64_t last_row = UINT64_MAX & ~(uint64_t)(mv->bytes_per_row - 1);
+
+    if (delta < 0)
+        mv->sel = mv->sel < step ? 0 : mv->sel - step;
+    else
+        mv->sel = last_row - mv->sel < step ? last_row : mv->sel + step;
+
+    memview_scroll_to_sel(mv);
+}
+
+/* Fit the rows to the width of the window */
+static void memview_layout(struct memview *mv)
+{
+    uint64_t mask;
+
+    mv->bytes_per_row = memview_fit_bytes_per_row(mv);
+
+    mask = ~(uint64_t)(mv->bytes_per_row - 1);
+    mv->top &= mask;
+    mv->sel &= mask;
+
+    memview_scroll_to_sel(mv);
+}
+
+struct memview *memview_new(SWINDOW *win)
+{
+    struct memview *mv = new memview();
+
+    pane_list_init(&mv->list, win);
+    mv->expr_pending = 0;
+    mv->expr_error = 0;
+    mv->have_base = 0;
+    mv->base = 0;
+    mv->top = 0;
+    mv->sel = 0;
+    mv->bytes_per_row = memview_fit_bytes_per_row(mv);
+
+    return mv;
+}
+
+void memview_free(struct memview *mv)
+{
+    memview_clear_pages(mv);
+    swin_delwin(mv->list.win);
+    delete mv;
+}
+
+void memview_move(struct memview *mv, SWINDOW *win)
+{
+    pane_list_move(&mv->list, win);
+
+    if (mv->list.win)
+        memview_layout(mv);
+}
+
+void memview_set_address(struct memview *mv, const char *expr)
+{
+    mv->expr = expr;
+    mv->expr_pending = 1;
+    mv->expr_error = 0;
+    mv->have_base = 0;
+
+    /* Reading a byte says where expr is, the pages are read after */
+    tgdb_request_read_memory(tgdb, expr, 1);
+}
+
+void memview_frame_changed(struct memview *mv)
+{
+    std::map<uint64_t, memview_page *>::iterator iter;
+
+    /* The bytes that changed at the last stop aren't highlighted now, and
+     * every page is read again once it is on screen */
+    for (iter = mv->pages.begin(); iter != mv->pages.end(); ++iter) {
+        memset(iter->second->changed, 0, MEMVIEW_PAGE);
+        iter->second->stale = 1;
+    }
+
+    memview_request(mv);
+}
+
+/* Put the memory gdb read for a run of pages in the cache */
+static void memview_fill_pages(struct memview *mv, uint64_t addr, int count,
+        const std::list<tgdb_memory_block> &blocks)
+{
+    std::list<tgdb_memory_block>::const_iterator iter;
+    std::vector<memview_page *> pages;
+    int npages = count / MEMVIEW_PAGE;
+
+    for (int i = 0; i < npages; ++i) {
+        memview_page *page = memview_get_page(mv,
+                addr + (uint64_t)i * MEMVIEW_PAGE);
+
+        memcpy(page->prev_bytes, page->bytes, MEMVIEW_PAGE);
+        memcpy(page->prev_readable, page->readable, MEMVIEW_PAGE);
+        memset(page->readable, 0, MEMVIEW_PAGE);
+        pages.push_back(page);
+    }
+
+    /* The memory that couldn't be read isn't in any block */
+    for (iter = blocks.begin(); iter != blocks.end(); ++iter) {
+        for (size_t i = 0; i < iter->contents.size(); ++i) {
+            uint64_t offset = iter->begin + i - addr;
+            memview_page *page;
+
+            if (offset >= (uint64_t)npages * MEMVIEW_PAGE)
+                continue;
+
+            page = pages[offset / MEMVIEW_PAGE];
+            page->bytes[offset % MEMVIEW_PAGE] = iter->contents[i];
+            page->readable[offset % MEMVIEW_PAGE] = 1;
+        }
+    }
+
+    for (int i = 0; i < npages; ++i) {
+        memview_page *page = pages[i];
+
+        if (page->fetched) {
+            for (int j = 0; j < MEMVIEW_PAGE; ++j) {
+                if (page->readable[j] != page->prev_readable[j] ||
+                        page->bytes[j] != page->prev_bytes[j])
+                    page->changed[j] = 1;
+            }
+        } else {
+            memset(page->changed, 0, MEMVIEW_PAGE);
+        }
+
+        page->fetched = 1;
+        page->stale = 0;
+        page->requested = 0;
+    }
+}
+
+void memview_read(struct memview *mv, const std::string &addr,
+        uint64_t start, int count, int error,
+        const std::list<tgdb_memory_block> &blocks)
+{
+    /* The address the user asked for was looked up */
+    if (count == 1) {
+        if (!mv->expr_pending || addr != mv->expr)
+            return;
+
+        mv->expr_pending = 0;
+
+        if (error) {
+            mv->expr_error = 1;
+            return;
+        }
+
+        /* The program may be another one now, read everything again */
+        memview_clear_pages(mv);
+
+        mv->have_base = 1;
+        mv->base = start;
+        mv->sel = start & ~(uint64_t)(mv->bytes_per_row - 1);
+        mv->top = mv->sel;
+        memview_scroll_to_sel(mv);
+        return;
+    }
+
+    /* The pages are asked for by hex address, none of them could be read
+     * if there was an error */
+    memview_fill_pages(mv, strtoull(addr.c_str(), NULL, 16), count,
+            error ? std::list<tgdb_memory_block>() : blocks);
+}
+
+int memview_input(struct memview *mv, int key)
+{
+    int delta;
+
+    switch (pane_list_key(&mv->list, key, &delta)) {
+        case PANE_LIST_KEY_CLOSE:
+            return -1;
+        case PANE_LIST_KEY_MOVE:
+            memview_move_sel(mv, delta);
+            break;
+        case PANE_LIST_KEY_FIRST:
+            /* The address the user asked for */
+            if (mv->have_base) {
+                mv->sel = mv->base & ~(uint64_t)(mv->bytes_per_row - 1);
+                memview_scroll_to_sel(mv);
+            }
+            break;
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+/* Print as much of text as fits before width */
+static void memview_print(struct memview *mv, int *col, int width,
+        int attr, const char *text)
+{
+    int len = std::min((int)strlen(text), width - *col);
+
+    if (len <= 0)
+        return;
+
+    swin_wattron(mv->list.win, attr);
+    swin_wprintw(mv->list.win, "%.*s", len, text);
+    swin_wattroff(mv->list.win, attr);
+
+    *col += len;
+}
+
+/* Draw a row of memory, the bytes in hex and then as characters */
+static void memview_display_row(struct memview *mv, int line,
+        uint64_t addr, int focus, int width)
+{
+    int changed_attr = hl_groups_get_attr(hl_groups_instance,
+            HLG_CHANGED_VALUE);
+    struct memview_page *page = memview_find_page(mv, addr);
+    int offset = addr % MEMVIEW_PAGE;
+    char text[MEMVIEW_MAX_ROW + 1];
+    char buf[32];
+    int col = 2;
+
+    pane_list_display_cursor(&mv->list, line, focus);
+
+    snprintf(buf, sizeof(buf), "0x%016" PRIx64 "  ", addr);
+    memview_print(mv, &col, width, 0, buf);
+
+    for (int i = 0; i < mv->bytes_per_row; ++i) {
+        int attr = 0;
+
+        if (!page || !page->fetched) {
+            strcpy(buf, ".. ");
+            text[i] = ' ';
+        } else if (!page->readable[offset + i]) {
+            strcpy(buf, "?? ");
+            text[i] = ' ';
+        } else {
+            unsigned char c = page->bytes[offset + i];
+
+            snprintf(buf, sizeof(buf), "%02x ", c);
+            text[i] = (c >= 0x20 && c < 0x7f) ? c : '.';
+
+            if (page->changed[offset + i])
+                attr = changed_attr;
+        }
+
+        memview_print(mv, &col, width, attr, buf);
+    }
+
+    text[mv->bytes_per_row] = 0;
+    memview_print(mv, &col, width, 0, " ");
+    memview_print(mv, &col, width, 0, text);
+}
+
+void memview_display(struct memview *mv, int focus,
+        enum win_refresh dorefresh)
+{
+    SWINDOW *win = mv->list.win;
+    int height, width, i;
+    std::string title;
+
+    if (!win)
+        return;
+
+    height = pane_list_height(&mv->list);
+    width = swin_getmaxx(win);
+
+    if (mv->expr.empty())
+        title = "Memory: Use :memory ADDRESS";
+    else if (mv->expr_error)
+        title = "Memory: Cannot access memory at " + mv->expr;
+    else
+        title = "Memory: " + mv->expr;
+
+    pane_list_display_title(&mv->list, title.c_str());
+
+    for (i = 0; i < height; ++i) {
+        uint64_t offset = (uint64_t)i * mv->bytes_per_row;
+
+        swin_wmove(win, i + 1, 0);
+        swin_wclrtoeol(win);
+
+        if (mv->have_base && offset <= UINT64_MAX - mv->top)
+            memview_display_row(mv, i, mv->top + offset, focus, width);
+        else
+            swin_waddch(win, '~');
+    }
+
+    pane_list_refresh(&mv->list, dorefresh);
+}
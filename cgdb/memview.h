@@ -0,0 +1,102 @@
+#ifndef _MEMVIEW_H_
+#define _MEMVIEW_H_
+
+/* memview.h:
+ * ----------
+ *
+ * The memory pane shows the memory of the program in hex, starting at an
+ * address the user chose.
+ *
+ * Memory is read from gdb a page at a time, for the pages on screen and
+ * the pages next to them. The pages are kept in a cache, the least
+ * recently used pages are dropped when it is full. Scrolling back over a
+ * buffer costs nothing, and scrolling through a big one only costs the
+ * pages not read yet. After the program stops only the pages on screen
+ * are read again, and the bytes that changed are highlighted.
+ */
+
+#include <list>
+#include <string>
+
+#include "sys_win.h"
+#include "tgdb.h"
+
+struct memview;
+
+/* memview_new: Create a new memory pane.
+ * ____________
+ *
+ *   win: The window to draw in, OK to pass NULL
+ *
+ * return value: a new memory pane.
+ */
+struct memview *memview_new(SWINDOW *win);
+
+/* memview_free: Release the memory associated with a memory pane.
+ * -------------
+ *
+ *   mv: The memory pane to free.
+ */
+void memview_free(struct memview *mv);
+
+/* memview_move: Draw the memory pane in another window.
+ * -------------
+ *
+ *   mv:  The memory pane
+ *   win: The new window, the old one is deleted. OK to pass NULL.
+ *
+ * While the pane has no window, gdb isn't asked for anything.
+ */
+void memview_move(struct memview *mv, SWINDOW *win);
+
+/* memview_set_address: Show the memory at an address.
+ * --------------------
+ *
+ *   mv:   The memory pane
+ *   expr: An expression for the address, like 0x601040 or &buf
+ */
+void memview_set_address(struct memview *mv, const char *expr);
+
+/* memview_frame_changed: The program stopped, the memory may have changed.
+ * ----------------------
+ *
+ *   mv: The memory pane
+ */
+void memview_frame_changed(struct memview *mv);
+
+/* memview_read: Memory gdb read for the memory pane.
+ * -------------
+ *
+ *   mv:     The memory pane
+ *   addr:   The address expression the memory was asked for with
+ *   start:  The address addr evaluated to, when error is zero
+ *   count:  The number of bytes asked for
+ *   error:  Non-zero if none of the memory could be read
+ *   blocks: The memory that could be read
+ */
+void memview_read(struct memview *mv, const std::string &addr,
+        uint64_t start, int count, int error,
+        const std::list<tgdb_memory_block> &blocks);
+
+/* memview_input: Send a key to the memory pane.
+ * --------------
+ *
+ *   mv:  The memory pane
+ *   key: The key the user typed
+ *
+ *  returns -1 when the user closed the pane.
+ *  returns 0 when the key was handled, or not for the pane.
+ */
+int memview_input(struct memview *mv, int key);
+
+/* memview_display: Redraw the memory pane.
+ * ----------------
+ *
+ *   mv:        The memory pane
+ *   focus:     Non-zero if the pane has focus
+ *   dorefresh: How to refresh the window
+ */
+void memview_display(struct memview *mv, int focus,
+        enum win_refresh dorefresh);
+
+#endif /* _MEMVIEW_H_ */
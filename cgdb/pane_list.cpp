@@ -0,0 +1,196 @@
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <algorithm>
+
+#include "sys_util.h"
+#include "sys_win.h"
+#include "pane_list.h"
+#include "cgdb.h"
+#include "highlight_groups.h"
+#include "kui_term.h"
+
+void pane_list_init(struct pane_list *list, SWINDOW *win)
+{
+    list->win = win;
+    list->sel_line = 0;
+    list->top = 0;
+    list->last_key = 0;
+    list->stale = 1;
+    list->redraw = 1;
+    list->drawn_sel_line = 0;
+    list->drawn_focus = 0;
+}
+
+void pane_list_move(struct pane_list *list, SWINDOW *win)
+{
+    swin_delwin(list->win);
+    list->win = win;
+    list->redraw = 1;
+}
+
+int pane_list_height(struct pane_list *list)
+{
+    return list->win ? std::max(swin_getmaxy(list->win) - 1, 1) : 1;
+}
+
+int pane_list_frame_changed(struct pane_list *list)
+{
+    /* Don't ask GDB for anything unless someone is looking */
+    if (!list->win) {
+        list->stale = 1;
+        return 0;
+    }
+
+    return 1;
+}
+
+int pane_list_scroll_to_sel(struct pane_list *list, int nrows)
+{
+    int height = pane_list_height(list);
+    int top = list->top;
+
+    list->sel_line = std::min(list->sel_line, nrows - 1);
+    list->sel_line = std::max(list->sel_line, 0);
+
+    if (list->sel_line < top)
+        top = list->sel_line;
+    else if (list->sel_line >= top + height)
+        top = list->sel_line - height + 1;
+
+    /* Don't leave empty rows at the bottom when rows go away */
+    top = std::min(top, std::max(nrows - height, 0));
+
+    if (top == list->top)
+        return 0;
+
+    list->top = top;
+    list->redraw = 1;
+
+    return 1;
+}
+
+int pane_list_move_sel(struct pane_list *list, int delta, int nrows)
+{
+    list->sel_line += delta;
+
+    return pane_list_scroll_to_sel(list, nrows);
+}
+
+enum pane_list_key pane_list_key(struct pane_list *list, int key, int *delta)
+{
+    int height = pane_list_height(list);
+    int last_key = list->last_key;
+
+    list->last_key = key;
+    *delta = 0;
+
+    switch (key) {
+        case 'q':
+            return PANE_LIST_KEY_CLOSE;
+        case '\n':
+        case '\r':
+        case CGDB_KEY_CTRL_M:
+            return PANE_LIST_KEY_SELECT;
+        case CGDB_KEY_DOWN:
+        case 'j':
+            *delta = 1;
+            return PANE_LIST_KEY_MOVE;
+        case CGDB_KEY_UP:
+        case 'k':
+            *delta = -1;
+            return PANE_LIST_KEY_MOVE;
+        case CGDB_KEY_NPAGE:
+        case CGDB_KEY_CTRL_F:  /* VI-style page down */
+            *delta = height;
+            return PANE_LIST_KEY_MOVE;
+        case CGDB_KEY_PPAGE:
+        case CGDB_KEY_CTRL_B:  /* VI-style page up */
+            *delta = -height;
+            return PANE_LIST_KEY_MOVE;
+        case CGDB_KEY_CTRL_D:  /* VI-style 1/2 page down */
+            *delta = height / 2;
+            return PANE_LIST_KEY_MOVE;
+        case CGDB_KEY_CTRL_U:  /* VI-style 1/2 page up */
+            *delta = -(height / 2);
+            return PANE_LIST_KEY_MOVE;
+        case 'g':              /* beginning of pane */
+            if (last_key == 'g') {
+                list->last_key = 0;
+                return PANE_LIST_KEY_FIRST;
+            }
+            break;
+        case 'G':              /* end of pane */
+            return PANE_LIST_KEY_LAST;
+    }
+
+    return PANE_LIST_KEY_NONE;
+}
+
+enum pane_list_key pane_list_input(struct pane_list *list, int key, int nrows)
+{
+    int delta;
+    enum pane_list_key kind = pane_list_key(list, key, &delta);
+
+    if (kind == PANE_LIST_KEY_MOVE)
+        pane_list_move_sel(list, delta, nrows);
+    else if (kind == PANE_LIST_KEY_FIRST)
+        pane_list_move_sel(list, -list->sel_line, nrows);
+    else if (kind == PANE_LIST_KEY_LAST)
+        pane_list_move_sel(list, nrows, nrows);
+
+    return kind;
+}
+
+int pane_list_redraw(struct pane_list *list, int focus)
+{
+    return list->redraw || focus != list->drawn_focus;
+}
+
+int pane_list_cursor_moved(struct pane_list *list, int row)
+{
+    return row == list->sel_line || row == list->drawn_sel_line;
+}
+
+void pane_list_drawn(struct pane_list *list, int focus)
+{
+    list->redraw = 0;
+    list->drawn_sel_line = list->sel_line;
+    list->drawn_focus = focus;
+}
+
+void pane_list_display_title(struct pane_list *list, const char *title)
+{
+    int title_attr = hl_groups_get_attr(hl_groups_instance, HLG_STATUS_BAR);
+    int width = swin_getmaxx(list->win);
+
+    swin_wmove(list->win, 0, 0);
+    swin_wattron(list->win, title_attr);
+    swin_wprintw(list->win, "%-*.*s", width, width, title);
+    swin_wattroff(list->win, title_attr);
+}
+
+void pane_list_display_cursor(struct pane_list *list, int row, int focus)
+{
+    int sel_attr;
+
+    if (!focus || row != list->sel_line) {
+        swin_wprintw(list->win, "  ");
+        return;
+    }
+
+    sel_attr = hl_groups_get_attr(hl_groups_instance, HLG_SELECTED_LINE_ARROW);
+
+    swin_wattron(list->win, sel_attr);
+    swin_wprintw(list->win, "->");
+    swin_wattroff(list->win, sel_attr);
+}
+
+void pane_list_refresh(struct pane_list *list, enum win_refresh dorefresh)
+{
+    if (dorefresh == WIN_REFRESH)
+        swin_wrefresh(list->win);
+    else
+        swin_wnoutrefresh(list->win);
+}
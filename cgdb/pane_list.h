@@ -0,0 +1,172 @@
+#ifndef _PANE_LIST_H_
+#define _PANE_LIST_H_
+
+/* pane_list.h:
+ * ------------
+ *
+ * What the panes that show a list of rows under a title have in common.
+ * The backtrace, variables, registers, memory and threads panes each keep
+ * a pane_list for their window, cursor and scroll position. It moves the
+ * cursor for the keys all of them take, and draws the title and the
+ * cursor the same way in each.
+ */
+
+#include "sys_win.h"
+
+struct pane_list {
+    SWINDOW *win;               /* Curses window, NULL if hidden */
+
+    int sel_line;               /* The row the cursor is on */
+    int top;                    /* The row drawn first */
+    int last_key;               /* The last key typed, for gg */
+
+    int stale;                  /* The frame changed while hidden */
+    int redraw;                 /* Draw every row on the next display */
+    int drawn_sel_line;         /* The row the cursor was drawn on */
+    int drawn_focus;            /* If the pane had focus when drawn */
+};
+
+/* What a key typed in a pane does */
+enum pane_list_key {
+    PANE_LIST_KEY_NONE,         /* Nothing the list knows of */
+    PANE_LIST_KEY_MOVE,         /* Move the cursor by some rows */
+    PANE_LIST_KEY_FIRST,        /* Go to the first row (gg) */
+    PANE_LIST_KEY_LAST,         /* Go to the last row (G) */
+    PANE_LIST_KEY_SELECT,       /* Act on the row (Enter) */
+    PANE_LIST_KEY_CLOSE         /* Close the pane (q) */
+};
+
+/* pane_list_init: Set up a list shown in a window.
+ * ---------------
+ *
+ *   list: The list
+ *   win:  The window to draw in, OK to pass NULL
+ */
+void pane_list_init(struct pane_list *list, SWINDOW *win);
+
+/* pane_list_move: Draw the list in another window.
+ * ---------------
+ *
+ *   list: The list
+ *   win:  The new window, the old one is deleted. OK to pass NULL.
+ */
+void pane_list_move(struct pane_list *list, SWINDOW *win);
+
+/* pane_list_height: The rows of the list per window.
+ * -----------------
+ *
+ * The first line of the window is the title. This is at least 1.
+ *
+ *   list: The list
+ */
+int pane_list_height(struct pane_list *list);
+
+/* pane_list_frame_changed: The program stopped or another frame was
+ * ------------------------  selected.
+ *
+ *   list: The list
+ *
+ * GDB isn't asked for anything unless someone is looking. While the pane
+ * is hidden, it is marked stale to be refreshed when it is shown again.
+ *
+ * return value: non-zero if the pane should refresh now.
+ */
+int pane_list_frame_changed(struct pane_list *list);
+
+/* pane_list_scroll_to_sel: Scroll so the cursor is on a row of the window.
+ * ------------------------
+ *
+ *   list:  The list
+ *   nrows: The rows in the list, the cursor is kept on one of them
+ *
+ * return value: non-zero if the list scrolled.
+ */
+int pane_list_scroll_to_sel(struct pane_list *list, int nrows);
+
+/* pane_list_move_sel: Move the cursor and scroll to it.
+ * -------------------
+ *
+ *   list:  The list
+ *   delta: The rows to move by, down when positive
+ *   nrows: The rows in the list
+ *
+ * return value: non-zero if the list scrolled.
+ */
+int pane_list_move_sel(struct pane_list *list, int delta, int nrows);
+
+/* pane_list_key: Find what a key does in a list.
+ * --------------
+ *
+ *   list:  The list, it remembers the key for gg
+ *   key:   The key the user typed
+ *   delta: Set to the rows to move by for PANE_LIST_KEY_MOVE
+ */
+enum pane_list_key pane_list_key(struct pane_list *list, int key, int *delta);
+
+/* pane_list_input: Move the cursor for a key typed in a list.
+ * ----------------
+ *
+ *   list:  The list
+ *   key:   The key the user typed
+ *   nrows: The rows in the list
+ *
+ * return value: what the key does, the cursor was already moved for it.
+ */
+enum pane_list_key pane_list_input(struct pane_list *list, int key, int nrows);
+
+/* pane_list_redraw: Find out if every row is to be drawn.
+ * -----------------
+ *
+ *   list:  The list
+ *   focus: Non-zero if the pane has focus
+ *
+ * return value: non-zero if every row is to be drawn, otherwise only the
+ * rows that changed and pane_list_cursor_moved says so.
+ */
+int pane_list_redraw(struct pane_list *list, int focus);
+
+/* pane_list_cursor_moved: Find out if the cursor moved onto or off a row.
+ * -----------------------
+ *
+ *   list: The list
+ *   row:  The row
+ */
+int pane_list_cursor_moved(struct pane_list *list, int row);
+
+/* pane_list_drawn: Remember how the list was drawn.
+ * ----------------
+ *
+ *   list:  The list
+ *   focus: Non-zero if the pane had focus
+ */
+void pane_list_drawn(struct pane_list *list, int focus);
+
+/* pane_list_display_title: Draw the title on the first line of the window.
+ * ------------------------
+ *
+ *   list:  The list
+ *   title: The title
+ */
+void pane_list_display_title(struct pane_list *list, const char *title);
+
+/* pane_list_display_cursor: Draw the cursor, if it is on a row.
+ * -------------------------
+ *
+ * The cursor is an arrow, like the file dialog's. It is drawn where the
+ * window's cursor is, and takes 2 columns whether it is drawn or not.
+ *
+ *   list:  The list
+ *   row:   The row being drawn
+ *   focus: Non-zero if the pane has focus
+ */
+void pane_list_display_cursor(struct pane_list *list, int row, int focus);
+
+/* pane_list_refresh: Send the window to the screen.
+ * ------------------
+ *
+ *   list:      The list
+ *   dorefresh: How to refresh the window
+ */
+void pane_list_refresh(struct pane_list *list, enum win_refresh dorefresh);
+
+#endif /* _PANE_LIST_H_ */
@@ -0,0 +1,319 @@
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "sys_util.h"
+#include "sys_win.h"
+#include "registers.h"
+#include "pane_list.h"
+#include "cgdb.h"
+#include "highlight_groups.h"
+
+extern struct tgdb *tgdb;
+
+struct reg {
+    int number;                 /* The number GDB knows the register by */
+    std::string name;
+    std::string value;          /* Empty until the value is gotten */
+
+    int fetched;                /* Non-zero if the value is up to date */
+    int requested;              /* Non-zero while the value is asked for */
+    int changed;                /* Non-zero if it changed at the last stop */
+    int dirty;                  /* Non-zero if its row needs drawing */
+};
+
+/* The names haven't been asked for, are being asked for, or are known */
+enum names_state { NAMES_NONE, NAMES_REQUESTED, NAMES_KNOWN };
+
+struct registers {
+    /* The window, cursor and scroll position, a row per register */
+    struct pane_list list;
+
+    /* The registers, in the order GDB numbers them */
+    std::vector<reg> regs;
+
+    /* The index into regs of each register number */
+    std::map<int, int> by_number;
+
+    enum names_state names;
+    int name_width;             /* The width of the longest name */
+    int error;                  /* Non-zero if there are no registers */
+};
+
+static struct reg *registers_find(struct registers *regs, int number)
+{
+    std::map<int, int>::iterator iter = regs->by_number.find(number);
+
+    return iter != regs->by_number.end() ? &regs->regs[iter->second] : NULL;
+}
+
+/* Ask GDB for the values that are out of date on screen, and on the next
+ * window, so scrolling a page doesn't show unknown values */
+static void registers_request(struct registers *regs)
+{
+    std::list<int> numbers;
+    int end;
+
+    if (!regs->list.win || regs->names != NAMES_KNOWN || regs->error)
+        return;
+
+    end = std::min(regs->list.top + pane_list_height(&regs->list) * 2,
+            (int)regs->regs.size());
+
+    for (int i = regs->list.top; i < end; ++i) {
+        struct reg *r = &regs->regs[i];
+
+        if (!r->fetched && !r->requested) {
+            r->requested = 1;
+            numbers.push_back(r->number);
+        }
+    }
+
+    tgdb_request_register_values(tgdb, numbers);
+}
+
+static void registers_scroll_to_sel(struct registers *regs)
+{
+    if (pane_list_scroll_to_sel(&regs->list, regs->regs.size()))
+        registers_request(regs);
+}
+
+/* Bring the registers up to date */
+static void registers_refresh(struct registers *regs)
+{
+    regs->list.stale = 0;
+
+    /* The registers that changed at the last stop aren't highlighted now */
+    for (size_t i = 0; i < regs->regs.size(); ++i) {
+        if (regs->regs[i].changed) {
+            regs->regs[i].changed = 0;
+            regs->regs[i].dirty = 1;
+        }
+    }
+
+    if (regs->names == NAMES_NONE) {
+        regs->names = NAMES_REQUESTED;
+        tgdb_request_register_names(tgdb);
+    }
+
+    /* The first time, this only sets where GDB counts changes from */
+    tgdb_request_changed_registers(tgdb);
+}
+
+struct registers *registers_new(SWINDOW *win)
+{
+    struct registers *regs = new registers();
+
+    pane_list_init(&regs->list, win);
+    regs->names = NAMES_NONE;
+    regs->name_width = 0;
+    regs->error = 0;
+
+    return regs;
+}
+
+void registers_free(struct registers *regs)
+{
+    swin_delwin(regs->list.win);
+    delete regs;
+}
+
+void registers_move(struct registers *regs, SWINDOW *win)
+{
+    pane_list_move(&regs->list, win);
+
+    if (regs->list.win) {
+        registers_scroll_to_sel(regs);
+
+        if (regs->list.stale)
+            registers_refresh(regs);
+        else
+            registers_request(regs);
+    }
+}
+
+void registers_invalidate(struct registers *regs)
+{
+    regs->list.redraw = 1;
+}
+
+void registers_frame_changed(struct registers *regs)
+{
+    if (pane_list_frame_changed(&regs->list))
+        registers_refresh(regs);
+}
+
+void registers_set_names(struct registers *regs, int error,
+        const std::list<tgdb_register> &registers)
+{
+    std::list<tgdb_register>::const_iterator iter;
+
+    if (error) {
+        /* Asked for again the next time the pane is refreshed */
+        regs->names = NAMES_NONE;
+        return;
+    }
+
+    regs->regs.clear();
+    regs->by_number.clear();
+    regs->name_width = 0;
+
+    for (iter = registers.begin(); iter != registers.end(); ++iter) {
+        struct reg r;
+
+        r.number = iter->number;
+        r.name = iter->name;
+        r.fetched = 0;
+        r.requested = 0;
+        r.changed = 0;
+        r.dirty = 1;
+
+        regs->by_number[r.number] = regs->regs.size();
+        regs->regs.push_back(r);
+        regs->name_width = std::max(regs->name_width, (int)r.name.size());
+    }
+
+    regs->names = NAMES_KNOWN;
+    regs->list.redraw = 1;
+
+    registers_scroll_to_sel(regs);
+    registers_request(regs);
+}
+
+void registers_changed(struct registers *regs, int error,
+        const std::list<int> &numbers)
+{
+    std::list<int>::const_iterator iter;
+
+    if (error) {
+        /* The program isn't running */
+        if (!regs->error)
+            regs->list.redraw = 1;
+        regs->error = 1;
+        return;
+    }
+
+    if (regs->error)
+        regs->list.redraw = 1;
+    regs->error = 0;
+
+    /* Only the values that were gotten before need getting again, the
+     * others are gotten when they are scrolled to */
+    for (iter = numbers.begin(); iter != numbers.end(); ++iter) {
+        struct reg *r = registers_find(regs, *iter);
+
+        if (r && r->fetched) {
+            r->fetched = 0;
+            r->changed = 1;
+            r->dirty = 1;
+        }
+    }
+
+    registers_request(regs);
+}
+
+void registers_set_values(struct registers *regs, int error,
+        const std::list<tgdb_register> &registers)
+{
+    std::list<tgdb_register>::const_iterator iter;
+
+    if (error) {
+        /* Asked for again after the program stops */
+        for (size_t i = 0; i < regs->regs.size(); ++i)
+            regs->regs[i].requested = 0;
+        return;
+    }
+
+    for (iter = registers.begin(); iter != registers.end(); ++iter) {
+        struct reg *r = registers_find(regs, iter->number);
+
+        if (r) {
+            r->value = iter->value;
+            r->fetched = 1;
+            r->requested = 0;
+            r->dirty = 1;
+        }
+    }
+}
+
+int registers_input(struct registers *regs, int key)
+{
+    if (pane_list_input(&regs->list, key, regs->regs.size()) ==
+            PANE_LIST_KEY_CLOSE)
+        return -1;
+
+    registers_request(regs);
+
+    return 0;
+}
+
+/* Draw a row of the pane */
+static void registers_display_row(struct registers *regs, int line,
+        int row, int focus, int width)
+{
+    SWINDOW *win = regs->list.win;
+    int changed_attr = hl_groups_get_attr(hl_groups_instance,
+            HLG_CHANGED_VALUE);
+    int vwidth = std::max(width - regs->name_width - 3, 0);
+    struct reg *r;
+
+    swin_wmove(win, line, 0);
+    swin_wclrtoeol(win);
+
+    if (row >= (int)regs->regs.size()) {
+        swin_waddch(win, '~');
+        return;
+    }
+
+    pane_list_display_cursor(&regs->list, row, focus);
+
+    r = &regs->regs[row];
+    r->dirty = 0;
+
+    swin_wprintw(win, "%-*.*s ", regs->name_width,
+            std::max(width - 3, 0), r->name.c_str());
+
+    /* Only the value is highlighted */
+    if (r->changed)
+        swin_wattron(win, changed_attr);
+    swin_wprintw(win, "%.*s", vwidth,
+            r->value.empty() ? "..." : r->value.c_str());
+    if (r->changed)
+        swin_wattroff(win, changed_attr);
+}
+
+void registers_display(struct registers *regs, int focus,
+        enum win_refresh dorefresh)
+{
+    int height, width, i;
+    int redraw;
+
+    if (!regs->list.win)
+        return;
+
+    height = pane_list_height(&regs->list);
+    width = swin_getmaxx(regs->list.win);
+
+    redraw = pane_list_redraw(&regs->list, focus);
+
+    if (redraw)
+        pane_list_display_title(&regs->list,
+                regs->error ? "Registers: No registers." : "Registers");
+
+    /* Only the rows that changed are formatted again */
+    for (i = 0; i < height; ++i) {
+        int row = regs->list.top + i;
+
+        if (redraw || pane_list_cursor_moved(&regs->list, row) ||
+                (row < (int)regs->regs.size() && regs->regs[row].dirty))
+            registers_display_row(regs, i + 1, row, focus, width);
+    }
+
+    pane_list_drawn(&regs->list, focus);
+    pane_list_refresh(&regs->list, dorefresh);
+}
@@ -0,0 +1,115 @@
+#ifndef _REGISTERS_H_
+#define _REGISTERS_H_
+
+/* registers.h:
+ * ------------
+ *
+ * The registers pane shows the registers of the selected frame.
+ *
+ * The register names are asked for once. After the program stops, GDB is
+ * only asked which registers changed, and only the values of those that
+ * are on screen are asked for again. Stepping through code that uses
+ * hundreds of vector registers doesn't print the whole register file on
+ * every step, and only the rows that changed are drawn again.
+ */
+
+#include <list>
+
+#include "sys_win.h"
+#include "tgdb.h"
+
+struct registers;
+
+/* registers_new: Create a new registers pane.
+ * ______________
+ *
+ *   win: The window to draw in, OK to pass NULL
+ *
+ * return value: a new registers pane.
+ */
+struct registers *registers_new(SWINDOW *win);
+
+/* registers_free: Release the memory associated with a registers pane.
+ * ---------------
+ *
+ *   regs: The registers pane to free.
+ */
+void registers_free(struct registers *regs);
+
+/* registers_move: Draw the registers pane in another window.
+ * ---------------
+ *
+ *   regs: The registers pane
+ *   win:  The new window, the old one is deleted. OK to pass NULL.
+ *
+ * While the pane has no window, GDB isn't asked for anything. The
+ * registers are brought up to date when it gets a window again.
+ */
+void registers_move(struct registers *regs, SWINDOW *win);
+
+/* registers_invalidate: Draw every row the next time the pane is displayed.
+ * ---------------------
+ *
+ *   regs: The registers pane
+ */
+void registers_invalidate(struct registers *regs);
+
+/* registers_frame_changed: The program stopped or another frame was selected.
+ * ------------------------
+ *
+ *   regs: The registers pane
+ */
+void registers_frame_changed(struct registers *regs);
+
+/* registers_set_names: Set the names of the registers.
+ * --------------------
+ *
+ *   regs:      The registers pane
+ *   error:     Non-zero if gdb couldn't list the registers
+ *   registers: The registers, by number
+ */
+void registers_set_names(struct registers *regs, int error,
+        const std::list<tgdb_register> &registers);
+
+/* registers_changed: The registers that changed since they were last listed.
+ * ------------------
+ *
+ *   regs:    The registers pane
+ *   error:   Non-zero if gdb couldn't list them, there are no registers
+ *   numbers: The numbers of the registers that changed
+ */
+void registers_changed(struct registers *regs, int error,
+        const std::list<int> &numbers);
+
+/* registers_set_values: Set the values of registers.
+ * ---------------------
+ *
+ *   regs:      The registers pane
+ *   error:     Non-zero if gdb couldn't get the values
+ *   registers: The registers, with their values
+ */
+void registers_set_values(struct registers *regs, int error,
+        const std::list<tgdb_register> &registers);
+
+/* registers_input: Send a key to the registers pane.
+ * ----------------
+ *
+ *   regs: The registers pane
+ *   key:  The key the user typed
+ *
+ *  returns -1 when the user closed the pane.
+ *  returns 0 when the key was handled, or not for the pane.
+ */
+int registers_input(struct registers *regs, int key);
+
+/* registers_display: Redraw the rows of the registers pane that changed.
+ * ------------------
+ *
+ *   regs:      The registers pane
+ *   focus:     Non-zero if the pane has focus
+ *   dorefresh: How to refresh the window
+ */
+void registers_display(struct registers *regs, int focus,
+        enum win_refresh dorefresh);
+
+#endif /* _REGISTERS_H_ */
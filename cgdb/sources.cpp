@@ -40,6 +40,14 @@
 #include <unistd.h>
 #endif /* HAVE_UNISTD_H */
 
+#if HAVE_SYS_INOTIFY_H
+#include <sys/inotify.h>
+#endif
+
+#if HAVE_ERRNO_H
+#include <errno.h>
+#endif
+
 #if HAVE_CTYPE_H
 #include <ctype.h>
 #endif
@@ -49,6 +57,8 @@
 #endif
 
 #include <algorithm>
+#include <climits>
+#include <iterator>
 
 /* Local Includes */
 #include "sys_util.h"
@@ -289,14 +299,75 @@ static int load_file_buf(struct buffer *buf, const char *filename)
     return ret;
 }
 
+/* Seconds a loaded file is trusted before stat'ing again. Watched files
+ * are stat'd too, since inotify misses changes made over NFS and other
+ * network filesystems. */
+#define SOURCE_STAT_INTERVAL 2
+
+/**
+ * Start watching a node's file for changes, if it can be watched.
+ *
+ * \param sview
+ * The source viewer object
+ *
+ * \param node
+ * The node whose file was just loaded
+ */
+static void source_watch_node(struct sviewer *sview, struct list_node *node)
+{
+    node->watch_dirty = false;
+    node->watch_checked = time(NULL);
+
+#if HAVE_SYS_INOTIFY_H
+    if (sview->watch_fd != -1 && node->watch_wd == -1 &&
+        node->path[0] != '*') {
+        node->watch_wd = inotify_add_watch(sview->watch_fd, node->path,
+                IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+        if (node->watch_wd == -1)
+            clog_info(CLOG_CGDB, "can't watch %s: %s", node->path,
+                    strerror(errno));
+    }
+#endif
+}
+
+/**
+ * Stop watching a node's file for changes.
+ *
+ * \param sview
+ * The source viewer object
+ *
+ * \param node
+ * The node to stop watching
+ */
+static void source_unwatch_node(struct sviewer *sview, struct list_node *node)
+{
+#if HAVE_SYS_INOTIFY_H
+    struct list_node *cur;
+
+    if (node->watch_wd == -1)
+        return;
+
+    /* Paths to the same file share the watch, it's removed with the last */
+    for (cur = sview->list_head; cur; cur = cur->next) {
+        if (cur != node && cur->watch_wd == node->watch_wd)
+            break;
+    }
+
+    if (!cur)
+        inotify_rm_watch(sview->watch_fd, node->watch_wd);
+#endif
+    node->watch_wd = -1;
+}
+
 /* load_file:  Loads the file in the list_node into its memory buffer.
  * ----------
  *
+ *   sview: The source viewer object, to watch the file with
  *   node:  The list node to work on
  *
  * Return Value:  Zero on success, non-zero on error.
  */
-static int load_file(struct list_node *node)
+static int load_file(struct sviewer *sview, struct list_node *node)
 {
     /* No node pointer? */
     if (!node)
@@ -311,6 +382,8 @@ static int load_file(struct list_node *node)
     if (get_timestamp(node->path, &(node->last_modification)) == -1)
         return -1;
 
+    source_watch_node(sview, node);
+
     node->language = tokenizer_get_default_file_type(strrchr(node->path, '.'));
 
     /* Add the highlighted lines */
@@ -468,10 +541,12 @@ struct sviewer *source_new(SWINDOW *win)
     struct sviewer *rv;
 
     /* Allocate a new structure */
-    rv = (struct sviewer *)cgdb_malloc(sizeof (struct sviewer));
+    rv = new sviewer;
 
     /* Initialize the structure */
     rv->win = win;
+    if (win)
+        swin_idlok(win, 1);
     rv->cur = NULL;
     rv->cur_exe = NULL;
     rv->list_head = NULL;
@@ -486,6 +561,18 @@ struct sviewer *source_new(SWINDOW *win)
     rv->hlregex = NULL;
     rv->last_hlregex = NULL;
 
+    rv->frame_top = 0;
+    rv->frame_cury = 0;
+    rv->frame_curx = 0;
+
+#if HAVE_SYS_INOTIFY_H
+    rv->watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (rv->watch_fd == -1)
+        clog_info(CLOG_CGDB, "inotify_init1 failed: %s", strerror(errno));
+#else
+    rv->watch_fd = -1;
+#endif
+
     return rv;
 }
 
@@ -510,6 +597,13 @@ struct list_node *source_add(struct sviewer *sview, const char *path)
     new_node->language = TOKENIZER_LANGUAGE_UNKNOWN;
     new_node->addr_start = 0;
     new_node->addr_end = 0;
+    new_node->disasm_window = false;
+    new_node->disasm_loading = false;
+    new_node->disasm_head_done = false;
+    new_node->disasm_tail_done = false;
+    new_node->watch_wd = -1;
+    new_node->watch_dirty = false;
+    new_node->watch_checked = 0;
 
     /* Initialize all local marks to -1 */
     memset(new_node->local_marks, 0xff, sizeof(new_node->local_marks));
@@ -527,29 +621,144 @@ struct list_node *source_add(struct sviewer *sview, const char *path)
     return new_node;
 }
 
-void source_add_disasm_line(struct list_node *node, const char *line)
+void source_add_disasm_line(struct list_node *node,
+        const tgdb_disasm_line &line)
 {
-    uint64_t addr = 0;
     struct source_line sline;
-    char *colon = 0, colon_char = 0;
 
-    sline.line = detab_buffer_str(line, node->file_buf.tabstop);
+    sline.line = detab_buffer_str(line.text, node->file_buf.tabstop);
+
+    node->file_buf.addrs.push_back(line.addr);
+    node->file_buf.lines.push_back(sline);
+    node->lflags.emplace_back();
+}
+
+/* Move the lines of a node that refer to its lines down by count */
+static void source_shift_lines(struct sviewer *sview, struct list_node *node,
+        int count)
+{
+    int i;
+
+    node->sel_line += count;
+    node->sel_rline += count;
+    if (node->exe_line >= 0)
+        node->exe_line += count;
 
-    colon = strchr((char*)line, ':');
-    if (colon) {
-        colon_char = *colon;
-        *colon = 0;
+    for (i = 0; i < MARK_COUNT; ++i) {
+        if (node->local_marks[i] >= 0)
+            node->local_marks[i] += count;
+        if (sview->global_marks[i].node == node)
+            sview->global_marks[i].line += count;
     }
 
-    cgdb_hexstr_to_u64(line, &addr);
+    if (sview->jump_back_mark.node == node)
+        sview->jump_back_mark.line += count;
+}
+
+int source_merge_disasm(struct sviewer *sview, struct list_node *node,
+        const std::list<tgdb_disasm_line> &disasm)
+{
+    struct buffer *buf = &node->file_buf;
+    std::vector<source_line> head, tail;
+    std::vector<uint64_t> head_addrs, tail_addrs;
+    bool empty = buf->addrs.empty();
+    bool head_aligned = false;
 
-    if (colon) {
-        *colon = colon_char;
+    for (const auto &iter : disasm) {
+        uint64_t addr = iter.addr;
+        struct source_line sline;
+
+        if (!addr)
+            continue;
+
+        if (!empty && addr == buf->addrs.front())
+            head_aligned = true;
+
+        /* Skip what the node has and anything out of order */
+        if (!empty && addr >= buf->addrs.front() && addr <= buf->addrs.back())
+            continue;
+
+        sline.line = detab_buffer_str(iter.text, buf->tabstop);
+        if ((int)sline.line.size() > buf->max_width)
+            buf->max_width = sline.line.size();
+
+        if (!empty && addr < buf->addrs.front()) {
+            if (!head_addrs.empty() && addr <= head_addrs.back())
+                continue;
+            head_addrs.push_back(addr);
+            head.push_back(std::move(sline));
+        } else {
+            if (!tail_addrs.empty() && addr <= tail_addrs.back())
+                continue;
+            tail_addrs.push_back(addr);
+            tail.push_back(std::move(sline));
+        }
     }
 
-    node->file_buf.addrs.push_back(addr);
-    node->file_buf.lines.push_back(sline);
-    node->lflags.emplace_back();
+    /* When disassembling backwards, gdb may start part way through an
+     * instruction. Unless it got back in step by the node's first
+     * instruction, the last instruction before it overlaps it. */
+    if (!head.empty() && !head_aligned) {
+        head.pop_back();
+        head_addrs.pop_back();
+    }
+
+    if (!head.empty()) {
+        buf->lines.insert(buf->lines.begin(),
+                std::make_move_iterator(head.begin()),
+                std::make_move_iterator(head.end()));
+        buf->addrs.insert(buf->addrs.begin(),
+                head_addrs.begin(), head_addrs.end());
+        node->lflags.insert(node->lflags.begin(), head.size(), line_flags());
+        source_shift_lines(sview, node, head.size());
+    }
+
+    if (!tail.empty()) {
+        buf->lines.insert(buf->lines.end(),
+                std::make_move_iterator(tail.begin()),
+                std::make_move_iterator(tail.end()));
+        buf->addrs.insert(buf->addrs.end(),
+                tail_addrs.begin(), tail_addrs.end());
+        node->lflags.resize(buf->lines.size());
+    }
+
+    if (!buf->addrs.empty()) {
+        node->addr_start = buf->addrs.front();
+        node->addr_end = buf->addrs.back();
+    }
+
+    return head.size() + tail.size();
+}
+
+int source_disasm_wants(struct sviewer *sview, uint64_t *start, uint64_t *end)
+{
+    struct list_node *node = sview->cur;
+    int height, count;
+
+    if (!node || !node->disasm_window || node->disasm_loading ||
+        node->file_buf.addrs.empty())
+        return 0;
+
+    height = swin_getmaxy(sview->win);
+    count = node->file_buf.addrs.size();
+
+    if (!node->disasm_tail_done && node->sel_line + height >= count) {
+        /* The window starts with the last instruction loaded, which
+         * is skipped when merged, so an empty window is the end */
+        *start = node->addr_end;
+        *end = node->addr_end + DISASM_WINDOW_BYTES;
+    } else if (!node->disasm_head_done && node->sel_line < height) {
+        /* Include the first instruction loaded, to know if gdb got back
+         * in step with the instructions already loaded */
+        *start = node->addr_start > DISASM_WINDOW_BYTES ?
+                node->addr_start - DISASM_WINDOW_BYTES : 0;
+        *end = node->addr_start + 1;
+    } else {
+        return 0;
+    }
+
+    node->disasm_loading = true;
+    return 1;
 }
 
 int source_del(struct sviewer *sview, const char *path)
@@ -570,6 +779,7 @@ int source_del(struct sviewer *sview, const char *path)
 
     /* Release file buffers */
     release_file_buffer(&cur->file_buf);
+    source_unwatch_node(sview, cur);
 
     /* Release file name */
     free(cur->path);
@@ -584,6 +794,9 @@ int source_del(struct sviewer *sview, const char *path)
     /* Free the node */
     delete cur;
 
+    if (sview->frame.node == cur)
+        source_invalidate(sview);
+
     /* Free any global marks pointing to this bugger */
     for (i = 0; i < sizeof(sview->global_marks) / sizeof(sview->global_marks[0]); i++) {
         if (sview->global_marks[i].node == cur)
@@ -598,7 +811,7 @@ int source_length(struct sviewer *sview, const char *path)
     struct list_node *cur = source_get_node(sview, path);
 
     /* Load the file if it's not already */
-    if (load_file(cur))
+    if (load_file(sview, cur))
         return -1;
 
     return cur->file_buf.lines.size();
@@ -773,6 +986,9 @@ int source_display(struct sviewer *sview, int focus,
     int exe_block_attr, sel_block_attr;
     char fmt[16];
     int width, height;
+    sviewer_frame frame;
+    int redraw_all;
+    int last_row_drawn = 0;
     int focus_attr = focus ? SWIN_A_BOLD : 0;
     int showmarks = cgdbrc_get_int(CGDBRC_SHOWMARKS);
     int hlsearch = cgdbrc_get_int(CGDBRC_HLSEARCH);
@@ -785,6 +1001,7 @@ int source_display(struct sviewer *sview, int focus,
     /* Check that a file is loaded */
     if (!sview->cur || sview->cur->file_buf.lines.size() == 0) {
         logo_display(sview->win);
+        source_invalidate(sview);
 
         if (dorefresh == WIN_REFRESH)
             swin_wrefresh(sview->win);
@@ -846,6 +1063,55 @@ int source_display(struct sviewer *sview, int focus,
             line = 0;
     }
 
+    /* Determine if the rows already in the window can be reused.
+     * While an incremental search is in progress, the matches can
+     * change on every row, so the window is always drawn in full. */
+    frame.node = sview->cur;
+    frame.last_modification = sview->cur->last_modification;
+    frame.tabstop = sview->cur->file_buf.tabstop;
+    frame.language = sview->cur->file_buf.language;
+    frame.count = count;
+    frame.width = width;
+    frame.height = height;
+    frame.sel_col = sview->cur->sel_col;
+    frame.focus = focus;
+    frame.showmarks = showmarks;
+    frame.exe_display_style = exe_display_style;
+    frame.sel_display_style = sel_display_style;
+    frame.do_hlsearch = do_hlsearch;
+    frame.last_hlregex = sview->last_hlregex;
+
+    redraw_all = sview->hlregex || (int)sview->rows.size() != height ||
+        !(frame == sview->frame) ||
+        abs(line - sview->frame_top) >= height;
+
+    if (redraw_all) {
+        sview->frame = frame;
+        sview->rows.assign(height, sviewer_row());
+    } else if (line != sview->frame_top) {
+        /* Shift the rows on the screen, so that only the rows exposed
+         * by the scroll have to be drawn. The exposed rows are marked
+         * as unknown so that they fail the comparison below. */
+        int delta = line - sview->frame_top;
+        sviewer_row unknown;
+
+        unknown.line = INT_MIN;
+
+        swin_scrollok(sview->win, 1);
+        swin_wscrl(sview->win, delta);
+        swin_scrollok(sview->win, 0);
+
+        if (delta > 0) {
+            sview->rows.erase(sview->rows.begin(),
+                sview->rows.begin() + delta);
+            sview->rows.insert(sview->rows.end(), delta, unknown);
+        } else {
+            sview->rows.erase(sview->rows.end() + delta, sview->rows.end());
+            sview->rows.insert(sview->rows.begin(), -delta, unknown);
+        }
+    }
+    sview->frame_top = line;
+
     /* Print 'height' lines of the file, starting at 'line' */
     lwidth = log10_uint(count) + 1;
     snprintf(fmt, sizeof(fmt), "%%%dd", lwidth);
@@ -860,6 +1126,22 @@ int source_display(struct sviewer *sview, int focus,
         struct source_line *sline = (line < 0 || line >= count)?
             NULL:&sview->cur->file_buf.lines[line];
         std::vector<hl_line_attr> printline_attrs; 
+        sviewer_row row;
+
+        /* Skip the row if it already displays exactly this */
+        if (sline) {
+            row.line = line;
+            row.is_sel = is_sel_line;
+            row.is_exe = is_exe_line;
+            row.breakpt = sview->cur->lflags[line].breakpt;
+            if (showmarks)
+                row.mark = source_get_mark_char(sview, sview->cur, line);
+        }
+
+        if (!redraw_all && row == sview->rows[i])
+            continue;
+        sview->rows[i] = row;
+        last_row_drawn = (i == height - 1);
 
         if (sline) {
             printline_attrs = sline->attrs;
@@ -1052,6 +1334,14 @@ int source_display(struct sviewer *sview, int focus,
         }
     }
 
+    /* Leave the cursor where a full draw would have left it */
+    if (last_row_drawn) {
+        sview->frame_cury = swin_getcury(sview->win);
+        sview->frame_curx = swin_getcurx(sview->win);
+    } else {
+        swin_wmove(sview->win, sview->frame_cury, sview->frame_curx);
+    }
+
     switch(dorefresh) {
         case WIN_NO_REFRESH:
             swin_wnoutrefresh(sview->win);
@@ -1064,10 +1354,19 @@ int source_display(struct sviewer *sview, int focus,
     return 0;
 }
 
+void source_invalidate(struct sviewer *sview)
+{
+    sview->frame = sviewer_frame();
+    sview->rows.clear();
+}
+
 void source_move(struct sviewer *sview, SWINDOW *win)
 {
     swin_delwin(sview->win);
     sview->win = win;
+    if (win)
+        swin_idlok(win, 1);
+    source_invalidate(sview);
 }
 
 static int clamp_line(struct sviewer *sview, int line)
@@ -1138,7 +1437,16 @@ static struct list_node *source_get_asmnode(struct sviewer *sview,
         }
     }
 
-    if (node && line)
+    if (node && line && node->disasm_window)
+    {
+        /* The addresses are sorted, find the instruction holding addr */
+        const std::vector<uint64_t> &addrs = node->file_buf.addrs;
+        auto iter = std::upper_bound(addrs.begin(), addrs.end(), addr);
+
+        if (iter != addrs.begin())
+            *line = iter - addrs.begin() - 1;
+    }
+    else if (node && line)
     {
         int i;
 
@@ -1173,7 +1481,7 @@ int source_set_exec_line(struct sviewer *sview, const char *path, int sel_line,
     }
 
     /* Buffer the file if it's not already */
-    if (load_file(sview->cur))
+    if (load_file(sview, sview->cur))
         return 4;
 
     /* Update line, if set */
@@ -1222,7 +1530,11 @@ void source_free(struct sviewer *sview)
     swin_delwin(sview->win);
     sview->win = NULL;
 
-    free(sview);
+    if (sview->watch_fd != -1)
+        close(sview->watch_fd);
+    sview->watch_fd = -1;
+
+    delete sview;
 }
 
 void source_search_regex_init(struct sviewer *sview)
@@ -1338,7 +1650,7 @@ void source_set_breakpoints(struct sviewer *sview,
     for (auto iter : breakpoints) {
         if (iter.path.size() > 0) {
             node = source_get_node(sview, iter.path.c_str());
-            if (!load_file(node)) {
+            if (!load_file(sview, node)) {
                 int line = iter.line;
                 int enabled = iter.enabled;
                 if (line > 0 && line <= node->lflags.size()) {
@@ -1360,6 +1672,44 @@ void source_set_breakpoints(struct sviewer *sview,
     }
 }
 
+void source_watch_read(struct sviewer *sview)
+{
+#if HAVE_SYS_INOTIFY_H
+    char buf[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    ssize_t len;
+
+    if (sview->watch_fd == -1)
+        return;
+
+    while ((len = read(sview->watch_fd, buf, sizeof(buf))) > 0) {
+        const struct inotify_event *event;
+        char *ptr;
+
+        for (ptr = buf; ptr < buf + len;
+                ptr += sizeof(struct inotify_event) + event->len) {
+            struct list_node *node;
+
+            event = (const struct inotify_event *)ptr;
+
+            /* Paths to the same file share the watch */
+            for (node = sview->list_head; node; node = node->next) {
+                if (node->watch_wd != event->wd)
+                    continue;
+
+                node->watch_dirty = true;
+
+                /* The kernel has removed the watch */
+                if (event->mask & (IN_IGNORED | IN_DELETE_SELF))
+                    node->watch_wd = -1;
+            }
+        }
+    }
+
+    if (len == -1 && errno != EAGAIN && errno != EINTR)
+        clog_error(CLOG_CGDB, "inotify read failed: %s", strerror(errno));
+#endif
+}
+
 int source_reload(struct sviewer *sview, const char *path, int force)
 {
     time_t timestamp;
@@ -1370,9 +1720,6 @@ int source_reload(struct sviewer *sview, const char *path, int force)
     if (!path)
         return -1;
 
-    if (get_timestamp(path, &timestamp) == -1)
-        return -1;
-
     /* Find the target node */
     for (cur = sview->list_head; cur != NULL; cur = cur->next) {
         if (strcmp(path, cur->path) == 0)
@@ -1380,19 +1727,37 @@ int source_reload(struct sviewer *sview, const char *path, int force)
         prev = cur;
     }
 
+    /* A loaded file is only stat'd if it may have changed. That is when
+     * a change to it was seen, or when it hasn't been checked for a while. */
+    if (!force && cur && cur->file_buf.lines.size() > 0 && !cur->watch_dirty &&
+        cgdbrc_get_int(CGDBRC_TABSTOP) == cur->file_buf.tabstop &&
+        time(NULL) - cur->watch_checked < SOURCE_STAT_INTERVAL)
+        return 0;
+
+    if (get_timestamp(path, &timestamp) == -1)
+        return -1;
+
     if (cur == NULL)
         return 1;               /* Node not found */
 
+    cur->watch_checked = time(NULL);
+
     /* If the file timestamp or tab size changed, reload the file */
     int dirty = cur->last_modification < timestamp;
     dirty |= cgdbrc_get_int(CGDBRC_TABSTOP) != cur->file_buf.tabstop;
 
+    /* The file may have been replaced, watch the one at the path now */
+    if (cur->watch_dirty) {
+        source_unwatch_node(sview, cur);
+        source_watch_node(sview, cur);
+    }
+
     if ((auto_source_reload || force) && dirty) {
 
         if (release_file_memory(cur) == -1)
             return -1;
 
-        if (load_file(cur))
+        if (load_file(sview, cur))
             return -1;
     }
 
@@ -31,6 +31,9 @@
 /* Count of marks */
 #define MARK_COUNT      26
 
+/* Bytes of memory disassembled at a time for a windowed disassembly */
+#define DISASM_WINDOW_BYTES 1024
+
 /* --------------- */
 /* Data Structures */
 /* --------------- */
@@ -41,6 +44,67 @@ struct sviewer_mark {
     int line;
 };
 
+struct line_flags {
+    enum class breakpt_status{ none, enabled, disabled };
+    breakpt_status breakpt = breakpt_status::none;
+    std::list<unsigned char> marks;
+};
+
+/**
+ * What the source viewer drew on a single row of its window.
+ *
+ * Two rows that compare equal produce the same output, so a row that
+ * was scrolled into place does not have to be drawn again.
+ */
+struct sviewer_row {
+    int line = -1;             /* Line displayed, or -1 for a ~ row */
+    bool is_sel = false;       /* Selected line marker was drawn */
+    bool is_exe = false;       /* Executing line marker was drawn */
+    line_flags::breakpt_status breakpt = line_flags::breakpt_status::none;
+    int mark = 0;              /* Mark character drawn, or 0 */
+
+    bool operator==(const sviewer_row &rhs) const {
+        return line == rhs.line && is_sel == rhs.is_sel &&
+               is_exe == rhs.is_exe && breakpt == rhs.breakpt &&
+               mark == rhs.mark;
+    }
+};
+
+/**
+ * The state that every row of the source window depends on.
+ *
+ * If any of this changes between two calls to source_display, the
+ * whole window has to be drawn again.
+ */
+struct sviewer_frame {
+    struct list_node *node = NULL;  /* Node displayed */
+    time_t last_modification = 0;   /* The node's timestamp when drawn */
+    int tabstop = 0;                /* The node's tabstop when drawn */
+    int language = 0;               /* The node's language when drawn */
+    int count = 0;                  /* Number of lines in the node */
+    int width = 0, height = 0;      /* Size of the window */
+    int sel_col = 0;                /* Horizontal scroll position */
+    int focus = 0;                  /* If the window had focus */
+    int showmarks = 0;              /* The showmarks option */
+    int exe_display_style = 0;      /* The executinglinedisplay option */
+    int sel_display_style = 0;      /* The selectedlinedisplay option */
+    int do_hlsearch = 0;            /* If search matches were highlighted */
+    struct hl_regex_info *last_hlregex = NULL; /* The highlighted search */
+
+    bool operator==(const sviewer_frame &rhs) const {
+        return node == rhs.node &&
+               last_modification == rhs.last_modification &&
+               tabstop == rhs.tabstop && language == rhs.language &&
+               count == rhs.count && width == rhs.width &&
+               height == rhs.height && sel_col == rhs.sel_col &&
+               focus == rhs.focus && showmarks == rhs.showmarks &&
+               exe_display_style == rhs.exe_display_style &&
+               sel_display_style == rhs.sel_display_style &&
+               do_hlsearch == rhs.do_hlsearch &&
+               last_hlregex == rhs.last_hlregex;
+    }
+};
+
 /* Source viewer object */
 struct sviewer {
     struct list_node *list_head;           /* File list */
@@ -70,6 +134,27 @@ struct sviewer {
      * the source that represents the next match.
      */
     struct hl_regex_info *hlregex;
+
+    /**
+     * What is currently drawn in the window.
+     *
+     * When only the top line of the window changes, source_display
+     * scrolls the rows already in the window and draws just the rows
+     * that were exposed or whose markers changed. The rows are empty
+     * when the window has to be drawn in full on the next display.
+     */
+    sviewer_frame frame;
+    int frame_top;                         /* Line drawn on the first row */
+    int frame_cury, frame_curx;            /* Cursor after the last draw */
+    std::vector<sviewer_row> rows;
+
+    /**
+     * The inotify descriptor watching the loaded source files.
+     *
+     * When readable, call source_watch_read. This is -1 when inotify
+     * isn't available, and the files are stat'd now and then instead.
+     */
+    int watch_fd;
 };
 
 struct source_line {
@@ -86,12 +171,6 @@ struct buffer {
     enum tokenizer_language_support language;   /* The language type of this file */
 };
 
-struct line_flags {
-    enum class breakpt_status{ none, enabled, disabled };
-    breakpt_status breakpt = breakpt_status::none;
-    std::list<unsigned char> marks;
-};
-
 struct list_node {
     char *path;                    /* Full path to source file */
     struct buffer file_buf;        /* File buffer */
@@ -110,6 +189,17 @@ struct list_node {
     uint64_t addr_start;        /* Disassembly start address */
     uint64_t addr_end;          /* Disassembly end address */
 
+    /* Disassembly that is loaded a window at a time as the user scrolls.
+     * The addrs of a windowed node are sorted and have no header lines. */
+    bool disasm_window;         /* Node is a windowed disassembly */
+    bool disasm_loading;        /* A window has been requested from gdb */
+    bool disasm_head_done;      /* Nothing more to load before addr_start */
+    bool disasm_tail_done;      /* Nothing more to load after addr_end */
+
+    int watch_wd;               /* inotify watch of the file, or -1 */
+    bool watch_dirty;           /* The file may have changed since loaded */
+    time_t watch_checked;       /* When the file was last stat'd */
+
     struct list_node *next;     /* Pointer to next link in list */
 };
 
@@ -135,10 +225,55 @@ struct sviewer *source_new(SWINDOW *window);
  */
 struct list_node *source_add(struct sviewer *sview, const char *path);
 
-void source_add_disasm_line(struct list_node *node, const char *line);
+void source_add_disasm_line(struct list_node *node,
+        const tgdb_disasm_line &line);
 
 int source_highlight(struct list_node *node);
 
+/**
+ * Merge a window of disassembly into a windowed disassembly node.
+ *
+ * Lines without an address, and instructions the node already has, are
+ * skipped. Instructions before the node's first address are put in front
+ * of it, and the selected, executing and marked lines are moved down so
+ * they stay on the same instructions. Instructions after the node's last
+ * address are added to the end.
+ *
+ * @param sview
+ * The source viewer object
+ *
+ * @param node
+ * The windowed disassembly node
+ *
+ * @param disasm
+ * The disassembly of a window that starts or ends at the node
+ *
+ * @return
+ * The number of lines added to the node
+ */
+int source_merge_disasm(struct sviewer *sview, struct list_node *node,
+        const std::list<tgdb_disasm_line> &disasm);
+
+/**
+ * Check if the selected line of a windowed disassembly is near the start
+ * or the end of what has been loaded, and so more should be requested.
+ *
+ * If so, the node is marked as loading until the window is merged.
+ *
+ * @param sview
+ * The source viewer object
+ *
+ * @param start
+ * Set to the address to disassemble from
+ *
+ * @param end
+ * Set to the address to disassemble up to
+ *
+ * @return
+ * 1 if the window from start to end should be requested, 0 otherwise
+ */
+int source_disasm_wants(struct sviewer *sview, uint64_t *start, uint64_t *end);
+
 struct list_node *source_get_node(struct sviewer *sview, const char *path);
 
 /* source_del:  Remove a file from the list of source files.
@@ -184,6 +319,18 @@ char *source_current_file(struct sviewer *sview);
 int source_display(struct sviewer *sview, int focus,
     enum win_refresh dorefresh, int no_hlsearch);
 
+/**
+ * Draw every row of the source window on the next source_display.
+ *
+ * Needed when something outside of the source viewer's knowledge,
+ * like an overlapping window or a highlight group, has changed what
+ * should be on the screen.
+ *
+ * @param sview
+ * Source viewer object
+ */
+void source_invalidate(struct sviewer *sview);
+
 /* Relocate the source window.
  *
  * @param sview
@@ -294,10 +441,25 @@ void source_free(struct sviewer *sview);
 void source_set_breakpoints(struct sviewer *sview,
         const std::list<tgdb_breakpoint> &breakpoints);
 
+/**
+ * Read the changes to the watched source files.
+ *
+ * The files that changed are marked so that the next source_reload of
+ * them checks their timestamp. Call when sview->watch_fd is readable.
+ *
+ * \param sview
+ * The source viewer object
+ */
+void source_watch_read(struct sviewer *sview);
+
 /**
  * Check's to see if the current source file has changed. If it has it loads
  * the new source file up.
  *
+ * A loaded file that is watched is only stat'd after a change to it was
+ * read by source_watch_read. One that can't be watched is stat'd at most
+ * every few seconds, unless force is set.
+ *
  * \param sview
  * The source viewer object
  *
@@ -0,0 +1,272 @@
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#if HAVE_STRING_H
+#include <string.h>
+#endif /* HAVE_STRING_H */
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "sys_util.h"
+#include "sys_win.h"
+#include "threadview.h"
+#include "pane_list.h"
+#include "cgdb.h"
+
+extern struct tgdb *tgdb;
+
+/* The details of a thread, from -thread-info */
+struct thread_detail {
+    tgdb_thread_info info;
+
+    int fetched;                /* Non-zero if info was gotten */
+    int requested;              /* Non-zero while it is asked for */
+    int stale;                  /* The thread ran or stopped since */
+};
+
+struct threadview {
+    /* The window, cursor and scroll position, a row per thread */
+    struct pane_list list;
+
+    /* The details gotten so far, by thread id */
+    std::map<int, thread_detail> details;
+
+    int sel_id;                 /* The thread the cursor is on, or -1 */
+};
+
+static bool thread_less(const tgdb_thread &thread, int id)
+{
+    return thread.id < id;
+}
+
+/* The row of a thread, or of the thread after it if it exited */
+static int threadview_row(int id)
+{
+    const std::vector<tgdb_thread> &threads = tgdb_get_threads(tgdb);
+
+    return std::lower_bound(threads.begin(), threads.end(), id,
+            thread_less) - threads.begin();
+}
+
+/* Ask gdb for the details of the threads on screen that aren't known or
+ * are out of date */
+static void threadview_request(struct threadview *tv)
+{
+    const std::vector<tgdb_thread> &threads = tgdb_get_threads(tgdb);
+    int end;
+
+    if (!tv->list.win)
+        return;
+
+    end = std::min(tv->list.top + pane_list_height(&tv->list),
+            (int)threads.size());
+
+    for (int i = tv->list.top; i < end; ++i) {
+        thread_detail &detail = tv->details[threads[i].id];
+
+        /* A running thread has no frame, there is nothing new to get */
+        if (detail.fetched && (!detail.stale || threads[i].running))
+            continue;
+
+        if (!detail.requested) {
+            detail.requested = 1;
+            tgdb_request_thread_info(tgdb, threads[i].id);
+        }
+    }
+}
+
+/* The cursor moved or the threads changed, keep the cursor on a thread
+ * and get the details of the threads scrolled to */
+static void threadview_scroll_to_sel(struct threadview *tv)
+{
+    const std::vector<tgdb_thread> &threads = tgdb_get_threads(tgdb);
+
+    pane_list_scroll_to_sel(&tv->list, threads.size());
+    tv->sel_id = threads.empty() ? -1 : threads[tv->list.sel_line].id;
+
+    threadview_request(tv);
+}
+
+struct threadview *threadview_new(SWINDOW *win)
+{
+    struct threadview *tv = new threadview();
+
+    pane_list_init(&tv->list, win);
+    tv->sel_id = -1;
+
+    return tv;
+}
+
+void threadview_free(struct threadview *tv)
+{
+    swin_delwin(tv->list.win);
+    delete tv;
+}
+
+void threadview_move(struct threadview *tv, SWINDOW *win)
+{
+    pane_list_move(&tv->list, win);
+
+    if (tv->list.win)
+        threadview_changed(tv);
+}
+
+void threadview_changed(struct threadview *tv)
+{
+    const std::vector<tgdb_thread> &threads = tgdb_get_threads(tgdb);
+    std::map<int, thread_detail>::iterator iter;
+
+    /* Forget the threads that exited, and mark the ones that ran or
+     * stopped since their details were gotten */
+    for (iter = tv->details.begin(); iter != tv->details.end();) {
+        int row = threadview_row(iter->first);
+
+        if (row == (int)threads.size() || threads[row].id != iter->first) {
+            tv->details.erase(iter++);
+            continue;
+        }
+
+        if (iter->second.fetched &&
+                iter->second.info.running != threads[row].running)
+            iter->second.stale = 1;
+        ++iter;
+    }
+
+    /* Keep the cursor on the same thread */
+    if (tv->sel_id != -1)
+        tv->list.sel_line = threadview_row(tv->sel_id);
+
+    threadview_scroll_to_sel(tv);
+}
+
+void threadview_frame_changed(struct threadview *tv)
+{
+    std::map<int, thread_detail>::iterator iter;
+
+    for (iter = tv->details.begin(); iter != tv->details.end(); ++iter)
+        iter->second.stale = 1;
+
+    threadview_request(tv);
+}
+
+void threadview_info(struct threadview *tv, int id, int error,
+        const tgdb_thread_info &info)
+{
+    std::map<int, thread_detail>::iterator iter = tv->details.find(id);
+
+    /* The thread exited, it is dropped when tgdb says so */
+    if (iter == tv->details.end())
+        return;
+
+    iter->second.requested = 0;
+
+    if (!error) {
+        iter->second.info = info;
+        iter->second.fetched = 1;
+        iter->second.stale = 0;
+    }
+}
+
+int threadview_input(struct threadview *tv, int key)
+{
+    switch (pane_list_input(&tv->list, key, tgdb_get_threads(tgdb).size())) {
+        case PANE_LIST_KEY_CLOSE:
+            return -1;
+        case PANE_LIST_KEY_SELECT:
+            if (tv->sel_id != -1)
+                tgdb_request_select_thread(tgdb, tv->sel_id);
+            break;
+        case PANE_LIST_KEY_NONE:
+            break;
+        default:
+            threadview_scroll_to_sel(tv);
+            break;
+    }
+
+    return 0;
+}
+
+/* Describe a thread like gdb's info threads command would */
+static std::string threadview_describe(struct threadview *tv,
+        const tgdb_thread &thread)
+{
+    std::map<int, thread_detail>::iterator iter = tv->details.find(thread.id);
+    std::string text;
+    char buf[32];
+
+    snprintf(buf, sizeof(buf), "%d ", thread.id);
+    text = buf;
+
+    if (iter == tv->details.end() || !iter->second.fetched)
+        return text + "...";
+
+    const tgdb_thread_info &info = iter->second.info;
+
+    text += info.target_id;
+    if (!info.name.empty())
+        text += " \"" + info.name + "\"";
+
+    if (thread.running || info.running) {
+        text += " (running)";
+    } else {
+        text += " " + (info.frame.func.empty() ? "??" : info.frame.func);
+
+        if (!info.frame.path.empty()) {
+            const char *base = strrchr(info.frame.path.c_str(), '/');
+
+            text += " at ";
+            text += base ? base + 1 : info.frame.path.c_str();
+            snprintf(buf, sizeof(buf), ":%d", info.frame.line);
+            text += buf;
+        } else if (!info.frame.from.empty()) {
+            text += " from " + info.frame.from;
+        }
+    }
+
+    return text;
+}
+
+void threadview_display(struct threadview *tv, int focus,
+        enum win_refresh dorefresh)
+{
+    const std::vector<tgdb_thread> &threads = tgdb_get_threads(tgdb);
+    SWINDOW *win = tv->list.win;
+    int current = tgdb_get_current_thread(tgdb);
+    int height, width, i;
+
+    if (!win)
+        return;
+
+    height = pane_list_height(&tv->list);
+    width = swin_getmaxx(win);
+
+    pane_list_display_title(&tv->list,
+            threads.empty() ? "Threads: No threads." : "Threads");
+
+    /* Only the threads on screen are looked at */
+    for (i = 0; i < height; ++i) {
+        int row = tv->list.top + i;
+
+        swin_wmove(win, i + 1, 0);
+        swin_wclrtoeol(win);
+
+        if (row >= (int)threads.size()) {
+            swin_waddch(win, '~');
+            continue;
+        }
+
+        pane_list_display_cursor(&tv->list, row, focus);
+
+        /* The selected thread is marked like gdb marks it */
+        swin_wprintw(win, "%c %.*s",
+                threads[row].id == current ? '*' : ' ',
+                std::max(width - 4, 0),
+                threadview_describe(tv, threads[row]).c_str());
+    }
+
+    pane_list_refresh(&tv->list, dorefresh);
+}
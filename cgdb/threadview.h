@@ -0,0 +1,94 @@
+#ifndef _THREADVIEW_H_
+#define _THREADVIEW_H_
+
+/* threadview.h:
+ * -------------
+ *
+ * The threads pane shows the threads of the program, and where the
+ * stopped ones are.
+ *
+ * The list of threads is kept by tgdb from gdb's notifications, so a
+ * thread starting or exiting doesn't cost asking gdb for all of them.
+ * Only the rows on screen are drawn, and the details of a thread (its
+ * name and frame) are only asked for when its row is on screen. A program
+ * with thousands of threads costs about as much as one with a few.
+ */
+
+#include "sys_win.h"
+#include "tgdb.h"
+
+struct threadview;
+
+/* threadview_new: Create a new threads pane.
+ * _______________
+ *
+ *   win: The window to draw in, OK to pass NULL
+ *
+ * return value: a new threads pane.
+ */
+struct threadview *threadview_new(SWINDOW *win);
+
+/* threadview_free: Release the memory associated with a threads pane.
+ * ----------------
+ *
+ *   tv: The threads pane to free.
+ */
+void threadview_free(struct threadview *tv);
+
+/* threadview_move: Draw the threads pane in another window.
+ * ----------------
+ *
+ *   tv:  The threads pane
+ *   win: The new window, the old one is deleted. OK to pass NULL.
+ *
+ * While the pane has no window, gdb isn't asked for anything.
+ */
+void threadview_move(struct threadview *tv, SWINDOW *win);
+
+/* threadview_changed: Threads were created, exited, ran or stopped.
+ * -------------------
+ *
+ *   tv: The threads pane
+ */
+void threadview_changed(struct threadview *tv);
+
+/* threadview_frame_changed: The program stopped or another thread was
+ * -------------------------  selected, the frames may have changed.
+ *
+ *   tv: The threads pane
+ */
+void threadview_frame_changed(struct threadview *tv);
+
+/* threadview_info: The details of a thread gdb gave.
+ * ----------------
+ *
+ *   tv:    The threads pane
+ *   id:    The thread the details were asked for
+ *   error: Non-zero if gdb couldn't give them, like when the thread exited
+ *   info:  The details of the thread
+ */
+void threadview_info(struct threadview *tv, int id, int error,
+        const tgdb_thread_info &info);
+
+/* threadview_input: Send a key to the threads pane.
+ * -----------------
+ *
+ *   tv:  The threads pane
+ *   key: The key the user typed
+ *
+ *  returns -1 when the user closed the pane.
+ *  returns 0 when the key was handled, or not for the pane.
+ */
+int threadview_input(struct threadview *tv, int key);
+
+/* threadview_display: Redraw the threads pane.
+ * -------------------
+ *
+ *   tv:        The threads pane
+ *   focus:     Non-zero if the pane has focus
+ *   dorefresh: How to refresh the window
+ */
+void threadview_display(struct threadview *tv, int focus,
+        enum win_refresh dorefresh);
+
+#endif /* _THREADVIEW_H_ */
@@ -23,6 +23,7 @@ void usage(void)
             "   -h          Print help (this message) and then exit.\n"
 #endif
             "   -d          Set debugger to use.\n"
+            "   -r FILE     Record the raw gdb traffic to FILE for tgdb_driver.\n"
             "   -w          Wait for debugger to attach before starting.\n"
             "   --          Marks the end of CGDB's options.\n");
 }
@@ -0,0 +1,630 @@
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#if HAVE_STDIO_H
+#include <stdio.h>
+#endif /* HAVE_STDIO_H */
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "sys_util.h"
+#include "sys_win.h"
+#include "variables.h"
+#include "pane_list.h"
+#include "cgdb.h"
+#include "highlight_groups.h"
+#include "kui_term.h"
+
+extern struct tgdb *tgdb;
+
+struct variable {
+    /* The name of the variable object in GDB, empty if there is none */
+    std::string name;
+
+    /* The expression, or what a child is of its parent */
+    std::string exp;
+
+    std::string value;
+    std::string type;
+    int numchild;
+
+    int depth;                  /* 0 for locals and watches */
+    int pending;                /* Non-zero while being created */
+    int error;                  /* Non-zero if it couldn't be created */
+    int in_scope;               /* Zero if it can't be evaluated now */
+    int changed;                /* Non-zero if it changed at the last stop */
+    int dirty;                  /* Non-zero if its row needs drawing */
+    int expanded;               /* Non-zero if its children are shown */
+    int children_requested;     /* Non-zero if the children were asked for */
+
+    std::vector<variable *> children;
+};
+
+/* A row of the pane, either a section title or a variable */
+struct variable_row {
+    const char *title;
+    variable *var;
+};
+
+struct variables {
+    /* The window, cursor and scroll position, over the rows */
+    struct pane_list list;
+
+    std::vector<variable *> locals;
+    std::vector<variable *> watches;
+
+    /* Every variable with a variable object, by the variable object name */
+    std::map<std::string, variable *> varobjs;
+
+    /* The locals, watches and expanded children, as drawn */
+    std::vector<variable_row> rows;
+
+    int next_id;                /* Makes the variable object names unique */
+};
+
+static variable *variable_new(const std::string &exp, int depth)
+{
+    variable *var = new variable();
+
+    var->exp = exp;
+    var->numchild = 0;
+    var->depth = depth;
+    var->pending = 0;
+    var->error = 0;
+    var->in_scope = 1;
+    var->changed = 0;
+    var->dirty = 1;
+    var->expanded = 0;
+    var->children_requested = 0;
+
+    return var;
+}
+
+/* Forget a variable and its children. GDB deletes the variable objects of
+ * the children along with their parent. */
+static void variable_free(struct variables *vars, variable *var)
+{
+    std::map<std::string, variable *>::iterator iter;
+
+    for (size_t i = 0; i < var->children.size(); ++i)
+        variable_free(vars, var->children[i]);
+
+    iter = vars->varobjs.find(var->name);
+    if (iter != vars->varobjs.end() && iter->second == var)
+        vars->varobjs.erase(iter);
+
+    delete var;
+}
+
+static void variable_free_children(struct variables *vars, variable *var)
+{
+    for (size_t i = 0; i < var->children.size(); ++i)
+        variable_free(vars, var->children[i]);
+
+    var->children.clear();
+    var->expanded = 0;
+    var->children_requested = 0;
+}
+
+/* Ask GDB to create the variable object for a local or a watch */
+static void variable_create(struct variables *vars, variable *var)
+{
+    char name[32];
+
+    snprintf(name, sizeof(name), "cgdb_var%d", vars->next_id++);
+
+    var->name = name;
+    var->pending = 1;
+    var->error = 0;
+    var->dirty = 1;
+    vars->varobjs[var->name] = var;
+
+    tgdb_request_var_create(tgdb, var->name.c_str(), var->exp.c_str());
+}
+
+/* Delete a local or a watch, along with its variable object */
+static void variable_delete(struct variables *vars, variable *var)
+{
+    if (!var->name.empty())
+        tgdb_request_var_delete(tgdb, var->name.c_str());
+
+    variable_free(vars, var);
+}
+
+static void variables_add_rows(struct variables *vars,
+        const std::vector<variable *> &list)
+{
+    for (size_t i = 0; i < list.size(); ++i) {
+        variable_row row = { NULL, list[i] };
+
+        vars->rows.push_back(row);
+        if (list[i]->expanded)
+            variables_add_rows(vars, list[i]->children);
+    }
+}
+
+static void variables_scroll_to_sel(struct variables *vars)
+{
+    pane_list_scroll_to_sel(&vars->list, vars->rows.size());
+}
+
+/* Lay out the rows again, after variables were added, removed, expanded
+ * or collapsed */
+static void variables_update_rows(struct variables *vars)
+{
+    variable *sel_var = NULL;
+    variable_row title;
+
+    if (vars->list.sel_line < (int)vars->rows.size())
+        sel_var = vars->rows[vars->list.sel_line].var;
+
+    vars->rows.clear();
+
+    title.title = "Locals";
+    title.var = NULL;
+    vars->rows.push_back(title);
+    variables_add_rows(vars, vars->locals);
+
+    title.title = "Watches";
+    vars->rows.push_back(title);
+    variables_add_rows(vars, vars->watches);
+
+    /* Keep the cursor on the same variable, if it is still shown */
+    for (size_t i = 0; sel_var && i < vars->rows.size(); ++i) {
+        if (vars->rows[i].var == sel_var) {
+            vars->list.sel_line = i;
+            break;
+        }
+    }
+
+    variables_scroll_to_sel(vars);
+    vars->list.redraw = 1;
+}
+
+static variable *variables_find(struct variables *vars,
+        const std::string &name)
+{
+    std::map<std::string, variable *>::iterator iter =
+        vars->varobjs.find(name);
+
+    return iter != vars->varobjs.end() ? iter->second : NULL;
+}
+
+/* Bring the locals and the watches up to date */
+static void variables_refresh(struct variables *vars)
+{
+    std::map<std::string, variable *>::iterator iter;
+
+    vars->list.stale = 0;
+
+    /* The values that changed at the last stop aren't highlighted now */
+    for (iter = vars->varobjs.begin(); iter != vars->varobjs.end(); ++iter) {
+        if (iter->second->changed) {
+            iter->second->changed = 0;
+            iter->second->dirty = 1;
+        }
+    }
+
+    tgdb_request_stack_variables(tgdb);
+    tgdb_request_var_update(tgdb);
+
+    /* A watch may be valid in this frame even if it wasn't in the last.
+     * The same goes for a local whose variable object became invalid, it
+     * is kept by its expression for as long as it is a local. */
+    for (size_t i = 0; i < vars->watches.size(); ++i) {
+        if (vars->watches[i]->name.empty())
+            variable_create(vars, vars->watches[i]);
+    }
+
+    for (size_t i = 0; i < vars->locals.size(); ++i) {
+        if (vars->locals[i]->name.empty())
+            variable_create(vars, vars->locals[i]);
+    }
+}
+
+struct variables *variables_new(SWINDOW *win)
+{
+    struct variables *vars = new variables();
+
+    pane_list_init(&vars->list, win);
+    vars->next_id = 1;
+
+    variables_update_rows(vars);
+
+    return vars;
+}
+
+void variables_free(struct variables *vars)
+{
+    for (size_t i = 0; i < vars->locals.size(); ++i)
+        variable_free(vars, vars->locals[i]);
+
+    for (size_t i = 0; i < vars->watches.size(); ++i)
+        variable_free(vars, vars->watches[i]);
+
+    swin_delwin(vars->list.win);
+    delete vars;
+}
+
+void variables_move(struct variables *vars, SWINDOW *win)
+{
+    pane_list_move(&vars->list, win);
+
+    if (vars->list.win) {
+        variables_scroll_to_sel(vars);
+
+        if (vars->list.stale)
+            variables_refresh(vars);
+    }
+}
+
+void variables_invalidate(struct variables *vars)
+{
+    vars->list.redraw = 1;
+}
+
+void variables_frame_changed(struct variables *vars)
+{
+    if (pane_list_frame_changed(&vars->list))
+        variables_refresh(vars);
+}
+
+void variables_add_watch(struct variables *vars, const char *expr)
+{
+    variable *var = variable_new(expr, 0);
+
+    vars->watches.push_back(var);
+
+    /* Created when the pane is shown */
+    if (vars->list.win)
+        variable_create(vars, var);
+
+    variables_update_rows(vars);
+}
+
+void variables_set_locals(struct variables *vars, int error,
+        const std::list<std::string> &names)
+{
+    std::map<std::string, variable *> old_locals;
+    std::map<std::string, variable *>::iterator iter;
+    std::list<std::string>::const_iterator name;
+    std::set<std::string> seen;
+    std::vector<variable *> locals;
+    int changed = 0;
+
+    for (size_t i = 0; i < vars->locals.size(); ++i)
+        old_locals[vars->locals[i]->exp] = vars->locals[i];
+
+    for (name = names.begin(); !error && name != names.end(); ++name) {
+        /* A local shadowed by a local of an inner block has the same name,
+         * the expression can only be evaluated as the inner one */
+        if (!seen.insert(*name).second)
+            continue;
+
+        iter = old_locals.find(*name);
+        if (iter != old_locals.end()) {
+            locals.push_back(iter->second);
+            old_locals.erase(iter);
+        } else {
+            variable *var = variable_new(*name, 0);
+
+            variable_create(vars, var);
+            locals.push_back(var);
+            changed = 1;
+        }
+    }
+
+    for (iter = old_locals.begin(); iter != old_locals.end(); ++iter) {
+        variable_delete(vars, iter->second);
+        changed = 1;
+    }
+
+    if (changed || locals != vars->locals) {
+        vars->locals = locals;
+        variables_update_rows(vars);
+    }
+}
+
+void variables_created(struct variables *vars, const std::string &name,
+        int error, const tgdb_varobj &varobj)
+{
+    variable *var = variables_find(vars, name);
+
+    /* Deleted before GDB got to it */
+    if (!var)
+        return;
+
+    var->pending = 0;
+    var->dirty = 1;
+
+    if (error) {
+        /* There is no variable object to update or delete */
+        vars->varobjs.erase(var->name);
+        var->name.clear();
+        var->error = 1;
+        return;
+    }
+
+    var->value = varobj.value;
+    var->type = varobj.type;
+    var->numchild = varobj.numchild;
+    var->in_scope = 1;
+}
+
+void variables_children(struct variables *vars, const std::string &name,
+        int error, const std::list<tgdb_varobj> &children)
+{
+    std::list<tgdb_varobj>::const_iterator iter;
+    variable *var = variables_find(vars, name);
+
+    if (!var || !var->children_requested || !var->children.empty())
+        return;
+
+    for (iter = children.begin(); !error && iter != children.end(); ++iter) {
+        variable *child = variable_new(iter->exp, var->depth + 1);
+
+        child->name = iter->name;
+        child->value = iter->value;
+        child->type = iter->type;
+        child->numchild = iter->numchild;
+        vars->varobjs[child->name] = child;
+
+        var->children.push_back(child);
+    }
+
+    if (var->expanded)
+        variables_update_rows(vars);
+}
+
+void variables_changes(struct variables *vars, int error,
+        const std::list<tgdb_varobj_change> &changes)
+{
+    std::list<tgdb_varobj_change>::const_iterator iter;
+    int update_rows = 0;
+
+    for (iter = changes.begin(); !error && iter != changes.end(); ++iter) {
+        variable *var = variables_find(vars, iter->name);
+
+        if (!var)
+            continue;
+
+        var->dirty = 1;
+
+        if (iter->invalid) {
+            /* A local or a watch is made again for the next frame, the
+             * children can't be valid any more either */
+            tgdb_request_var_delete(tgdb, var->name.c_str());
+            variable_free_children(vars, var);
+            vars->varobjs.erase(var->name);
+            var->name.clear();
+            var->in_scope = 0;
+            var->numchild = 0;
+            update_rows = 1;
+            continue;
+        }
+
+        if (iter->type_changed) {
+            /* GDB deleted the children */
+            variable_free_children(vars, var);
+            var->type = iter->new_type;
+            update_rows = 1;
+        }
+
+        if (iter->new_num_children >= 0)
+            var->numchild = iter->new_num_children;
+
+        var->in_scope = iter->in_scope;
+        if (var->in_scope) {
+            var->value = iter->value;
+            var->changed = 1;
+        }
+    }
+
+    if (update_rows)
+        variables_update_rows(vars);
+}
+
+static variable *variables_sel_var(struct variables *vars)
+{
+    if (vars->list.sel_line < (int)vars->rows.size())
+        return vars->rows[vars->list.sel_line].var;
+
+    return NULL;
+}
+
+static void variables_expand(struct variables *vars, variable *var)
+{
+    if (!var || var->expanded || var->numchild == 0 || var->name.empty())
+        return;
+
+    var->expanded = 1;
+    var->dirty = 1;
+
+    if (!var->children_requested) {
+        var->children_requested = 1;
+        tgdb_request_var_list_children(tgdb, var->name.c_str());
+    }
+
+    variables_update_rows(vars);
+}
+
+static void variables_collapse(struct variables *vars, variable *var)
+{
+    if (!var)
+        return;
+
+    if (var->expanded) {
+        var->expanded = 0;
+        var->dirty = 1;
+        variables_update_rows(vars);
+        return;
+    }
+
+    /* Go to the parent, the closest row above with less depth */
+    for (int i = vars->list.sel_line - 1; i >= 0 && var->depth > 0; --i) {
+        if (vars->rows[i].var && vars->rows[i].var->depth < var->depth) {
+            vars->list.sel_line = i;
+            variables_scroll_to_sel(vars);
+            break;
+        }
+    }
+}
+
+/* Show the children of the variable the cursor is on, or hide them if
+ * they are shown */
+static void variables_toggle(struct variables *vars)
+{
+    variable *var = variables_sel_var(vars);
+
+    if (var && var->expanded)
+        variables_collapse(vars, var);
+    else
+        variables_expand(vars, var);
+}
+
+/* Stop watching the watch the cursor is on */
+static void variables_remove_watch(struct variables *vars, variable *var)
+{
+    std::vector<variable *>::iterator iter =
+        std::find(vars->watches.begin(), vars->watches.end(), var);
+
+    if (iter == vars->watches.end())
+        return;
+
+    vars->watches.erase(iter);
+    variable_delete(vars, var);
+    variables_update_rows(vars);
+}
+
+int variables_input(struct variables *vars, int key)
+{
+    switch (pane_list_input(&vars->list, key, vars->rows.size())) {
+        case PANE_LIST_KEY_CLOSE:
+            return -1;
+        case PANE_LIST_KEY_SELECT:
+            variables_toggle(vars);
+            break;
+        case PANE_LIST_KEY_NONE:
+            break;
+        default:
+            return 0;
+    }
+
+    switch (key) {
+        case CGDB_KEY_RIGHT:
+        case 'l':
+            variables_expand(vars, variables_sel_var(vars));
+            break;
+        case CGDB_KEY_LEFT:
+        case 'h':
+            variables_collapse(vars, variables_sel_var(vars));
+            break;
+        case ' ':
+            variables_toggle(vars);
+            break;
+        case 'd':
+        case CGDB_KEY_DC:
+            variables_remove_watch(vars, variables_sel_var(vars));
+            break;
+    }
+
+    return 0;
+}
+
+/* Draw a row of the pane */
+static void variables_display_row(struct variables *vars, int line,
+        int row, int focus, int width)
+{
+    SWINDOW *win = vars->list.win;
+    int changed_attr = hl_groups_get_attr(hl_groups_instance,
+            HLG_CHANGED_VALUE);
+    int col;
+    variable *var;
+    std::string text;
+
+    swin_wmove(win, line, 0);
+    swin_wclrtoeol(win);
+
+    if (row >= (int)vars->rows.size()) {
+        swin_waddch(win, '~');
+        return;
+    }
+
+    pane_list_display_cursor(&vars->list, row, focus);
+
+    var = vars->rows[row].var;
+    if (!var) {
+        swin_wattron(win, SWIN_A_BOLD);
+        swin_wprintw(win, "%.*s", std::max(width - 2, 0),
+                vars->rows[row].title);
+        swin_wattroff(win, SWIN_A_BOLD);
+        return;
+    }
+
+    var->dirty = 0;
+
+    text.append(var->depth * 2, ' ');
+    if (var->numchild > 0 && !var->name.empty())
+        text += var->expanded ? "- " : "+ ";
+    else
+        text += "  ";
+    text += var->exp;
+
+    col = 2 + text.size();
+    swin_wprintw(win, "%.*s", std::max(width - 2, 0), text.c_str());
+
+    if (var->pending)
+        text = " = ...";
+    else if (var->error)
+        text = " = <cannot evaluate>";
+    else if (!var->in_scope)
+        text = " = <not in scope>";
+    else if (!var->value.empty())
+        text = " = " + var->value;
+    else
+        return;
+
+    /* Only the value is highlighted */
+    if (var->changed)
+        swin_wattron(win, changed_attr);
+    swin_wprintw(win, "%.*s", std::max(width - col, 0), text.c_str());
+    if (var->changed)
+        swin_wattroff(win, changed_attr);
+}
+
+void variables_display(struct variables *vars, int focus,
+        enum win_refresh dorefresh)
+{
+    int height, width, i;
+    int redraw;
+
+    if (!vars->list.win)
+        return;
+
+    height = pane_list_height(&vars->list);
+    width = swin_getmaxx(vars->list.win);
+
+    redraw = pane_list_redraw(&vars->list, focus);
+
+    if (redraw)
+        pane_list_display_title(&vars->list, "Variables");
+
+    /* Only the rows that changed are formatted again */
+    for (i = 0; i < height; ++i) {
+        int row = vars->list.top + i;
+        variable *var = row < (int)vars->rows.size() ?
+            vars->rows[row].var : NULL;
+
+        if (redraw || (var && var->dirty) ||
+                pane_list_cursor_moved(&vars->list, row))
+            variables_display_row(vars, i + 1, row, focus, width);
+    }
+
+    pane_list_drawn(&vars->list, focus);
+    pane_list_refresh(&vars->list, dorefresh);
+}
@@ -0,0 +1,136 @@
+#ifndef _VARIABLES_H_
+#define _VARIABLES_H_
+
+/* variables.h:
+ * ------------
+ *
+ * The variables pane shows the locals of the selected frame and the
+ * expressions the user is watching.
+ *
+ * Each variable is a GDB variable object. After the program stops, GDB is
+ * only asked which variable objects changed, so a big struct isn't printed
+ * again on every step. The children of a variable are only asked for when
+ * it is expanded, and only the rows that changed are drawn again.
+ */
+
+#include <list>
+#include <string>
+
+#include "sys_win.h"
+#include "tgdb.h"
+
+struct variables;
+
+/* variables_new: Create a new variables pane.
+ * ______________
+ *
+ *   win: The window to draw in, OK to pass NULL
+ *
+ * return value: a new variables pane.
+ */
+struct variables *variables_new(SWINDOW *win);
+
+/* variables_free: Release the memory associated with a variables pane.
+ * ---------------
+ *
+ *   vars: The variables pane to free.
+ */
+void variables_free(struct variables *vars);
+
+/* variables_move: Draw the variables pane in another window.
+ * ---------------
+ *
+ *   vars: The variables pane
+ *   win:  The new window, the old one is deleted. OK to pass NULL.
+ *
+ * While the pane has no window, GDB isn't asked for anything. The
+ * variables are brought up to date when it gets a window again.
+ */
+void variables_move(struct variables *vars, SWINDOW *win);
+
+/* variables_invalidate: Draw every row the next time the pane is displayed.
+ * ---------------------
+ *
+ *   vars: The variables pane
+ */
+void variables_invalidate(struct variables *vars);
+
+/* variables_frame_changed: The program stopped or another frame was selected.
+ * ------------------------
+ *
+ *   vars: The variables pane
+ */
+void variables_frame_changed(struct variables *vars);
+
+/* variables_add_watch: Watch an expression.
+ * --------------------
+ *
+ *   vars: The variables pane
+ *   expr: The expression, evaluated in the selected frame
+ */
+void variables_add_watch(struct variables *vars, const char *expr);
+
+/* variables_set_locals: Set the locals of the selected frame.
+ * ---------------------
+ *
+ *   vars:  The variables pane
+ *   error: Non-zero if gdb couldn't list the locals
+ *   names: The names of the arguments and locals
+ */
+void variables_set_locals(struct variables *vars, int error,
+        const std::list<std::string> &names);
+
+/* variables_created: A variable object was created.
+ * ------------------
+ *
+ *   vars:   The variables pane
+ *   name:   The name the variable object was asked for with
+ *   error:  Non-zero if gdb couldn't create it
+ *   varobj: The variable object
+ */
+void variables_created(struct variables *vars, const std::string &name,
+        int error, const tgdb_varobj &varobj);
+
+/* variables_children: The children of a variable object.
+ * -------------------
+ *
+ *   vars:     The variables pane
+ *   name:     The variable object the children are of
+ *   error:    Non-zero if gdb couldn't list the children
+ *   children: The children
+ */
+void variables_children(struct variables *vars, const std::string &name,
+        int error, const std::list<tgdb_varobj> &children);
+
+/* variables_changes: The variable objects that changed.
+ * ------------------
+ *
+ *   vars:    The variables pane
+ *   error:   Non-zero if gdb couldn't update the variable objects
+ *   changes: The changes
+ */
+void variables_changes(struct variables *vars, int error,
+        const std::list<tgdb_varobj_change> &changes);
+
+/* variables_input: Send a key to the variables pane.
+ * ----------------
+ *
+ *   vars: The variables pane
+ *   key:  The key the user typed
+ *
+ *  returns -1 when the user closed the pane.
+ *  returns 0 when the key was handled, or not for the pane.
+ */
+int variables_input(struct variables *vars, int key);
+
+/* variables_display: Redraw the rows of the variables pane that changed.
+ * ------------------
+ *
+ *   vars:      The variables pane
+ *   focus:     Non-zero if the pane has focus
+ *   dorefresh: How to refresh the window
+ */
+void variables_display(struct variables *vars, int focus,
+        enum win_refresh dorefresh);
+
+#endif /* _VARIABLES_H_ */
@@ -200,7 +200,11 @@ VTerminal::VTerminal(VTerminalOptions options_p) : vt(nullptr)
     // Setup screen
     vts = vterm_obtain_screen(vt);
     vterm_screen_set_callbacks(vts, &vterm_screen_callbacks, this);
-    vterm_screen_set_damage_merge(vts, VTERM_DAMAGE_SCROLL);
+    // The whole terminal is drawn from the screen cells after each write,
+    // so the damage and moverect callbacks are ignored. Merging all the
+    // damage into a single rect keeps libvterm from tracking it by the cell
+    // or replaying scrolls.
+    vterm_screen_set_damage_merge(vts, VTERM_DAMAGE_SCREEN);
     vterm_screen_reset(vts, 1);
 
     // Configure the scrollback buffer.
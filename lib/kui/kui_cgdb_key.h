@@ -112,6 +112,10 @@ enum cgdb_key {
     CGDB_KEY_BACKWARD_KILL_WORD,
     CGDB_KEY_FORWARD_KILL_WORD,
 
+    /* The terminal surrounds pasted text with these in bracketed paste mode */
+    CGDB_KEY_PASTE_START,
+    CGDB_KEY_PASTE_END,
+
     CGDB_KEY_ERROR
 };
 
@@ -1,4 +1,5 @@
 #include "kui_ctx.h"
+#include "kui_term.h"
 
 static int intlen(const int *val)
 {
@@ -238,6 +239,21 @@ int kuictx::findkey(int& was_map_found)
     return key;
 }
 
+void kuictx::take_input(std::string &text)
+{
+    for (int key : m_buffer) {
+        if (kui_term_is_cgdb_key(key)) {
+            const char *seq = kui_term_get_ascii_char_sequence_from_key(key);
+            if (seq)
+                text.append(seq);
+        } else {
+            text.push_back(key);
+        }
+    }
+
+    m_buffer.clear();
+}
+
 int kuictx::getkey()
 {
     int map_found;
@@ -3,7 +3,8 @@
 
 #include "kui_map_set.h"
 
-#include <list>
+#include <deque>
+#include <string>
 #include <memory>
 
 /******************************************************************************/
@@ -150,6 +151,51 @@ public:
         return m_fd;
     }
 
+    /**
+     * Append characters that were read from the descriptor to the buffer.
+     *
+     * This allows a getkey callback to read everything that is available
+     * at once. The extra characters are handed out before the callback
+     * is called again.
+     *
+     * \param buf
+     * The characters to append
+     *
+     * \param n
+     * The number of characters in buf
+     */
+    void push_input(const char *buf, int n)
+    {
+        m_buffer.insert(m_buffer.end(), buf, buf + n);
+    }
+
+    /**
+     * Put characters back in front of the buffer.
+     *
+     * They will be the next characters processed by this context.
+     *
+     * \param buf
+     * The characters to put back
+     *
+     * \param n
+     * The number of characters in buf
+     */
+    void unget_input(const char *buf, int n)
+    {
+        m_buffer.insert(m_buffer.begin(), buf, buf + n);
+    }
+
+    /**
+     * Move everything in the buffer to the end of text.
+     *
+     * Any CGDB_KEY_* value in the buffer is converted back into the
+     * characters the terminal sent for it.
+     *
+     * \param text
+     * The string to append the buffered characters to
+     */
+    void take_input(std::string &text);
+
 private:
 
     /**
@@ -158,14 +204,14 @@ private:
     std::shared_ptr<kui_map_set> m_map_set;
 
     /**
-     * A list of characters, used as a buffer for stdin.
+     * A queue of characters, used as a buffer for stdin.
      */
-    std::list<int> m_buffer;
+    std::deque<int> m_buffer;
 
     /**
      * A volitale buffer. This is reset upon every call to kui_getkey.
      */
-    std::list<int> m_volatile_buffer;
+    std::deque<int> m_volatile_buffer;
 
     /**
      * The callback function used to get data read in.
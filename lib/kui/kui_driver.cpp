@@ -47,6 +47,8 @@
 #include <getopt.h>
 #endif
 
+#include <string>
+
 #include "sys_win.h"
 #include "sys_util.h"
 #include "kui_manager.h"
@@ -56,6 +58,11 @@
 std::shared_ptr<kui_map_set> map;
 std::unique_ptr<kui_manager> manager;
 
+/* The keystroke stream to replay, if running the benchmark */
+static const char *benchmark_file = NULL;
+/* The number of times to replay the keystroke stream */
+static int benchmark_iterations = 100;
+
 static void kui_shutdown(int use_endwin)
 {
     manager.reset();
@@ -75,6 +82,18 @@ static void usage(void)
 #else
             "   -f          Load an rc file consisting of map and unmap commands.\r\n"
 #endif
+#ifdef HAVE_GETOPT_H
+            "   --benchmark Replay a file of recorded keystrokes and report the\r\n"
+            "               time it took to process them.\r\n"
+#else
+            "   -b          Replay a file of recorded keystrokes and report the\r\n"
+            "               time it took to process them.\r\n"
+#endif
+#ifdef HAVE_GETOPT_H
+            "   --iterations Number of times to replay the keystrokes (100).\r\n"
+#else
+            "   -n          Number of times to replay the keystrokes (100).\r\n"
+#endif
 #ifdef HAVE_GETOPT_H
             "   --help      Print help (this message) and then exit.\r\n"
 #else
@@ -167,11 +186,13 @@ static int read_mappings(const char *file)
 static void parse_long_options(int argc, char **argv)
 {
     int opt, option_index = 0;
-    const char *args = "hf:";
+    const char *args = "hf:b:n:";
 
 #ifdef HAVE_GETOPT_H
     static struct option long_options[] = {
         {"file", 1, 0, 'f'},
+        {"benchmark", 1, 0, 'b'},
+        {"iterations", 1, 0, 'n'},
         {"help", 0, 0, 'h'},
         {0, 0, 0, 0}
     };
@@ -191,6 +212,12 @@ static void parse_long_options(int argc, char **argv)
                 /* Load a file */
                 read_mappings(optarg);
                 break;
+            case 'b':
+                benchmark_file = optarg;
+                break;
+            case 'n':
+                benchmark_iterations = atoi(optarg);
+                break;
             case '?':
             case 'h':
                 swin_endwin();
@@ -282,6 +309,84 @@ void main_loop(std::unique_ptr<kui_manager>& i)
     }
 }
 
+/**
+ * Replay a recorded keystroke stream through the kui.
+ *
+ * The whole stream is queued in the kui up front and the kui reads from a
+ * pipe that never has data, so this measures matching the terminal key
+ * sequences and the mappings, not reading the input.
+ *
+ * \param file
+ * The file containing the keystrokes, exactly as the terminal sent them.
+ *
+ * \param iterations
+ * The number of times to replay the keystrokes.
+ *
+ * @return
+ * 0 on success or -1 on error
+ */
+static int benchmark(const char *file, int iterations)
+{
+    std::string keystrokes;
+    unsigned long keys = 0;
+    struct timeval start, end;
+    double seconds;
+    char buf[4096];
+    size_t size;
+    int fds[2];
+    FILE *fd = fopen(file, "rb");
+
+    if (!fd) {
+        fprintf(stderr, "%s:%d fopen failed\n", __FILE__, __LINE__);
+        return -1;
+    }
+
+    while ((size = fread(buf, 1, sizeof(buf), fd)) > 0)
+        keystrokes.append(buf, size);
+    fclose(fd);
+
+    if (pipe(fds) == -1) {
+        fprintf(stderr, "%s:%d pipe failed\n", __FILE__, __LINE__);
+        return -1;
+    }
+
+    /* Don't wait for the rest of a key sequence or mapping */
+    std::unique_ptr<kui_manager> kuim = kui_manager::create(fds[0], 0, 0);
+    if (!kuim) {
+        fprintf(stderr, "%s:%d kui_manager::create failed\n",
+                __FILE__, __LINE__);
+        return -1;
+    }
+    kuim->set_map_set(map);
+
+    gettimeofday(&start, NULL);
+
+    for (int i = 0; i < iterations; ++i) {
+        kuim->unget_input(keystrokes);
+
+        while (kuim->cangetkey()) {
+            if (kuim->getkey() == -1) {
+                fprintf(stderr, "kui_manager_getkey failed\n");
+                return -1;
+            }
+            ++keys;
+        }
+    }
+
+    gettimeofday(&end, NULL);
+
+    seconds = (end.tv_sec - start.tv_sec) +
+            (end.tv_usec - start.tv_usec) / 1000000.0;
+    printf("%lu bytes, %lu keys in %.3f seconds (%.0f keys/second)\n",
+            (unsigned long)keystrokes.size() * iterations, keys, seconds,
+            seconds > 0 ? keys / seconds : 0);
+
+    close(fds[0]);
+    close(fds[1]);
+
+    return 0;
+}
+
 static void create_mappings(std::unique_ptr<kui_manager>& kuim)
 {
     map = std::make_shared<kui_map_set>();
@@ -366,6 +471,11 @@ int main(int argc, char **argv)
 
     parse_long_options(argc, argv);
 
+    if (benchmark_file) {
+        swin_endwin();
+        exit(benchmark(benchmark_file, benchmark_iterations) == -1);
+    }
+
     main_loop(manager);
 
     kui_shutdown(1);
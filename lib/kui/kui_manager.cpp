@@ -2,10 +2,31 @@
 #include "kui_term.h"
 #include "io.h"
 
+/**
+ * Reads the next char for the terminal keys context.
+ *
+ * Everything that is available on the descriptor is read in with a single
+ * read. The first char is returned and the rest is buffered in the context,
+ * which is passed in as obj. The context only calls back when its buffer is
+ * empty, so waiting for the rest of an escape sequence still happens only
+ * when no more input has arrived.
+ */
 static int char_cb(const int fd, const unsigned int ms, kuictx *obj, int *key)
 {
+    char buf[4096];
+    int result;
+
+    if (!key)
+        return -1;
+
+    result = io_getchars(fd, ms, buf, sizeof(buf));
+    if (result <= 0)
+        return result;
+
+    *key = buf[0];
+    obj->push_input(buf + 1, result - 1);
 
-    return io_getchar(fd, ms, key);
+    return 1;
 }
 
 static int kui_cb(const int fd, const unsigned int ms, kuictx *kctx, int *key)
@@ -62,7 +83,7 @@ kui_manager::kui_manager(int stdinfd,
                          unsigned long keycode_timeout,
                          unsigned long mapping_timeout)
     : terminal_key_set{ std::make_shared<kui_map_set>() }
-    , terminal_keys{ terminal_key_set, stdinfd, char_cb, keycode_timeout, nullptr }
+    , terminal_keys{ terminal_key_set, stdinfd, char_cb, keycode_timeout, &terminal_keys }
     , normal_keys  { nullptr, -1, kui_cb, mapping_timeout, &terminal_keys }
 {
 }
@@ -116,6 +137,50 @@ int kui_manager::getkey_blocking()
     return val;
 }
 
+int kui_manager::get_paste(std::string &text)
+{
+    /* The sequence the terminal sends at the end of a paste */
+    static const std::string paste_end = "\033[201~";
+    /* How long to wait for more of the paste to arrive */
+    static const int paste_timeout_ms = 1000;
+    std::string::size_type pos, start = 0;
+
+    text.clear();
+    normal_keys.take_input(text);
+    terminal_keys.take_input(text);
+
+    while ((pos = text.find(paste_end, start)) == std::string::npos) {
+        char buf[4096];
+        int result;
+
+        /* The end sequence may be split across two reads */
+        if (text.size() >= paste_end.size())
+            start = text.size() - paste_end.size() + 1;
+
+        result = io_getchars(terminal_keys.get_fd(), paste_timeout_ms,
+                buf, sizeof(buf));
+        if (result == -1)
+            return -1;
+
+        if (result == 0)
+            return 0;
+
+        text.append(buf, result);
+    }
+
+    /* Leave anything typed after the paste for getkey */
+    terminal_keys.push_input(text.data() + pos + paste_end.size(),
+            text.size() - pos - paste_end.size());
+    text.erase(pos);
+
+    return 1;
+}
+
+void kui_manager::unget_input(const std::string &text)
+{
+    terminal_keys.unget_input(text.data(), text.size());
+}
+
 void kui_manager::set_terminal_escape_sequence_timeout(unsigned long msec)
 {
     terminal_keys.set_blocking_ms(msec);
@@ -87,6 +87,36 @@ public:
      */
     int getkey_blocking();
 
+    /**
+     * Get the text of a bracketed paste.
+     *
+     * Call this after getkey returns CGDB_KEY_PASTE_START. The text up
+     * to the paste end sequence is returned exactly as it was typed,
+     * without looking for terminal escape sequences or user mappings.
+     * Any input after the end sequence is left for the next getkey.
+     *
+     * If the terminal stops sending input before the end sequence
+     * arrives, the text received so far is returned.
+     *
+     * \param text
+     * The pasted text
+     *
+     * \return
+     * -1 on error, 0 if the end sequence never arrived, 1 on success
+     */
+    int get_paste(std::string &text);
+
+    /**
+     * Put text back in front of the input.
+     *
+     * The text is processed by the next calls to getkey as if the
+     * user typed it, including terminal escape sequences and mappings.
+     *
+     * \param text
+     * The text to put back
+     */
+    void unget_input(const std::string &text);
+
     /**
      * Set's the terminal escape sequence time out value.
      * This is used to tell CGDB how long to block when looking to match terminal
@@ -93,7 +93,7 @@ struct keydata {
     const char *key_seq;
 };
 
-static std::array<keydata, 47> hard_coded_bindings{{
+static std::array<keydata, 49> hard_coded_bindings{{
     { CGDB_KEY_ESC, "\033" },
     /* Arrow bindings */
 
@@ -131,6 +131,9 @@ static std::array<keydata, 47> hard_coded_bindings{{
     { CGDB_KEY_FORWARD_WORD       , "\033f" },
     { CGDB_KEY_BACKWARD_KILL_WORD , "\033\b" },
     { CGDB_KEY_FORWARD_KILL_WORD  , "\033d" },
+    /* Bracketed paste bindings */
+    { CGDB_KEY_PASTE_START        , "\033[200~" },
+    { CGDB_KEY_PASTE_END          , "\033[201~" },
     /* Ctrl bindings */
     { CGDB_KEY_CTRL_A , "\001" },
     { CGDB_KEY_CTRL_B , "\002" },
@@ -176,7 +179,7 @@ struct cgdb_keycode_data {
     const char *key_as_string;
 };
 
-static std::array<cgdb_keycode_data, 92> cgdb_keycodes{{
+static std::array<cgdb_keycode_data, 94> cgdb_keycodes{{
     /* Shift keys */
     { 'A', "<S-a>", "<shift a>" },
     { 'B', "<S-b>", "<shift b>" },
@@ -236,6 +239,10 @@ static std::array<cgdb_keycode_data, 92> cgdb_keycodes{{
                                     "CGDB_KEY_BACKWARD_KILL_WORD"          },
     { CGDB_KEY_FORWARD_KILL_WORD  , "<FORWARD-KILL_WORD>",
                                     "CGDB_KEY_FORWARD_KILL_WORD"           },
+    { CGDB_KEY_PASTE_START        , "<PasteStart>"   ,
+                                    "CGDB_KEY_PASTE_START"                 },
+    { CGDB_KEY_PASTE_END          , "<PasteEnd>"     ,
+                                    "CGDB_KEY_PASTE_END"                   },
     { CGDB_KEY_CTRL_A             , "<C-a>"          , "CGDB_KEY_CTRL_A"   },
     { CGDB_KEY_CTRL_B             , "<C-b>"          , "CGDB_KEY_CTRL_B"   },
     { CGDB_KEY_CTRL_C             , "<C-c>"          , "CGDB_KEY_CTRL_C"   },
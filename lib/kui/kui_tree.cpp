@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <map>
 
 #include "kui_tree.h"
@@ -35,11 +36,17 @@ private:
 
 kui_tree::kui_tree()
     : root(kui_tree_node::create())
+    , dirty(true)
+    , cur(-1)
+    , found_node(-1)
+    , state(kui_tree_state::NOT_FOUND)
+    , found(0)
 {}
 
 void kui_tree::insert(const int *klist, kui_map *data)
 {
     insert(root, klist, data);
+    dirty = true;
 }
 
 /**
@@ -80,6 +87,7 @@ void kui_tree::insert(node_ptr_type node, const int *klist, kui_map *data)
 void kui_tree::erase(const int *klist)
 {
     erase(root, klist);
+    dirty = true;
 }
 
 /**
@@ -121,6 +129,39 @@ void kui_tree::erase(node_ptr_type node, const int *klist)
     }
 }
 
+/**
+ * Flatten the tree into the nodes and edges arrays.
+ *
+ * The nodes are laid out in breadth first order, so the children of a node
+ * are next to each other, and so are the edges leading to them. Since the
+ * children map is ordered, each node's edges come out sorted by key.
+ */
+void kui_tree::compile()
+{
+    std::vector<kui_tree_node *> order{ root.get() };
+
+    nodes.clear();
+    edges.clear();
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        kui_tree_node *node = order[i];
+        flat_node flat;
+
+        flat.macro_value = node->macro_value;
+        flat.first_edge = edges.size();
+        flat.num_edges = node->children.size();
+
+        for (const auto &child : node->children) {
+            edges.push_back({ child.first, (int)order.size() });
+            order.push_back(child.second.get());
+        }
+
+        nodes.push_back(flat);
+    }
+
+    dirty = false;
+}
+
 kui_tree::kui_tree_state kui_tree::get_state() const
 {
     return state;
@@ -128,10 +169,13 @@ kui_tree::kui_tree_state kui_tree::get_state() const
 
 void kui_tree::reset_state()
 {
-    cur = root;
+    if (dirty)
+        compile();
+
+    cur = 0;
     state = kui_tree_state::MATCHING;
     found = 0;
-    found_node = NULL;
+    found_node = -1;
 }
 
 void kui_tree::finalize_state()
@@ -142,7 +186,7 @@ void kui_tree::finalize_state()
 
 kui_map *kui_tree::get_data() const
 {
-    return found ? found_node->macro_value : nullptr;
+    return found ? nodes[found_node].macro_value : nullptr;
 }
 
 bool kui_tree::push_key(int key, int *map_found)
@@ -153,22 +197,25 @@ bool kui_tree::push_key(int key, int *map_found)
         return false;
 
     /* Check to see if this key matches */
-    auto iter = cur->children.find(key);
+    const flat_edge *first = edges.data() + nodes[cur].first_edge;
+    const flat_edge *last = first + nodes[cur].num_edges;
+    const flat_edge *edge = std::lower_bound(first, last, key,
+        [](const flat_edge &e, int k) { return e.key < k; });
 
     /* Not found */
-    if (iter == cur->children.end()) {
+    if (edge == last || edge->key != key) {
         state = kui_tree_state::NOT_FOUND;
-        cur = NULL;
+        cur = -1;
     } else {
-        cur = iter->second;
+        cur = edge->node;
 
-        if (iter->second->children.size() == 0) {
+        if (nodes[cur].num_edges == 0) {
             state = kui_tree_state::FOUND;
         }
 
-        if (iter->second->macro_value) {
+        if (nodes[cur].macro_value) {
             found = 1;
-            found_node = iter->second;
+            found_node = cur;
             *map_found = 1;
         }
     }
@@ -2,6 +2,7 @@
 #define __KUI_TREE_H__
 
 #include <memory>
+#include <vector>
 
 /* Doxygen headers {{{ */
 /*!
@@ -159,19 +160,45 @@ private:
     void insert(node_ptr_type node, const int *klist, kui_map *data);
     void erase (node_ptr_type node, const int *klist);
 
+    /* Rebuild the flat form of the tree that push_key walks */
+    void compile();
+
+    /* A node of the flat tree */
+    struct flat_node {
+        /* The map reached at this node, or nullptr */
+        kui_map *macro_value;
+        /* Index of the node's first edge in edges */
+        int first_edge;
+        /* Number of edges (children) the node has */
+        int num_edges;
+    };
+
+    /* An edge of the flat tree. The edges of a node are sorted by key. */
+    struct flat_edge {
+        /* The key that leads to the child */
+        int key;
+        /* Index of the child in nodes */
+        int node;
+    };
+
     /* The root of the tree */
     node_ptr_type root;
 
-    /* The current position pointing into the tree (while looking for a map) */
-    node_ptr_type cur;
+    /* The tree flattened in breadth first order, the root is nodes[0].
+     * Matching only touches these two arrays. They are rebuilt on the
+     * next reset_state after the tree is modified. */
+    std::vector<flat_node> nodes;
+    std::vector<flat_edge> edges;
+    /* True if the tree was modified since the flat tree was built */
+    bool dirty;
 
+    /* The current position in nodes (while looking for a map), or -1 */
+    int cur;
     /* The last node found while looking for a map. */
     /* This happens because maps can be subsets of other maps. */
-    node_ptr_type found_node;
-
+    int found_node;
     /* The internal state of the tree (still looking, map found, not found) */
     kui_tree_state state;
-
     /* If a map was found, this is set to 1 while looking, otherwise 0. */
     int found;
 };
@@ -137,7 +137,6 @@ static int stdin_input()
 {
     char buf[MAXLINE];
     size_t size;
-    size_t i;
 
     size = read(STDIN_FILENO, buf, MAXLINE - 1);
     if (size == -1) {
@@ -152,9 +151,7 @@ static int stdin_input()
      * when displaying the filedlg. If it does get called, then the 
      * gdb window gets displayed when the filedlg is up
      */
-    for (i = 0; i < size; ++i) {
-        tgdb_send_char(tgdb, buf[i]);
-    }
+    tgdb_send_chars(tgdb, buf, size);
 
     return 0;
 }
@@ -162,10 +159,14 @@ static int stdin_input()
 int main_loop(int gdbfd, int mifd)
 {
     int max;
-    fd_set rfds;
+    fd_set rfds, wfds;
     int result;
 
     while (!gdb_quit) {
+        /* The input for gdb is written together, before waiting */
+        if (tgdb_flush(tgdb) == -1)
+            return -1;
+
         max = (gdbfd > STDIN_FILENO) ? gdbfd : STDIN_FILENO;
         max = (max > mifd) ? max : mifd;
 
@@ -178,13 +179,20 @@ int main_loop(int gdbfd, int mifd)
          *
          */
         FD_ZERO(&rfds);
+        FD_ZERO(&wfds);
 
         /* Let the terminal emulate the char's when TGDB is busy */
         FD_SET(STDIN_FILENO, &rfds);
         FD_SET(gdbfd, &rfds);
         FD_SET(mifd, &rfds);
 
-        result = select(max + 1, &rfds, NULL, NULL, NULL);
+        /* Wait for gdb to take the rest of what was sent to it */
+        if (tgdb_has_pending_output(tgdb)) {
+            FD_SET(gdbfd, &wfds);
+            FD_SET(mifd, &wfds);
+        }
+
+        result = select(max + 1, &rfds, &wfds, NULL, NULL);
 
         /* if the signal interrupted system call keep going */
         if (result == -1 && errno == EINTR)
@@ -213,11 +221,8 @@ int main_loop(int gdbfd, int mifd)
 }
 
 void console_output(void *context, const std::string &str) {
-    std::string::const_iterator iter = str.begin();
-    for (; iter != str.end(); ++iter) {
-        if (write(STDOUT_FILENO, &*iter, 1) != 1) {
-            clog_error(CLOG_CGDB, "could not write byte");
-        }
+    if (io_writen(STDOUT_FILENO, str.data(), str.size()) == -1) {
+        clog_error(CLOG_CGDB, "could not write bytes");
     }
 }
 
@@ -245,14 +250,21 @@ void inferiors_source_files(void *context,
 static
 void disassemble_func(void *context,
         uint64_t addr_start, uint64_t addr_end, bool error,
-        const std::list<std::string> &disasm)
+        const std::list<tgdb_disasm_line> &disasm)
 {
 }
 
 static
 void disassemble_pc(void *context,
         uint64_t addr_start, uint64_t addr_end, bool error,
-        const std::list<std::string> &disasm)
+        const std::list<tgdb_disasm_line> &disasm)
+{
+}
+
+static
+void disassemble_range(void *context,
+        uint64_t addr_start, uint64_t addr_end, bool error,
+        const std::list<tgdb_disasm_line> &disasm)
 {
 }
 
@@ -262,6 +274,86 @@ void update_file_pos(void *context,
 {
 }
 
+static
+void stack_frames(void *context, int low, int high, bool error,
+        const std::list<tgdb_frame> &frames)
+{
+}
+
+static
+void stack_changed(void *context)
+{
+}
+
+static
+void frame_changed(void *context)
+{
+}
+
+static
+void stack_variables(void *context, bool error,
+        const std::list<std::string> &names)
+{
+}
+
+static
+void var_created(void *context, const std::string &name, bool error,
+        const tgdb_varobj &varobj)
+{
+}
+
+static
+void var_children(void *context, const std::string &name, bool error,
+        const std::list<tgdb_varobj> &children)
+{
+}
+
+static
+void var_changes(void *context, bool error,
+        const std::list<tgdb_varobj_change> &changes)
+{
+}
+
+static
+void register_names(void *context, bool error,
+        const std::list<tgdb_register> &registers)
+{
+}
+
+static
+void changed_registers(void *context, bool error,
+        const std::list<int> &numbers)
+{
+}
+
+static
+void register_values(void *context, bool error,
+        const std::list<tgdb_register> &registers)
+{
+}
+
+static
+void memory(void *context, const std::string &addr, uint64_t start,
+        int count, bool error, const std::list<tgdb_memory_block> &blocks)
+{
+}
+
+static
+void threads_changed(void *context)
+{
+}
+
+static
+void thread_info(void *context, int id, bool error,
+        const tgdb_thread_info &info)
+{
+}
+
+static
+void gdb_started(void *context)
+{
+}
+
 
 tgdb_callbacks callbacks = {
     NULL,
@@ -271,12 +363,64 @@ tgdb_callbacks callbacks = {
     inferiors_source_files,
     disassemble_func,
     disassemble_pc,
-    update_file_pos
+    disassemble_range,
+    update_file_pos,
+    stack_frames,
+    stack_changed,
+    frame_changed,
+    stack_variables,
+    var_created,
+    var_children,
+    var_changes,
+    register_names,
+    changed_registers,
+    register_values,
+    memory,
+    threads_changed,
+    thread_info,
+    gdb_started
 };
 
+static double now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/**
+ * Feed a recording through tgdb without starting gdb, and report how long
+ * it took on stderr.
+ *
+ * @param path
+ * The recording made with --record
+ *
+ * @return
+ * 0 on success or -1 on error
+ */
+static int replay(const char *path)
+{
+    double start = now();
+
+    if (tgdb_replay(tgdb, path) == -1) {
+        fprintf(stderr, "Unable to replay %s\n", path);
+        return -1;
+    }
+
+    fprintf(stderr, "Replayed %s in %.3f seconds\n", path, now() - start);
+    return 0;
+}
+
+/**
+ * Usage: tgdb_driver [--record file] [gdb options]
+ *        tgdb_driver --replay file
+ */
 int main(int argc, char **argv)
 {
     int gdb_console_fd, gdb_mi_fd;
+    const char *record_path = NULL;
+    const char *replay_path = NULL;
 
 #if 0
     int c;
@@ -284,6 +428,14 @@ int main(int argc, char **argv)
     read(0, &c, 1);
 #endif
 
+    if (argc > 2 && strcmp(argv[1], "--record") == 0) {
+        record_path = argv[2];
+        argc -= 2;
+        argv += 2;
+    } else if (argc > 2 && strcmp(argv[1], "--replay") == 0) {
+        replay_path = argv[2];
+    }
+
     start_logging();
 
     /* Set all clog levels to debug */
@@ -299,6 +451,17 @@ int main(int argc, char **argv)
         goto driver_end;
     }
 
+    if (replay_path) {
+        replay(replay_path);
+        tgdb_shutdown(tgdb);
+        goto driver_end;
+    }
+
+    if (record_path && tgdb_record_start(tgdb, record_path) == -1) {
+        fprintf(stderr, "Unable to record to %s\n", record_path);
+        goto driver_end;
+    }
+
     if (tgdb_start_gdb(tgdb, NULL, argc - 1, argv + 1, 0, 0,
             &gdb_console_fd, &gdb_mi_fd ) == -1) {
         clog_error(CLOG_CGDB, "tgdb_start error");
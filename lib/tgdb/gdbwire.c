@@ -1512,6 +1512,56 @@ enum gdbwire_mi_result_kind {
     GDBWIRE_MI_LIST
 };
 
+/**
+ * The keys of GDB/MI results that gdbwire knows.
+ *
+ * The key of each result is looked up with a perfect hash when the result
+ * is parsed, so the commands and the front end match fields by comparing
+ * integers, not strings.
+ */
+enum gdbwire_mi_key {
+    /** The result has no key, or one gdbwire doesn't know */
+    GDBWIRE_MI_KEY_UNKNOWN,
+    GDBWIRE_MI_KEY_ADDR,
+    GDBWIRE_MI_KEY_ARG,
+    GDBWIRE_MI_KEY_BEGIN,
+    GDBWIRE_MI_KEY_CHANGELIST,
+    GDBWIRE_MI_KEY_CHILD,
+    GDBWIRE_MI_KEY_CHILDREN,
+    GDBWIRE_MI_KEY_CONTENTS,
+    GDBWIRE_MI_KEY_CORE,
+    GDBWIRE_MI_KEY_CURRENT_THREAD_ID,
+    GDBWIRE_MI_KEY_END,
+    GDBWIRE_MI_KEY_EXP,
+    GDBWIRE_MI_KEY_FILE,
+    GDBWIRE_MI_KEY_FRAME,
+    GDBWIRE_MI_KEY_FROM,
+    GDBWIRE_MI_KEY_FULLNAME,
+    GDBWIRE_MI_KEY_FUNC,
+    GDBWIRE_MI_KEY_GROUP_ID,
+    GDBWIRE_MI_KEY_ID,
+    GDBWIRE_MI_KEY_IN_SCOPE,
+    GDBWIRE_MI_KEY_LEVEL,
+    GDBWIRE_MI_KEY_LINE,
+    GDBWIRE_MI_KEY_MEMORY,
+    GDBWIRE_MI_KEY_NAME,
+    GDBWIRE_MI_KEY_NEW_THREAD_ID,
+    GDBWIRE_MI_KEY_NEW_NUM_CHILDREN,
+    GDBWIRE_MI_KEY_NEW_TYPE,
+    GDBWIRE_MI_KEY_NUMCHILD,
+    GDBWIRE_MI_KEY_OFFSET,
+    GDBWIRE_MI_KEY_STACK,
+    GDBWIRE_MI_KEY_STATE,
+    GDBWIRE_MI_KEY_STOPPED_THREADS,
+    GDBWIRE_MI_KEY_TARGET_ID,
+    GDBWIRE_MI_KEY_THREAD_ID,
+    GDBWIRE_MI_KEY_THREADS,
+    GDBWIRE_MI_KEY_TYPE,
+    GDBWIRE_MI_KEY_TYPE_CHANGED,
+    GDBWIRE_MI_KEY_VALUE,
+    GDBWIRE_MI_KEY_VARIABLES
+};
+
 /**
  * A GDB/MI result list.
  *
@@ -1531,6 +1581,9 @@ struct gdbwire_mi_result {
     /** The key being described by the result. */
     char *variable;
 
+    /** The key of the result, from variable. */
+    enum gdbwire_mi_key key;
+
     union {
         /** When kind is GDBWIRE_MI_CSTRING */
         char *cstring;
@@ -2045,6 +2098,17 @@ void gdbwire_mi_result_record_free(struct gdbwire_mi_result_record *param);
 struct gdbwire_mi_result *gdbwire_mi_result_alloc(void);
 void gdbwire_mi_result_free(struct gdbwire_mi_result *param);
 
+/**
+ * Look up the key of a result.
+ *
+ * @param variable
+ * The variable of the result, OK to pass in NULL.
+ *
+ * @return
+ * The key, or GDBWIRE_MI_KEY_UNKNOWN if variable isn't a key gdbwire knows.
+ */
+enum gdbwire_mi_key gdbwire_mi_key_lookup(const char *variable);
+
 /* struct gdbwire_mi_oob_record */
 struct gdbwire_mi_oob_record *gdbwire_mi_oob_record_alloc(void);
 void gdbwire_mi_oob_record_free(struct gdbwire_mi_oob_record *param);
@@ -2125,6 +2189,96 @@ gdbwire_mi_result_record_free(struct gdbwire_mi_result_record *param)
     }
 }
 
+/* The names of the keys, by enum gdbwire_mi_key */
+static const char *gdbwire_mi_key_names[] = {
+    NULL,
+    "addr",
+    "arg",
+    "begin",
+    "changelist",
+    "child",
+    "children",
+    "contents",
+    "core",
+    "current-thread-id",
+    "end",
+    "exp",
+    "file",
+    "frame",
+    "from",
+    "fullname",
+    "func",
+    "group-id",
+    "id",
+    "in_scope",
+    "level",
+    "line",
+    "memory",
+    "name",
+    "new-thread-id",
+    "new_num_children",
+    "new_type",
+    "numchild",
+    "offset",
+    "stack",
+    "state",
+    "stopped-threads",
+    "target-id",
+    "thread-id",
+    "threads",
+    "type",
+    "type_changed",
+    "value",
+    "variables"
+};
+
+/**
+ * The key that hashes to each slot, GDBWIRE_MI_KEY_UNKNOWN if none.
+ *
+ * The hash is FNV-1a with a seed picked so that no two keys share a slot.
+ * When a key is added, a new seed must be picked the same way.
+ */
+static const unsigned char gdbwire_mi_key_slots[128] = {
+    25,  0,  0, 35,  0,  0, 20,  0, 23,  0,  0, 34, 10,  0,  6,  0,
+     0,  1,  0,  0,  0, 16,  0, 11,  0,  0, 24,  0,  0,  0, 18, 12,
+    14, 28,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 33,
+     0,  9,  0,  2, 37,  0,  0,  0,  0,  0, 13,  0,  0,  0,  0,  0,
+     0, 30,  0, 32,  0, 22,  0,  0,  0,  0,  3,  0,  0,  0,  0,  0,
+    29,  0, 19,  0,  0,  0,  0, 38,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0, 31,  0,  0,  0,  0,  5,  7,  0, 26,  0,  0,
+    21, 36,  0,  0,  0,  0,  0,  8,  0,  4, 17, 15,  0,  0,  0, 27
+};
+
+/* The seed that spreads the keys in gdbwire_mi_key_slots */
+#define GDBWIRE_MI_KEY_SEED 0x811c9f32u
+
+enum gdbwire_mi_key
+gdbwire_mi_key_lookup(const char *variable)
+{
+    unsigned int hash = GDBWIRE_MI_KEY_SEED;
+    const char *cur;
+    int key;
+
+    if (!variable) {
+        return GDBWIRE_MI_KEY_UNKNOWN;
+    }
+
+    for (cur = variable; *cur; ++cur) {
+        hash ^= (unsigned char)*cur;
+        hash *= 16777619u;
+    }
+
+    /* The top bits of the hash are mixed best */
+    key = gdbwire_mi_key_slots[(hash >> 25) & 127];
+
+    /* One compare tells a key from another string in its slot */
+    if (key && strcmp(gdbwire_mi_key_names[key], variable) != 0) {
+        key = GDBWIRE_MI_KEY_UNKNOWN;
+    }
+
+    return (enum gdbwire_mi_key)key;
+}
+
 /* struct gdbwire_mi_result */
 struct gdbwire_mi_result *
 gdbwire_mi_result_alloc(void)
@@ -2308,11 +2462,36 @@ enum gdbwire_mi_command_kind {
 
     /* -stack-info-frame */
     GDBWIRE_MI_STACK_INFO_FRAME,
+    /* -stack-list-frames */
+    GDBWIRE_MI_STACK_LIST_FRAMES,
+    /* -stack-list-variables */
+    GDBWIRE_MI_STACK_LIST_VARIABLES,
+
+    /* -var-create */
+    GDBWIRE_MI_VAR_CREATE,
+    /* -var-list-children */
+    GDBWIRE_MI_VAR_LIST_CHILDREN,
+    /* -var-update */
+    GDBWIRE_MI_VAR_UPDATE,
 
     /* -file-list-exec-source-file */
     GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILE,
     /* -file-list-exec-source-files */
-    GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILES
+    GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILES,
+
+    /* -data-disassemble */
+    GDBWIRE_MI_DATA_DISASSEMBLE,
+    /* -data-list-register-names */
+    GDBWIRE_MI_DATA_LIST_REGISTER_NAMES,
+    /* -data-list-changed-registers */
+    GDBWIRE_MI_DATA_LIST_CHANGED_REGISTERS,
+    /* -data-list-register-values */
+    GDBWIRE_MI_DATA_LIST_REGISTER_VALUES,
+    /* -data-read-memory-bytes */
+    GDBWIRE_MI_DATA_READ_MEMORY_BYTES,
+
+    /* -thread-info */
+    GDBWIRE_MI_THREAD_INFO
 };
 
 /**
@@ -2538,22 +2717,22 @@ struct gdbwire_mi_stack_frame {
      *
      * May be NULL if GDB can not determine the frame address.
      */
-    char *address;
+    const char *address;
 
    /**
     * The function name for the frame. May be NULL if unknown.
     */
-   char *func;
+   const char *func;
 
    /**
     * The file name for the frame. May be NULL if unknown.
     */
-   char *file;
+   const char *file;
 
    /**
     * The fullname name for the frame. May be NULL if unknown.
     */
-   char *fullname;
+   const char *fullname;
 
    /**
     * Line number corresponding to the $pc. Maybe be 0 if unknown.
@@ -2566,7 +2745,214 @@ struct gdbwire_mi_stack_frame {
     * This is only given if the frame's function is not known. 
     * May be NULL if unknown.
     */
-   char *from;
+   const char *from;
+
+   /** The next frame in a list of frames or NULL if no more. */
+   struct gdbwire_mi_stack_frame *next;
+};
+
+/** A local variable or argument of a frame, from -stack-list-variables. */
+struct gdbwire_mi_variable {
+    /** The name of the variable, never NULL */
+    const char *name;
+
+    /** True if the variable is an argument of the function */
+    char arg:1;
+
+    /**
+     * The value of the variable.
+     *
+     * Only given with --all-values, or with --simple-values for variables
+     * of simple types, otherwise NULL.
+     */
+    const char *value;
+
+    /** The next variable or NULL if no more. */
+    struct gdbwire_mi_variable *next;
+};
+
+/** A variable object, from the -var-create and -var-list-children commands. */
+struct gdbwire_mi_varobj {
+    /** The name GDB knows the variable object by, never NULL */
+    const char *name;
+
+    /**
+     * What the child is of its parent, like a field name or an index.
+     *
+     * Only given for children, otherwise NULL.
+     */
+    const char *exp;
+
+    /** The number of children the variable object has */
+    int numchild;
+
+    /** The value of the variable object, NULL if not given */
+    const char *value;
+
+    /**
+     * The type of the variable object.
+     *
+     * NULL if not given, like for the public, private and protected
+     * children C++ classes have.
+     */
+    const char *type;
+
+    /** The next variable object or NULL if no more. */
+    struct gdbwire_mi_varobj *next;
+};
+
+/** If a variable object can still be evaluated, from -var-update. */
+enum gdbwire_mi_varobj_in_scope_kind {
+    /** The variable object can be evaluated */
+    GDBWIRE_MI_VAROBJ_IN_SCOPE,
+    /** The variable object can't be evaluated now, its value is stale */
+    GDBWIRE_MI_VAROBJ_NOT_IN_SCOPE,
+    /** The variable object can never be evaluated again, delete it */
+    GDBWIRE_MI_VAROBJ_INVALID
+};
+
+/** A variable object that changed, from the -var-update command. */
+struct gdbwire_mi_varobj_change {
+    /** The name GDB knows the variable object by, never NULL */
+    const char *name;
+
+    /**
+     * The new value of the variable object.
+     *
+     * Only given with --all-values, or with --simple-values for variable
+     * objects of simple types, otherwise NULL.
+     */
+    const char *value;
+
+    /** If the variable object can still be evaluated */
+    enum gdbwire_mi_varobj_in_scope_kind in_scope;
+
+    /**
+     * True if the type of the variable object changed.
+     *
+     * GDB deletes the children of the variable object when this happens.
+     */
+    char type_changed:1;
+
+    /** The new type when type_changed is true, otherwise NULL */
+    const char *new_type;
+
+    /** The new number of children, or -1 if it did not change */
+    int new_num_children;
+
+    /** The next change or NULL if no more. */
+    struct gdbwire_mi_varobj_change *next;
+};
+
+/**
+ * A register, from the -data-list-register-names,
+ * -data-list-changed-registers and -data-list-register-values commands.
+ */
+struct gdbwire_mi_register {
+    /** The number GDB knows the register by */
+    int number;
+
+    /** The name of the register, only from -data-list-register-names */
+    char *name;
+
+    /** The value of the register, only from -data-list-register-values */
+    char *value;
+
+    /** The next register or NULL if no more. */
+    struct gdbwire_mi_register *next;
+};
+
+/**
+ * A block of memory that could be read, from -data-read-memory-bytes.
+ *
+ * The memory that couldn't be read is left out, so there may be several
+ * blocks with gaps between them.
+ */
+struct gdbwire_mi_memory_block {
+    /** The address of the first byte of the block, never NULL */
+    const char *begin;
+
+    /** The offset of begin from the address that was read, never NULL */
+    const char *offset;
+
+    /** The address after the last byte of the block, never NULL */
+    const char *end;
+
+    /** The bytes of the block, two hex digits per byte, never NULL */
+    const char *contents;
+
+    /** The next block or NULL if no more. */
+    struct gdbwire_mi_memory_block *next;
+};
+
+/** A thread, from the -thread-info command. */
+struct gdbwire_mi_thread {
+    /** The global number GDB knows the thread by */
+    int id;
+
+    /** The target's name for the thread, like "Thread 0x7f (LWP 42)" */
+    const char *target_id;
+
+    /** The name of the thread, NULL if it has none */
+    const char *name;
+
+    /** True if the thread is running, false if it is stopped */
+    char running:1;
+
+    /** The core the thread was last seen on, -1 if unknown */
+    int core;
+
+    /** The innermost frame of the thread, NULL while it is running */
+    struct gdbwire_mi_stack_frame *frame;
+
+    /** The next thread or NULL if no more. */
+    struct gdbwire_mi_thread *next;
+};
+
+/** An instruction from the -data-disassemble command. */
+struct gdbwire_mi_asm_insn {
+    /** The address of the instruction, never NULL */
+    char *address;
+
+    /** The function the instruction is in, NULL if unknown */
+    char *func_name;
+
+    /** The offset of the instruction into func_name */
+    unsigned long offset;
+
+    /**
+     * The raw bytes of the instruction in hex, separated by spaces.
+     *
+     * Only given in the raw modes (2, 3 and 5), otherwise NULL.
+     */
+    char *opcodes;
+
+    /** The text of the instruction, never NULL */
+    char *inst;
+
+    /** The next instruction or NULL if no more. */
+    struct gdbwire_mi_asm_insn *next;
+};
+
+/**
+ * A source line and the instructions it was compiled into, from the
+ * -data-disassemble command in the source modes (1, 3, 4 and 5).
+ */
+struct gdbwire_mi_src_and_asm_line {
+    /** The line number in the source file */
+    int line;
+
+    /** The source file, usually a relative path, NULL if unknown */
+    char *file;
+
+    /** The source file as an absolute path, NULL if unknown */
+    char *fullname;
+
+    /** The instructions for this line, NULL if none */
+    struct gdbwire_mi_asm_insn *asm_insns;
+
+    /** The next source line or NULL if no more. */
+    struct gdbwire_mi_src_and_asm_line *next;
 };
 
 /**
@@ -2590,6 +2976,36 @@ struct gdbwire_mi_command {
             struct gdbwire_mi_stack_frame *frame;
         } stack_info_frame;
 
+        /** When kind == GDBWIRE_MI_STACK_LIST_FRAMES */
+        struct {
+            /** The frames asked for, innermost first, NULL if none */
+            struct gdbwire_mi_stack_frame *frames;
+        } stack_list_frames;
+
+        /** When kind == GDBWIRE_MI_STACK_LIST_VARIABLES */
+        struct {
+            /** The locals and arguments of the frame, NULL if none */
+            struct gdbwire_mi_variable *variables;
+        } stack_list_variables;
+
+        /** When kind == GDBWIRE_MI_VAR_CREATE */
+        struct {
+            /** The new variable object, never NULL */
+            struct gdbwire_mi_varobj *varobj;
+        } var_create;
+
+        /** When kind == GDBWIRE_MI_VAR_LIST_CHILDREN */
+        struct {
+            /** The children of the variable object, NULL if none */
+            struct gdbwire_mi_varobj *children;
+        } var_list_children;
+
+        /** When kind == GDBWIRE_MI_VAR_UPDATE */
+        struct {
+            /** The variable objects that changed, NULL if none */
+            struct gdbwire_mi_varobj_change *changes;
+        } var_update;
+
         /** When kind == GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILE */
         struct {
             /**
@@ -2645,6 +3061,59 @@ struct gdbwire_mi_command {
              */
             struct gdbwire_mi_source_file *files;
         } file_list_exec_source_files;
+
+        /** When kind == GDBWIRE_MI_DATA_DISASSEMBLE */
+        struct {
+            /**
+             * The instructions, when disassembled without source
+             * (mode 0 or 2). NULL if none or in a source mode.
+             */
+            struct gdbwire_mi_asm_insn *asm_insns;
+
+            /**
+             * The source lines, when disassembled with source (mode 1, 3,
+             * 4 or 5). NULL if none or not in a source mode.
+             */
+            struct gdbwire_mi_src_and_asm_line *src_and_asm_lines;
+        } data_disassemble;
+
+        /** When kind == GDBWIRE_MI_DATA_LIST_REGISTER_NAMES */
+        struct {
+            /**
+             * The registers, by number, NULL if none.
+             *
+             * GDB leaves gaps in the register numbers, no register is
+             * given for a number without a name.
+             */
+            struct gdbwire_mi_register *registers;
+        } data_list_register_names;
+
+        /** When kind == GDBWIRE_MI_DATA_LIST_CHANGED_REGISTERS */
+        struct {
+            /** The registers that changed, NULL if none */
+            struct gdbwire_mi_register *registers;
+        } data_list_changed_registers;
+
+        /** When kind == GDBWIRE_MI_DATA_LIST_REGISTER_VALUES */
+        struct {
+            /** The registers asked for with their values, NULL if none */
+            struct gdbwire_mi_register *registers;
+        } data_list_register_values;
+
+        /** When kind == GDBWIRE_MI_DATA_READ_MEMORY_BYTES */
+        struct {
+            /** The blocks that could be read, lowest address first */
+            struct gdbwire_mi_memory_block *blocks;
+        } data_read_memory_bytes;
+
+        /** When kind == GDBWIRE_MI_THREAD_INFO */
+        struct {
+            /** The threads asked for, NULL if none */
+            struct gdbwire_mi_thread *threads;
+
+            /** The id of the selected thread, -1 if none is */
+            int current_thread_id;
+        } thread_info;
         
     } variant;
 };
@@ -2663,6 +3132,10 @@ struct gdbwire_mi_command {
  * from this function. You should free this memory with
  * gdbwire_mi_command_free when you are done with it.
  *
+ * The strings of the stack, variable, variable object, memory and thread
+ * commands aren't copied, they point into result_record. Those commands
+ * must be freed before result_record is.
+ *
  * @return
  * The result of this function.
  */
@@ -2744,69 +3217,227 @@ gdbwire_mi_breakpoints_free(struct gdbwire_mi_breakpoint *breakpoints)
 static void
 gdbwire_mi_stack_frame_free(struct gdbwire_mi_stack_frame *frame)
 {
-    free(frame->address);
-    free(frame->func);
-    free(frame->file);
-    free(frame->fullname);
-    free(frame->from);
     free(frame);
 }
 
 /**
- * Convert a string to an unsigned long.
- *
- * @param str
- * The string to convert.
- *
- * @param num
- * If GDBWIRE_OK is returned, this will be returned as the number.
+ * Free a list of stack frames.
  *
- * @return
- * GDBWIRE_OK on success, and num is valid, or GDBWIRE_LOGIC on failure.
+ * @param frames
+ * The frames to free, OK to pass in NULL.
  */
-static enum gdbwire_result
-gdbwire_string_to_ulong(char *str, unsigned long *num)
+static void
+gdbwire_mi_stack_frames_free(struct gdbwire_mi_stack_frame *frames)
 {
-    enum gdbwire_result result = GDBWIRE_LOGIC;
-    unsigned long int strtol_result;
-    char *end_ptr;
-
-    GDBWIRE_ASSERT(str);
-    GDBWIRE_ASSERT(num);
+    struct gdbwire_mi_stack_frame *tmp, *cur = frames;
+    while (cur) {
+        tmp = cur->next;
+        gdbwire_mi_stack_frame_free(cur);
+        cur = tmp;
+    }
+}
 
-    errno = 0;
-    strtol_result = strtoul(str, &end_ptr, 10);
-    if (errno == 0 && str != end_ptr && *end_ptr == '\0') {
-        *num = strtol_result;
-        result = GDBWIRE_OK;
+/**
+ * Free a variable list.
+ *
+ * @param variables
+ * The variable list to free, OK to pass in NULL.
+ */
+static void
+gdbwire_mi_variables_free(struct gdbwire_mi_variable *variables)
+{
+    struct gdbwire_mi_variable *tmp, *cur = variables;
+    while (cur) {
+        tmp = cur;
+        cur = cur->next;
+        free(tmp);
     }
+}
 
-    return result;
+/**
+ * Free a variable object list.
+ *
+ * @param varobjs
+ * The variable object list to free, OK to pass in NULL.
+ */
+static void
+gdbwire_mi_varobjs_free(struct gdbwire_mi_varobj *varobjs)
+{
+    struct gdbwire_mi_varobj *tmp, *cur = varobjs;
+    while (cur) {
+        tmp = cur;
+        cur = cur->next;
+        free(tmp);
+    }
 }
 
 /**
- * Handle breakpoints from the -break-info command.
+ * Free a variable object change list.
  *
- * @param mi_result
- * The mi parse tree starting from bkpt={...}
+ * @param changes
+ * The change list to free, OK to pass in NULL.
+ */
+static void
+gdbwire_mi_varobj_changes_free(struct gdbwire_mi_varobj_change *changes)
+{
+    struct gdbwire_mi_varobj_change *tmp, *cur = changes;
+    while (cur) {
+        tmp = cur;
+        cur = cur->next;
+        free(tmp);
+    }
+}
+
+/**
+ * Free an instruction list.
  *
- * @param bkpt
- * Allocated breakpoint on way out on success. Otherwise NULL on way out.
+ * @param insns
+ * The instruction list to free, OK to pass in NULL.
+ */
+static void
+gdbwire_mi_asm_insns_free(struct gdbwire_mi_asm_insn *insns)
+{
+    struct gdbwire_mi_asm_insn *tmp, *cur = insns;
+    while (cur) {
+        free(cur->address);
+        free(cur->func_name);
+        free(cur->opcodes);
+        free(cur->inst);
+        tmp = cur;
+        cur = cur->next;
+        free(tmp);
+    }
+}
+
+/**
+ * Free a source and instruction line list.
  *
- * @return
- * GDBWIRE_OK on success and bkpt is an allocated breakpoint. Otherwise
- * the appropriate error code and bkpt will be NULL.
+ * @param lines
+ * The source line list to free, OK to pass in NULL.
  */
-static enum gdbwire_result
-break_info_for_breakpoint(struct gdbwire_mi_result *mi_result,
-        struct gdbwire_mi_breakpoint **bkpt)
+static void
+gdbwire_mi_src_and_asm_lines_free(struct gdbwire_mi_src_and_asm_line *lines)
 {
-    enum gdbwire_result result = GDBWIRE_OK;
+    struct gdbwire_mi_src_and_asm_line *tmp, *cur = lines;
+    while (cur) {
+        free(cur->file);
+        free(cur->fullname);
+        gdbwire_mi_asm_insns_free(cur->asm_insns);
+        tmp = cur;
+        cur = cur->next;
+        free(tmp);
+    }
+}
 
-    struct gdbwire_mi_breakpoint *breakpoint = 0;
+/**
+ * Free a register list.
+ *
+ * @param registers
+ * The register list to free, OK to pass in NULL.
+ */
+static void
+gdbwire_mi_registers_free(struct gdbwire_mi_register *registers)
+{
+    struct gdbwire_mi_register *tmp, *cur = registers;
+    while (cur) {
+        free(cur->name);
+        free(cur->value);
+        tmp = cur;
+        cur = cur->next;
+        free(tmp);
+    }
+}
 
-    char *number = 0;
-    int multi = 0;
+/**
+ * Free a memory block list.
+ *
+ * @param blocks
+ * The memory block list to free, OK to pass in NULL.
+ */
+static void
+gdbwire_mi_memory_blocks_free(struct gdbwire_mi_memory_block *blocks)
+{
+    struct gdbwire_mi_memory_block *tmp, *cur = blocks;
+    while (cur) {
+        tmp = cur;
+        cur = cur->next;
+        free(tmp);
+    }
+}
+
+/**
+ * Free a thread list.
+ *
+ * @param threads
+ * The thread list to free, OK to pass in NULL.
+ */
+static void
+gdbwire_mi_threads_free(struct gdbwire_mi_thread *threads)
+{
+    struct gdbwire_mi_thread *tmp, *cur = threads;
+    while (cur) {
+        gdbwire_mi_stack_frame_free(cur->frame);
+        tmp = cur;
+        cur = cur->next;
+        free(tmp);
+    }
+}
+
+/**
+ * Convert a string to an unsigned long.
+ *
+ * @param str
+ * The string to convert.
+ *
+ * @param num
+ * If GDBWIRE_OK is returned, this will be returned as the number.
+ *
+ * @return
+ * GDBWIRE_OK on success, and num is valid, or GDBWIRE_LOGIC on failure.
+ */
+static enum gdbwire_result
+gdbwire_string_to_ulong(char *str, unsigned long *num)
+{
+    enum gdbwire_result result = GDBWIRE_LOGIC;
+    unsigned long int strtol_result;
+    char *end_ptr;
+
+    GDBWIRE_ASSERT(str);
+    GDBWIRE_ASSERT(num);
+
+    errno = 0;
+    strtol_result = strtoul(str, &end_ptr, 10);
+    if (errno == 0 && str != end_ptr && *end_ptr == '\0') {
+        *num = strtol_result;
+        result = GDBWIRE_OK;
+    }
+
+    return result;
+}
+
+/**
+ * Handle breakpoints from the -break-info command.
+ *
+ * @param mi_result
+ * The mi parse tree starting from bkpt={...}
+ *
+ * @param bkpt
+ * Allocated breakpoint on way out on success. Otherwise NULL on way out.
+ *
+ * @return
+ * GDBWIRE_OK on success and bkpt is an allocated breakpoint. Otherwise
+ * the appropriate error code and bkpt will be NULL.
+ */
+static enum gdbwire_result
+break_info_for_breakpoint(struct gdbwire_mi_result *mi_result,
+        struct gdbwire_mi_breakpoint **bkpt)
+{
+    enum gdbwire_result result = GDBWIRE_OK;
+
+    struct gdbwire_mi_breakpoint *breakpoint = 0;
+
+    char *number = 0;
+    int multi = 0;
     int from_multi = 0;
     char *catch_type = 0;
     int pending = 0;
@@ -3100,22 +3731,1015 @@ break_info(
         result = GDBWIRE_NOMEM;
         goto cleanup;
     }
-    mi_command->variant.break_info.breakpoints = breakpoints;
+    mi_command->variant.break_info.breakpoints = breakpoints;
+
+    *out = mi_command;
+
+    return result;
+
+cleanup:
+    gdbwire_mi_breakpoints_free(breakpoints);
+    return result;
+}
+
+/**
+ * Handle a frame tuple, {level=...,addr=...,func=...}.
+ *
+ * @param mi_result
+ * The mi parse tree of the first field in the tuple.
+ *
+ * @param out
+ * The frame on success, NULL on error.
+ *
+ * @return
+ * GDBWIRE_OK on success, otherwise failure and out is NULL.
+ */
+static enum gdbwire_result
+stack_frame(struct gdbwire_mi_result *mi_result,
+    struct gdbwire_mi_stack_frame **out)
+{
+    struct gdbwire_mi_stack_frame *frame;
+
+    const char *level = 0, *address = 0;
+    const char *func = 0, *file = 0, *fullname = 0, *line = 0, *from = 0;
+
+    *out = 0;
+
+    while (mi_result) {
+        if (mi_result->kind == GDBWIRE_MI_CSTRING) {
+            switch (mi_result->key) {
+                case GDBWIRE_MI_KEY_LEVEL:
+                    level = mi_result->variant.cstring;
+                    break;
+                case GDBWIRE_MI_KEY_ADDR:
+                    address = mi_result->variant.cstring;
+                    break;
+                case GDBWIRE_MI_KEY_FUNC:
+                    func = mi_result->variant.cstring;
+                    break;
+                case GDBWIRE_MI_KEY_FILE:
+                    file = mi_result->variant.cstring;
+                    break;
+                case GDBWIRE_MI_KEY_FULLNAME:
+                    fullname = mi_result->variant.cstring;
+                    break;
+                case GDBWIRE_MI_KEY_LINE:
+                    line = mi_result->variant.cstring;
+                    break;
+                case GDBWIRE_MI_KEY_FROM:
+                    from = mi_result->variant.cstring;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        mi_result = mi_result->next;
+    }
+
+    GDBWIRE_ASSERT(level && address);
+
+    if (strcmp(address, "<unavailable>") == 0) {
+        address = 0;
+    }
+
+    frame = calloc(1, sizeof(struct gdbwire_mi_stack_frame));
+    if (!frame) {
+        return GDBWIRE_NOMEM;
+    }
+
+    frame->level = atoi(level);
+    frame->address = address;
+    frame->func = func;
+    frame->file = file;
+    frame->fullname = fullname;
+    frame->line = (line)?atoi(line):0;
+    frame->from = from;
+
+    *out = frame;
+
+    return GDBWIRE_OK;
+}
+
+/**
+ * Handle the -stack-info-frame command.
+ *
+ * @param result_record
+ * The mi result record that makes up the command output from gdb.
+ *
+ * @param out
+ * The output command, null on error.
+ *
+ * @return
+ * GDBWIRE_OK on success, otherwise failure and out is NULL.
+ */
+static enum gdbwire_result
+stack_info_frame(
+    struct gdbwire_mi_result_record *result_record,
+    struct gdbwire_mi_command **out)
+{
+    enum gdbwire_result result;
+    struct gdbwire_mi_stack_frame *frame;
+    struct gdbwire_mi_result *mi_result;
+    struct gdbwire_mi_command *mi_command = 0;
+
+    *out = 0;
+
+    GDBWIRE_ASSERT(result_record->result_class == GDBWIRE_MI_DONE);
+    GDBWIRE_ASSERT(result_record->result);
+
+    mi_result = result_record->result;
+
+    GDBWIRE_ASSERT(mi_result->kind == GDBWIRE_MI_TUPLE);
+    GDBWIRE_ASSERT(mi_result->key == GDBWIRE_MI_KEY_FRAME);
+    GDBWIRE_ASSERT(mi_result->variant.result);
+    GDBWIRE_ASSERT(!mi_result->next);
+
+    result = stack_frame(mi_result->variant.result, &frame);
+    if (result != GDBWIRE_OK) {
+        return result;
+    }
+
+    mi_command = calloc(1, sizeof(struct gdbwire_mi_command));
+    if (!mi_command) {
+        gdbwire_mi_stack_frame_free(frame);
+        return GDBWIRE_NOMEM;
+    }
+    mi_command->kind = GDBWIRE_MI_STACK_INFO_FRAME;
+    mi_command->variant.stack_info_frame.frame = frame;
+
+    *out = mi_command;
+
+    return GDBWIRE_OK;
+}
+
+/**
+ * Handle the -stack-list-frames command.
+ *
+ *   ^done,stack=[frame={level="0",addr=...},frame={level="1",...}]
+ *
+ * @param result_record
+ * The mi result record that makes up the command output from gdb.
+ *
+ * @param out
+ * The output command, null on error.
+ *
+ * @return
+ * GDBWIRE_OK on success, otherwise failure and out is NULL.
+ */
+static enum gdbwire_result
+stack_list_frames(
+    struct gdbwire_mi_result_record *result_record,
+    struct gdbwire_mi_command **out)
+{
+    enum gdbwire_result result = GDBWIRE_OK;
+    struct gdbwire_mi_result *mi_result;
+    struct gdbwire_mi_stack_frame *frames = 0, *cur_frame = 0, *new_frame;
+
+    *out = 0;
+
+    GDBWIRE_ASSERT(result_record->result_class == GDBWIRE_MI_DONE);
+    GDBWIRE_ASSERT(result_record->result);
+
+    mi_result = result_record->result;
+
+    GDBWIRE_ASSERT(mi_result->kind == GDBWIRE_MI_LIST);
+    GDBWIRE_ASSERT(mi_result->key == GDBWIRE_MI_KEY_STACK);
+
+    mi_result = mi_result->variant.result;
+
+    while (mi_result) {
+        GDBWIRE_ASSERT_GOTO(mi_result->kind == GDBWIRE_MI_TUPLE, result, err);
+        GDBWIRE_ASSERT_GOTO(
+            mi_result->key == GDBWIRE_MI_KEY_FRAME, result, err);
+
+        result = stack_frame(mi_result->variant.result, &new_frame);
+        if (result != GDBWIRE_OK) {
+            goto err;
+        }
+
+        /* Append the frame to the list */
+        if (frames) {
+            cur_frame->next = new_frame;
+            cur_frame = cur_frame->next;
+        } else {
+            frames = cur_frame = new_frame;
+        }
+
+        mi_result = mi_result->next;
+    }
+
+    *out = calloc(1, sizeof(struct gdbwire_mi_command));
+    GDBWIRE_ASSERT_GOTO(*out, result, err);
+    (*out)->kind = GDBWIRE_MI_STACK_LIST_FRAMES;
+    (*out)->variant.stack_list_frames.frames = frames;
+
+    return result;
+
+err:
+    gdbwire_mi_stack_frames_free(frames);
+
+    return result;
+}
+
+/**
+ * Handle the -stack-list-variables command.
+ *
+ *   ^done,variables=[{name="argc",arg="1",value="1"},{name="i"}]
+ *
+ * @param result_record
+ * The mi result record that makes up the command output from gdb.
+ *
+ * @param out
+ * The output command, null on error.
+ *
+ * @return
+ * GDBWIRE_OK on success, otherwise failure and out is NULL.
+ */
+static enum gdbwire_result
+stack_list_variables(
+    struct gdbwire_mi_result_record *result_record,
+    struct gdbwire_mi_command **out)
+{
+    enum gdbwire_result result = GDBWIRE_OK;
+    struct gdbwire_mi_result *mi_result;
+    struct gdbwire_mi_variable *variables = 0, *cur_variable = 0;
+    struct gdbwire_mi_variable *new_variable;
+
+    *out = 0;
+
+    GDBWIRE_ASSERT(result_record->result_class == GDBWIRE_MI_DONE);
+    GDBWIRE_ASSERT(result_record->result);
+
+    mi_result = result_record->result;
+
+    GDBWIRE_ASSERT(mi_result->kind == GDBWIRE_MI_LIST);
+    GDBWIRE_ASSERT(mi_result->key == GDBWIRE_MI_KEY_VARIABLES);
+
+    mi_result = mi_result->variant.result;
+
+    while (mi_result) {
+        struct gdbwire_mi_result *fresult;
+        const char *name = 0, *arg = 0, *value = 0;
+
+        GDBWIRE_ASSERT_GOTO(mi_result->kind == GDBWIRE_MI_TUPLE, result, err);
+
+        for (fresult = mi_result->variant.result; fresult;
+                fresult = fresult->next) {
+            if (fresult->kind == GDBWIRE_MI_CSTRING) {
+                switch (fresult->key) {
+                    case GDBWIRE_MI_KEY_NAME:
+                        name = fresult->variant.cstring;
+                        break;
+                    case GDBWIRE_MI_KEY_ARG:
+                        arg = fresult->variant.cstring;
+                        break;
+                    case GDBWIRE_MI_KEY_VALUE:
+                        value = fresult->variant.cstring;
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+
+        GDBWIRE_ASSERT_GOTO(name, result, err);
+
+        new_variable = calloc(1, sizeof(struct gdbwire_mi_variable));
+        GDBWIRE_ASSERT_GOTO(new_variable, result, err);
+
+        new_variable->name = name;
+        new_variable->arg = arg && strcmp(arg, "1") == 0;
+        new_variable->value = value;
+
+        /* Append the variable to the list */
+        if (variables) {
+            cur_variable->next = new_variable;
+            cur_variable = cur_variable->next;
+        } else {
+            variables = cur_variable = new_variable;
+        }
+
+        mi_result = mi_result->next;
+    }
+
+    *out = calloc(1, sizeof(struct gdbwire_mi_command));
+    GDBWIRE_ASSERT_GOTO(*out, result, err);
+    (*out)->kind = GDBWIRE_MI_STACK_LIST_VARIABLES;
+    (*out)->variant.stack_list_variables.variables = variables;
+
+    return result;
+
+err:
+    gdbwire_mi_variables_free(variables);
+
+    return result;
+}
+
+/**
+ * Handle the fields of a variable object.
+ *
+ * The -var-create command puts them out in the result record itself,
+ * while the -var-list-children command puts them in a child tuple.
+ *
+ *   name="var1",numchild="1",value="{...}",type="struct foo"
+ *
+ * @param mi_result
+ * The mi parse tree of the first field.
+ *
+ * @param out
+ * The variable object on success, NULL on error.
+ *
+ * @return
+ * GDBWIRE_OK on success, otherwise failure and out is NULL.
+ */
+static enum gdbwire_result
+varobj(struct gdbwire_mi_result *mi_result, struct gdbwire_mi_varobj **out)
+{
+    struct gdbwire_mi_varobj *varobj;
+
+    const char *name = 0, *exp = 0, *numchild = 0, *value = 0, *type = 0;
+
+    *out = 0;
+
+    while (mi_result) {
+        if (mi_result->kind == GDBWIRE_MI_CSTRING) {
+            switch (mi_result->key) {
+                case GDBWIRE_MI_KEY_NAME:
+                    name = mi_result->variant.cstring;
+                    break;
+                case GDBWIRE_MI_KEY_EXP:
+                    exp = mi_result->variant.cstring;
+                    break;
+                case GDBWIRE_MI_KEY_NUMCHILD:
+                    numchild = mi_result->variant.cstring;
+                    break;
+                case GDBWIRE_MI_KEY_VALUE:
+                    value = mi_result->variant.cstring;
+                    break;
+                case GDBWIRE_MI_KEY_TYPE:
+                    type = mi_result->variant.cstring;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        mi_result = mi_result->next;
+    }
+
+    GDBWIRE_ASSERT(name);
+
+    varobj = calloc(1, sizeof(struct gdbwire_mi_varobj));
+    if (!varobj) {
+        return GDBWIRE_NOMEM;
+    }
+
+    varobj->name = name;
+    varobj->exp = exp;
+    varobj->numchild = (numchild)?atoi(numchild):0;
+    varobj->value = value;
+    varobj->type = type;
+
+    *out = varobj;
+
+    return GDBWIRE_OK;
+}
+
+/**
+ * Handle the -var-create command.
+ *
+ *   ^done,name="var1",numchild="0",value="1",type="int",has_more="0"
+ *
+ * @param result_record
+ * The mi result record that makes up the command output from gdb.
+ *
+ * @param out
+ * The output command, null on error.
+ *
+ * @return
+ * GDBWIRE_OK on success, otherwise failure and out is NULL.
+ */
+static enum gdbwire_result
+var_create(
+    struct gdbwire_mi_result_record *result_record,
+    struct gdbwire_mi_command **out)
+{
+    enum gdbwire_result result;
+    struct gdbwire_mi_varobj *new_varobj;
+
+    *out = 0;
+
+    GDBWIRE_ASSERT(result_record->result_class == GDBWIRE_MI_DONE);
+    GDBWIRE_ASSERT(result_record->result);
+
+    result = varobj(result_record->result, &new_varobj);
+    if (result != GDBWIRE_OK) {
+        return result;
+    }
+
+    *out = calloc(1, sizeof(struct gdbwire_mi_command));
+    if (!*out) {
+        gdbwire_mi_varobjs_free(new_varobj);
+        return GDBWIRE_NOMEM;
+    }
+    (*out)->kind = GDBWIRE_MI_VAR_CREATE;
+    (*out)->variant.var_create.varobj = new_varobj;
+
+    return GDBWIRE_OK;
+}
+
+/**
+ * Handle the -var-list-children command.
+ *
+ *   ^done,numchild="1",children=[child={name="var1.a",exp="a",...}]
+ *
+ * The children field is left out when there are no children.
+ *
+ * @param result_record
+ * The mi result record that makes up the command output from gdb.
+ *
+ * @param out
+ * The output command, null on error.
+ *
+ * @return
+ * GDBWIRE_OK on success, otherwise failure and out is NULL.
+ */
+static enum gdbwire_result
+var_list_children(
+    struct gdbwire_mi_result_record *result_record,
+    struct gdbwire_mi_command **out)
+{
+    enum gdbwire_result result = GDBWIRE_OK;
+    struct gdbwire_mi_result *mi_result;
+    struct gdbwire_mi_varobj *children = 0, *cur_child = 0, *new_child;
+
+    *out = 0;
+
+    GDBWIRE_ASSERT(result_record->result_class == GDBWIRE_MI_DONE);
+
+    for (mi_result = result_record->result; mi_result;
+            mi_result = mi_result->next) {
+        if (mi_result->kind == GDBWIRE_MI_LIST &&
+                mi_result->key == GDBWIRE_MI_KEY_CHILDREN) {
+            break;
+        }
+    }
+
+    mi_result = (mi_result)?mi_result->variant.result:0;
+
+    while (mi_result) {
+        GDBWIRE_ASSERT_GOTO(mi_result->kind == GDBWIRE_MI_TUPLE, result, err);
+        GDBWIRE_ASSERT_GOTO(
+            mi_result->key == GDBWIRE_MI_KEY_CHILD, result, err);
+
+        result = varobj(mi_result->variant.result, &new_child);
+        if (result != GDBWIRE_OK) {
+            goto err;
+        }
+
+        /* Append the child to the list */
+        if (children) {
+            cur_child->next = new_child;
+            cur_child = cur_child->next;
+        } else {
+            children = cur_child = new_child;
+        }
+
+        mi_result = mi_result->next;
+    }
+
+    *out = calloc(1, sizeof(struct gdbwire_mi_command));
+    GDBWIRE_ASSERT_GOTO(*out, result, err);
+    (*out)->kind = GDBWIRE_MI_VAR_LIST_CHILDREN;
+    (*out)->variant.var_list_children.children = children;
+
+    return result;
+
+err:
+    gdbwire_mi_varobjs_free(children);
+
+    return result;
+}
+
+/**
+ * Handle the -var-update command.
+ *
+ *   ^done,changelist=[{name="var1",value="2",in_scope="true",
+ *       type_changed="false",has_more="0"}]
+ *
+ * @param result_record
+ * The mi result record that makes up the command output from gdb.
+ *
+ * @param out
+ * The output command, null on error.
+ *
+ * @return
+ * GDBWIRE_OK on success, otherwise failure and out is NULL.
+ */
+static enum gdbwire_result
+var_update(
+    struct gdbwire_mi_result_record *result_record,
+    struct gdbwire_mi_command **out)
+{
+    enum gdbwire_result result = GDBWIRE_OK;
+    struct gdbwire_mi_result *mi_result;
+    struct gdbwire_mi_varobj_change *changes = 0, *cur_change = 0;
+    struct gdbwire_mi_varobj_change *new_change;
+
+    *out = 0;
+
+    GDBWIRE_ASSERT(result_record->result_class == GDBWIRE_MI_DONE);
+    GDBWIRE_ASSERT(result_record->result);
+
+    mi_result = result_record->result;
+
+    GDBWIRE_ASSERT(mi_result->kind == GDBWIRE_MI_LIST);
+    GDBWIRE_ASSERT(mi_result->key == GDBWIRE_MI_KEY_CHANGELIST);
+
+    mi_result = mi_result->variant.result;
+
+    while (mi_result) {
+        struct gdbwire_mi_result *fresult;
+        const char *name = 0, *value = 0, *in_scope = 0, *type_changed = 0;
+        const char *new_type = 0, *new_num_children = 0;
+
+        GDBWIRE_ASSERT_GOTO(mi_result->kind == GDBWIRE_MI_TUPLE, result, err);
+
+        for (fresult = mi_result->variant.result; fresult;
+                fresult = fresult->next) {
+            if (fresult->kind == GDBWIRE_MI_CSTRING) {
+                switch (fresult->key) {
+                    case GDBWIRE_MI_KEY_NAME:
+                        name = fresult->variant.cstring;
+                        break;
+                    case GDBWIRE_MI_KEY_VALUE:
+                        value = fresult->variant.cstring;
+                        break;
+                    case GDBWIRE_MI_KEY_IN_SCOPE:
+                        in_scope = fresult->variant.cstring;
+                        break;
+                    case GDBWIRE_MI_KEY_TYPE_CHANGED:
+                        type_changed = fresult->variant.cstring;
+                        break;
+                    case GDBWIRE_MI_KEY_NEW_TYPE:
+                        new_type = fresult->variant.cstring;
+                        break;
+                    case GDBWIRE_MI_KEY_NEW_NUM_CHILDREN:
+                        new_num_children = fresult->variant.cstring;
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+
+        GDBWIRE_ASSERT_GOTO(name, result, err);
+
+        new_change = calloc(1, sizeof(struct gdbwire_mi_varobj_change));
+        GDBWIRE_ASSERT_GOTO(new_change, result, err);
+
+        /* Append the change to the list */
+        if (changes) {
+            cur_change->next = new_change;
+            cur_change = cur_change->next;
+        } else {
+            changes = cur_change = new_change;
+        }
+
+        new_change->name = name;
+        new_change->value = value;
+        new_change->new_type = new_type;
+        new_change->type_changed =
+            type_changed && strcmp(type_changed, "true") == 0;
+        new_change->new_num_children =
+            (new_num_children)?atoi(new_num_children):-1;
+
+        if (in_scope && strcmp(in_scope, "false") == 0) {
+            new_change->in_scope = GDBWIRE_MI_VAROBJ_NOT_IN_SCOPE;
+        } else if (in_scope && strcmp(in_scope, "invalid") == 0) {
+            new_change->in_scope = GDBWIRE_MI_VAROBJ_INVALID;
+        } else {
+            new_change->in_scope = GDBWIRE_MI_VAROBJ_IN_SCOPE;
+        }
+
+        mi_result = mi_result->next;
+    }
+
+    *out = calloc(1, sizeof(struct gdbwire_mi_command));
+    GDBWIRE_ASSERT_GOTO(*out, result, err);
+    (*out)->kind = GDBWIRE_MI_VAR_UPDATE;
+    (*out)->variant.var_update.changes = changes;
+
+    return result;
+
+err:
+    gdbwire_mi_varobj_changes_free(changes);
+
+    return result;
+}
+
+/**
+ * Handle the -file-list-exec-source-file command.
+ *
+ * @param result_record
+ * The mi result record that makes up the command output from gdb.
+ *
+ * @param out
+ * The output command, null on error.
+ *
+ * @return
+ * GDBWIRE_OK on success, otherwise failure and out is NULL.
+ */
+static enum gdbwire_result
+file_list_exec_source_file(
+    struct gdbwire_mi_result_record *result_record,
+    struct gdbwire_mi_command **out)
+{
+    struct gdbwire_mi_result *mi_result;
+    struct gdbwire_mi_command *mi_command = 0;
+
+    char *line = 0, *file = 0, *fullname = 0, *macro_info = 0;
+
+    *out = 0;
+
+    GDBWIRE_ASSERT(result_record->result_class == GDBWIRE_MI_DONE);
+    GDBWIRE_ASSERT(result_record->result);
+
+    mi_result = result_record->result;
+
+    while (mi_result) {
+        if (mi_result->kind == GDBWIRE_MI_CSTRING) {
+            if (strcmp(mi_result->variable, "line") == 0) {
+                line = mi_result->variant.cstring;
+            } else if (strcmp(mi_result->variable, "file") == 0) {
+                file = mi_result->variant.cstring;
+            } else if (strcmp(mi_result->variable, "fullname") == 0) {
+                fullname = mi_result->variant.cstring;
+            } else if (strcmp(mi_result->variable, "macro-info") == 0) {
+                macro_info = mi_result->variant.cstring;
+                GDBWIRE_ASSERT(strlen(macro_info) == 1);
+                GDBWIRE_ASSERT(macro_info[0] == '0' || macro_info[0] == '1');
+            }
+        }
+
+        mi_result = mi_result->next;
+    }
+
+    GDBWIRE_ASSERT(line && file);
+
+    mi_command = calloc(1, sizeof(struct gdbwire_mi_command));
+    if (!mi_command) {
+        return GDBWIRE_NOMEM;
+    }
+
+    mi_command->kind = GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILE;
+    mi_command->variant.file_list_exec_source_file.line = atoi(line);
+    mi_command->variant.file_list_exec_source_file.file = gdbwire_strdup(file);
+    if (!mi_command->variant.file_list_exec_source_file.file) {
+        gdbwire_mi_command_free(mi_command);
+        return GDBWIRE_NOMEM;
+    }
+    mi_command->variant.file_list_exec_source_file.fullname =
+        (fullname)?gdbwire_strdup(fullname):0;
+    if (fullname &&
+        !mi_command->variant.file_list_exec_source_file.fullname) {
+        gdbwire_mi_command_free(mi_command);
+        return GDBWIRE_NOMEM;
+    }
+    mi_command->variant.file_list_exec_source_file.macro_info_exists =
+        macro_info != 0;
+    if (macro_info) {
+        mi_command->variant.file_list_exec_source_file.macro_info =
+            atoi(macro_info);
+    }
+
+    *out = mi_command;
+
+    return GDBWIRE_OK;
+}
+
+/**
+ * Handle the -file-list-exec-source-files command.
+ *
+ * @param result_record
+ * The mi result record that makes up the command output from gdb.
+ *
+ * @param out
+ * The output command, null on error.
+ *
+ * @return
+ * GDBWIRE_OK on success, otherwise failure and out is NULL.
+ */
+static enum gdbwire_result
+file_list_exec_source_files(
+    struct gdbwire_mi_result_record *result_record,
+    struct gdbwire_mi_command **out)
+{
+    enum gdbwire_result result = GDBWIRE_OK;
+    struct gdbwire_mi_result *mi_result;
+    struct gdbwire_mi_source_file *files = 0, *cur_node, *new_node;
+
+    GDBWIRE_ASSERT(result_record->result_class == GDBWIRE_MI_DONE);
+    GDBWIRE_ASSERT(result_record->result);
+
+    mi_result = result_record->result;
+
+    GDBWIRE_ASSERT(mi_result->kind == GDBWIRE_MI_LIST);
+    GDBWIRE_ASSERT(strcmp(mi_result->variable, "files") == 0);
+    GDBWIRE_ASSERT(!mi_result->next);
+
+    mi_result = mi_result->variant.result;
+
+    while (mi_result) {
+        struct gdbwire_mi_result *tuple;
+        char *file = 0, *fullname = 0;
+        enum gdbwire_mi_debug_fully_read_kind debug_fully_read =
+            GDBWIRE_MI_DEBUG_FULLY_READ_UNKNOWN;
+        GDBWIRE_ASSERT_GOTO(mi_result->kind == GDBWIRE_MI_TUPLE, result, err);
+        tuple = mi_result->variant.result;
+
+        while (tuple) {
+            /* file field */
+            GDBWIRE_ASSERT_GOTO(tuple->kind == GDBWIRE_MI_CSTRING, result, err);
+
+            if (strcmp(tuple->variable, "file") == 0) {
+                file = tuple->variant.cstring;
+            } else if (strcmp(tuple->variable, "fullname") == 0) {
+                fullname = tuple->variant.cstring;
+            } else if (strcmp(tuple->variable, "debug-fully-read") == 0) {
+                if (strcmp(tuple->variant.cstring, "false") == 0) {
+                    debug_fully_read =
+                        GDBWIRE_MI_DEBUG_FULLY_READ_FALSE;
+                } else if (strcmp(tuple->variant.cstring, "true") == 0) {
+                    debug_fully_read =
+                        GDBWIRE_MI_DEBUG_FULLY_READ_TRUE;
+                }
+            }
+
+            tuple = tuple->next;
+        }
+
+        // file is required, but fullname and debug_fully_read is not
+        GDBWIRE_ASSERT_GOTO(file, result, err);
+
+        /* Create the new */
+        new_node = calloc(1, sizeof(struct gdbwire_mi_source_file));
+        GDBWIRE_ASSERT_GOTO(new_node, result, err);
+
+        new_node->file = gdbwire_strdup(file);
+        new_node->fullname = (fullname)?gdbwire_strdup(fullname):0;
+        new_node->debug_fully_read = debug_fully_read;
+        new_node->next = 0;
+
+        /* Append the node to the list */
+        if (files) {
+            cur_node->next = new_node;
+            cur_node = cur_node->next;
+        } else {
+            files = cur_node = new_node;
+        }
+
+        GDBWIRE_ASSERT_GOTO(new_node->file && (new_node->fullname || !fullname),
+            result, err);
+
+        mi_result = mi_result->next;
+    }
+
+    *out = calloc(1, sizeof(struct gdbwire_mi_command));
+    GDBWIRE_ASSERT_GOTO(*out, result, err);
+    (*out)->kind = GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILES;
+    (*out)->variant.file_list_exec_source_files.files = files;
+
+    return result;
+
+err:
+    gdbwire_mi_source_files_free(files); 
+
+    return result;
+}
+
+/**
+ * Handle a list of instructions from the -data-disassemble command.
+ *
+ * @param mi_result
+ * The mi parse tree of the first instruction, {address=...,inst=...}
+ *
+ * @param out
+ * The instruction list on success, NULL on the way out on error.
+ *
+ * @return
+ * GDBWIRE_OK on success, otherwise failure and out is NULL.
+ */
+static enum gdbwire_result
+data_disassemble_asm_insns(struct gdbwire_mi_result *mi_result,
+        struct gdbwire_mi_asm_insn **out)
+{
+    enum gdbwire_result result = GDBWIRE_OK;
+    struct gdbwire_mi_asm_insn *insns = 0, *cur_insn = 0, *new_insn;
+
+    *out = 0;
+
+    while (mi_result) {
+        struct gdbwire_mi_result *tuple;
+        char *address = 0, *func_name = 0, *opcodes = 0, *inst = 0;
+        unsigned long offset = 0;
+
+        GDBWIRE_ASSERT_GOTO(mi_result->kind == GDBWIRE_MI_TUPLE, result, err);
+        tuple = mi_result->variant.result;
+
+        while (tuple) {
+            GDBWIRE_ASSERT_GOTO(tuple->kind == GDBWIRE_MI_CSTRING, result, err);
+
+            if (strcmp(tuple->variable, "address") == 0) {
+                address = tuple->variant.cstring;
+            } else if (strcmp(tuple->variable, "func-name") == 0) {
+                func_name = tuple->variant.cstring;
+            } else if (strcmp(tuple->variable, "offset") == 0) {
+                GDBWIRE_ASSERT_GOTO(gdbwire_string_to_ulong(
+                    tuple->variant.cstring, &offset) == GDBWIRE_OK,
+                    result, err);
+            } else if (strcmp(tuple->variable, "opcodes") == 0) {
+                opcodes = tuple->variant.cstring;
+            } else if (strcmp(tuple->variable, "inst") == 0) {
+                inst = tuple->variant.cstring;
+            }
+
+            tuple = tuple->next;
+        }
+
+        // address and inst are required, the rest are not
+        GDBWIRE_ASSERT_GOTO(address && inst, result, err);
+
+        new_insn = calloc(1, sizeof(struct gdbwire_mi_asm_insn));
+        GDBWIRE_ASSERT_GOTO(new_insn, result, err);
+
+        new_insn->address = gdbwire_strdup(address);
+        new_insn->func_name = (func_name)?gdbwire_strdup(func_name):0;
+        new_insn->offset = offset;
+        new_insn->opcodes = (opcodes)?gdbwire_strdup(opcodes):0;
+        new_insn->inst = gdbwire_strdup(inst);
+
+        /* Append the instruction to the list */
+        if (insns) {
+            cur_insn->next = new_insn;
+            cur_insn = cur_insn->next;
+        } else {
+            insns = cur_insn = new_insn;
+        }
+
+        GDBWIRE_ASSERT_GOTO(new_insn->address && new_insn->inst &&
+            (new_insn->func_name || !func_name) &&
+            (new_insn->opcodes || !opcodes), result, err);
+
+        mi_result = mi_result->next;
+    }
+
+    *out = insns;
+
+    return result;
+
+err:
+    gdbwire_mi_asm_insns_free(insns);
+
+    return result;
+}
+
+/**
+ * Handle the -data-disassemble command.
+ *
+ * Without source, the instructions are given directly,
+ *   ^done,asm_insns=[{address=...,inst=...},...]
+ * With source, the instructions are grouped by the line they are from,
+ *   ^done,asm_insns=[src_and_asm_line={line=...,file=...,
+ *       line_asm_insn=[{address=...,inst=...},...]},...]
+ *
+ * @param result_record
+ * The mi result record that makes up the command output from gdb.
+ *
+ * @param out
+ * The output command, null on error.
+ *
+ * @return
+ * GDBWIRE_OK on success, otherwise failure and out is NULL.
+ */
+static enum gdbwire_result
+data_disassemble(
+    struct gdbwire_mi_result_record *result_record,
+    struct gdbwire_mi_command **out)
+{
+    enum gdbwire_result result = GDBWIRE_OK;
+    struct gdbwire_mi_result *mi_result;
+    struct gdbwire_mi_asm_insn *insns = 0;
+    struct gdbwire_mi_src_and_asm_line *lines = 0, *cur_line = 0, *new_line;
+
+    *out = 0;
+
+    GDBWIRE_ASSERT(result_record->result_class == GDBWIRE_MI_DONE);
+    GDBWIRE_ASSERT(result_record->result);
+
+    mi_result = result_record->result;
+
+    GDBWIRE_ASSERT(mi_result->kind == GDBWIRE_MI_LIST);
+    GDBWIRE_ASSERT(strcmp(mi_result->variable, "asm_insns") == 0);
+    GDBWIRE_ASSERT(!mi_result->next);
+
+    mi_result = mi_result->variant.result;
+
+    if (mi_result && !mi_result->variable) {
+        result = data_disassemble_asm_insns(mi_result, &insns);
+        if (result != GDBWIRE_OK) {
+            return result;
+        }
+        mi_result = 0;
+    }
+
+    while (mi_result) {
+        struct gdbwire_mi_result *tuple;
+        char *line = 0, *file = 0, *fullname = 0;
+        struct gdbwire_mi_result *line_asm_insn = 0;
+
+        GDBWIRE_ASSERT_GOTO(mi_result->kind == GDBWIRE_MI_TUPLE, result, err);
+        GDBWIRE_ASSERT_GOTO(mi_result->variable &&
+            strcmp(mi_result->variable, "src_and_asm_line") == 0,
+            result, err);
+        tuple = mi_result->variant.result;
+
+        while (tuple) {
+            if (strcmp(tuple->variable, "line_asm_insn") == 0) {
+                GDBWIRE_ASSERT_GOTO(tuple->kind == GDBWIRE_MI_LIST,
+                    result, err);
+                line_asm_insn = tuple->variant.result;
+            } else if (tuple->kind == GDBWIRE_MI_CSTRING) {
+                if (strcmp(tuple->variable, "line") == 0) {
+                    line = tuple->variant.cstring;
+                } else if (strcmp(tuple->variable, "file") == 0) {
+                    file = tuple->variant.cstring;
+                } else if (strcmp(tuple->variable, "fullname") == 0) {
+                    fullname = tuple->variant.cstring;
+                }
+            }
+
+            tuple = tuple->next;
+        }
+
+        GDBWIRE_ASSERT_GOTO(line, result, err);
+
+        new_line = calloc(1, sizeof(struct gdbwire_mi_src_and_asm_line));
+        GDBWIRE_ASSERT_GOTO(new_line, result, err);
+
+        new_line->line = atoi(line);
+        new_line->file = (file)?gdbwire_strdup(file):0;
+        new_line->fullname = (fullname)?gdbwire_strdup(fullname):0;
+
+        /* Append the line to the list */
+        if (lines) {
+            cur_line->next = new_line;
+            cur_line = cur_line->next;
+        } else {
+            lines = cur_line = new_line;
+        }
+
+        GDBWIRE_ASSERT_GOTO((new_line->file || !file) &&
+            (new_line->fullname || !fullname), result, err);
+
+        result = data_disassemble_asm_insns(line_asm_insn,
+            &new_line->asm_insns);
+        if (result != GDBWIRE_OK) {
+            goto err;
+        }
+
+        mi_result = mi_result->next;
+    }
 
-    *out = mi_command;
+    *out = calloc(1, sizeof(struct gdbwire_mi_command));
+    GDBWIRE_ASSERT_GOTO(*out, result, err);
+    (*out)->kind = GDBWIRE_MI_DATA_DISASSEMBLE;
+    (*out)->variant.data_disassemble.asm_insns = insns;
+    (*out)->variant.data_disassemble.src_and_asm_lines = lines;
 
     return result;
 
-cleanup:
-    gdbwire_mi_breakpoints_free(breakpoints);
+err:
+    gdbwire_mi_asm_insns_free(insns);
+    gdbwire_mi_src_and_asm_lines_free(lines);
+
     return result;
 }
 
 /**
- * Handle the -stack-info-frame command.
+ * Handle the -data-list-register-names, -data-list-changed-registers and
+ * -data-list-register-values GDB/MI commands.
+ *
+ * The register names are a list of strings, where the index is the
+ * register number. The changed registers are a list of register numbers.
+ * The register values are a list of number and value tuples.
  *
  * @param result_record
- * The mi result record that makes up the command output from gdb.
+ * The result record to convert.
+ *
+ * @param kind
+ * Which of the three commands the result record is for.
  *
  * @param out
  * The output command, null on error.
@@ -3124,99 +4748,124 @@ cleanup:
  * GDBWIRE_OK on success, otherwise failure and out is NULL.
  */
 static enum gdbwire_result
-stack_info_frame(
+data_list_registers(
     struct gdbwire_mi_result_record *result_record,
+    enum gdbwire_mi_command_kind kind,
     struct gdbwire_mi_command **out)
 {
-    struct gdbwire_mi_stack_frame *frame;
+    enum gdbwire_result result = GDBWIRE_OK;
     struct gdbwire_mi_result *mi_result;
-    struct gdbwire_mi_command *mi_command = 0;
-
-    char *level = 0, *address = 0;
-    char *func = 0, *file = 0, *fullname = 0, *line = 0, *from = 0;
+    struct gdbwire_mi_register *registers = 0, *cur_register = 0;
+    struct gdbwire_mi_register *new_register;
+    const char *variable;
+    unsigned long index = 0;
 
     *out = 0;
 
     GDBWIRE_ASSERT(result_record->result_class == GDBWIRE_MI_DONE);
     GDBWIRE_ASSERT(result_record->result);
 
+    if (kind == GDBWIRE_MI_DATA_LIST_REGISTER_NAMES) {
+        variable = "register-names";
+    } else if (kind == GDBWIRE_MI_DATA_LIST_CHANGED_REGISTERS) {
+        variable = "changed-registers";
+    } else {
+        variable = "register-values";
+    }
+
     mi_result = result_record->result;
 
-    GDBWIRE_ASSERT(mi_result->kind == GDBWIRE_MI_TUPLE);
-    GDBWIRE_ASSERT(strcmp(mi_result->variable, "frame") == 0);
-    GDBWIRE_ASSERT(mi_result->variant.result);
-    GDBWIRE_ASSERT(!mi_result->next);
+    GDBWIRE_ASSERT(mi_result->kind == GDBWIRE_MI_LIST);
+    GDBWIRE_ASSERT(strcmp(mi_result->variable, variable) == 0);
+
     mi_result = mi_result->variant.result;
 
-    while (mi_result) {
-        if (mi_result->kind == GDBWIRE_MI_CSTRING) {
-            if (strcmp(mi_result->variable, "level") == 0) {
-                level = mi_result->variant.cstring;
-            } else if (strcmp(mi_result->variable, "addr") == 0) {
-                address = mi_result->variant.cstring;
-            } else if (strcmp(mi_result->variable, "func") == 0) {
-                func = mi_result->variant.cstring;
-            } else if (strcmp(mi_result->variable, "file") == 0) {
-                file = mi_result->variant.cstring;
-            } else if (strcmp(mi_result->variable, "fullname") == 0) {
-                fullname = mi_result->variant.cstring;
-            } else if (strcmp(mi_result->variable, "line") == 0) {
-                line = mi_result->variant.cstring;
-            } else if (strcmp(mi_result->variable, "from") == 0) {
-                from = mi_result->variant.cstring;
+    for (; mi_result; mi_result = mi_result->next, ++index) {
+        char *name = 0, *value = 0;
+        unsigned long number = index;
+
+        if (kind == GDBWIRE_MI_DATA_LIST_REGISTER_NAMES) {
+            GDBWIRE_ASSERT_GOTO(mi_result->kind == GDBWIRE_MI_CSTRING,
+                result, err);
+            name = mi_result->variant.cstring;
+
+            /* A gap in the register numbers */
+            if (!name[0]) {
+                continue;
+            }
+        } else if (kind == GDBWIRE_MI_DATA_LIST_CHANGED_REGISTERS) {
+            GDBWIRE_ASSERT_GOTO(mi_result->kind == GDBWIRE_MI_CSTRING,
+                result, err);
+            GDBWIRE_ASSERT_GOTO(gdbwire_string_to_ulong(
+                mi_result->variant.cstring, &number) == GDBWIRE_OK,
+                result, err);
+        } else {
+            struct gdbwire_mi_result *fresult;
+            char *num = 0;
+
+            GDBWIRE_ASSERT_GOTO(mi_result->kind == GDBWIRE_MI_TUPLE,
+                result, err);
+
+            for (fresult = mi_result->variant.result; fresult;
+                    fresult = fresult->next) {
+                if (fresult->kind == GDBWIRE_MI_CSTRING && fresult->variable) {
+                    if (strcmp(fresult->variable, "number") == 0) {
+                        num = fresult->variant.cstring;
+                    } else if (strcmp(fresult->variable, "value") == 0) {
+                        value = fresult->variant.cstring;
+                    }
+                }
             }
+
+            GDBWIRE_ASSERT_GOTO(num && value, result, err);
+            GDBWIRE_ASSERT_GOTO(gdbwire_string_to_ulong(num, &number) ==
+                GDBWIRE_OK, result, err);
         }
 
-        mi_result = mi_result->next;
-    }
+        new_register = calloc(1, sizeof(struct gdbwire_mi_register));
+        GDBWIRE_ASSERT_GOTO(new_register, result, err);
 
-    GDBWIRE_ASSERT(level && address);
+        new_register->number = (int)number;
+        new_register->name = (name)?gdbwire_strdup(name):0;
+        new_register->value = (value)?gdbwire_strdup(value):0;
 
-    if (strcmp(address, "<unavailable>") == 0) {
-        address = 0;
-    }
+        /* Append the register to the list */
+        if (registers) {
+            cur_register->next = new_register;
+            cur_register = cur_register->next;
+        } else {
+            registers = cur_register = new_register;
+        }
 
-    frame = calloc(1, sizeof(struct gdbwire_mi_stack_frame));
-    if (!frame) {
-        return GDBWIRE_NOMEM;
+        GDBWIRE_ASSERT_GOTO(!name || new_register->name, result, err);
+        GDBWIRE_ASSERT_GOTO(!value || new_register->value, result, err);
     }
 
-    frame->level = atoi(level);
-    frame->address = (address)?gdbwire_strdup(address):0;
-    frame->func = (func)?gdbwire_strdup(func):0;
-    frame->file = (file)?gdbwire_strdup(file):0;
-    frame->fullname = (fullname)?gdbwire_strdup(fullname):0;
-    frame->line = (line)?atoi(line):0;
-    frame->from = (from)?gdbwire_strdup(from):0;
+    *out = calloc(1, sizeof(struct gdbwire_mi_command));
+    GDBWIRE_ASSERT_GOTO(*out, result, err);
+    (*out)->kind = kind;
 
-    /* Handle the out of memory situation */
-    if ((address && !frame->address) ||
-        (func && !frame->func) ||
-        (file && !frame->file) ||
-        (fullname && !frame->fullname) ||
-        (from && !frame->from)) {
-        gdbwire_mi_stack_frame_free(frame);
-        return GDBWIRE_NOMEM;
+    if (kind == GDBWIRE_MI_DATA_LIST_REGISTER_NAMES) {
+        (*out)->variant.data_list_register_names.registers = registers;
+    } else if (kind == GDBWIRE_MI_DATA_LIST_CHANGED_REGISTERS) {
+        (*out)->variant.data_list_changed_registers.registers = registers;
+    } else {
+        (*out)->variant.data_list_register_values.registers = registers;
     }
 
-    mi_command = calloc(1, sizeof(struct gdbwire_mi_command));
-    if (!mi_command) {
-        gdbwire_mi_stack_frame_free(frame);
-        return GDBWIRE_NOMEM;
-    }
-    mi_command->kind = GDBWIRE_MI_STACK_INFO_FRAME;
-    mi_command->variant.stack_info_frame.frame = frame;
+    return result;
 
-    *out = mi_command;
+err:
+    gdbwire_mi_registers_free(registers);
 
-    return GDBWIRE_OK;
+    return result;
 }
 
 /**
- * Handle the -file-list-exec-source-file command.
+ * Handle the -data-read-memory-bytes GDB/MI command.
  *
  * @param result_record
- * The mi result record that makes up the command output from gdb.
+ * The result record to convert.
  *
  * @param out
  * The output command, null on error.
@@ -3225,14 +4874,14 @@ stack_info_frame(
  * GDBWIRE_OK on success, otherwise failure and out is NULL.
  */
 static enum gdbwire_result
-file_list_exec_source_file(
+data_read_memory_bytes(
     struct gdbwire_mi_result_record *result_record,
     struct gdbwire_mi_command **out)
 {
+    enum gdbwire_result result = GDBWIRE_OK;
     struct gdbwire_mi_result *mi_result;
-    struct gdbwire_mi_command *mi_command = 0;
-
-    char *line = 0, *file = 0, *fullname = 0, *macro_info = 0;
+    struct gdbwire_mi_memory_block *blocks = 0, *cur_block = 0;
+    struct gdbwire_mi_memory_block *new_block;
 
     *out = 0;
 
@@ -3241,62 +4890,78 @@ file_list_exec_source_file(
 
     mi_result = result_record->result;
 
+    GDBWIRE_ASSERT(mi_result->kind == GDBWIRE_MI_LIST);
+    GDBWIRE_ASSERT(mi_result->key == GDBWIRE_MI_KEY_MEMORY);
+
+    mi_result = mi_result->variant.result;
+
     while (mi_result) {
-        if (mi_result->kind == GDBWIRE_MI_CSTRING) {
-            if (strcmp(mi_result->variable, "line") == 0) {
-                line = mi_result->variant.cstring;
-            } else if (strcmp(mi_result->variable, "file") == 0) {
-                file = mi_result->variant.cstring;
-            } else if (strcmp(mi_result->variable, "fullname") == 0) {
-                fullname = mi_result->variant.cstring;
-            } else if (strcmp(mi_result->variable, "macro-info") == 0) {
-                macro_info = mi_result->variant.cstring;
-                GDBWIRE_ASSERT(strlen(macro_info) == 1);
-                GDBWIRE_ASSERT(macro_info[0] == '0' || macro_info[0] == '1');
+        struct gdbwire_mi_result *fresult;
+        const char *begin = 0, *offset = 0, *end = 0, *contents = 0;
+
+        GDBWIRE_ASSERT_GOTO(mi_result->kind == GDBWIRE_MI_TUPLE, result, err);
+
+        for (fresult = mi_result->variant.result; fresult;
+                fresult = fresult->next) {
+            if (fresult->kind == GDBWIRE_MI_CSTRING) {
+                switch (fresult->key) {
+                    case GDBWIRE_MI_KEY_BEGIN:
+                        begin = fresult->variant.cstring;
+                        break;
+                    case GDBWIRE_MI_KEY_OFFSET:
+                        offset = fresult->variant.cstring;
+                        break;
+                    case GDBWIRE_MI_KEY_END:
+                        end = fresult->variant.cstring;
+                        break;
+                    case GDBWIRE_MI_KEY_CONTENTS:
+                        contents = fresult->variant.cstring;
+                        break;
+                    default:
+                        break;
+                }
             }
         }
 
-        mi_result = mi_result->next;
-    }
+        GDBWIRE_ASSERT_GOTO(begin && offset && end && contents, result, err);
 
-    GDBWIRE_ASSERT(line && file);
+        new_block = calloc(1, sizeof(struct gdbwire_mi_memory_block));
+        GDBWIRE_ASSERT_GOTO(new_block, result, err);
 
-    mi_command = calloc(1, sizeof(struct gdbwire_mi_command));
-    if (!mi_command) {
-        return GDBWIRE_NOMEM;
-    }
+        new_block->begin = begin;
+        new_block->offset = offset;
+        new_block->end = end;
+        new_block->contents = contents;
 
-    mi_command->kind = GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILE;
-    mi_command->variant.file_list_exec_source_file.line = atoi(line);
-    mi_command->variant.file_list_exec_source_file.file = gdbwire_strdup(file);
-    if (!mi_command->variant.file_list_exec_source_file.file) {
-        gdbwire_mi_command_free(mi_command);
-        return GDBWIRE_NOMEM;
-    }
-    mi_command->variant.file_list_exec_source_file.fullname =
-        (fullname)?gdbwire_strdup(fullname):0;
-    if (fullname &&
-        !mi_command->variant.file_list_exec_source_file.fullname) {
-        gdbwire_mi_command_free(mi_command);
-        return GDBWIRE_NOMEM;
-    }
-    mi_command->variant.file_list_exec_source_file.macro_info_exists =
-        macro_info != 0;
-    if (macro_info) {
-        mi_command->variant.file_list_exec_source_file.macro_info =
-            atoi(macro_info);
+        /* Append the block to the list */
+        if (blocks) {
+            cur_block->next = new_block;
+            cur_block = cur_block->next;
+        } else {
+            blocks = cur_block = new_block;
+        }
+
+        mi_result = mi_result->next;
     }
 
-    *out = mi_command;
+    *out = calloc(1, sizeof(struct gdbwire_mi_command));
+    GDBWIRE_ASSERT_GOTO(*out, result, err);
+    (*out)->kind = GDBWIRE_MI_DATA_READ_MEMORY_BYTES;
+    (*out)->variant.data_read_memory_bytes.blocks = blocks;
 
-    return GDBWIRE_OK;
+    return result;
+
+err:
+    gdbwire_mi_memory_blocks_free(blocks);
+
+    return result;
 }
 
 /**
- * Handle the -file-list-exec-source-files command.
+ * Handle the -thread-info GDB/MI command.
  *
  * @param result_record
- * The mi result record that makes up the command output from gdb.
+ * The result record to convert.
  *
  * @param out
  * The output command, null on error.
@@ -3305,89 +4970,115 @@ file_list_exec_source_file(
  * GDBWIRE_OK on success, otherwise failure and out is NULL.
  */
 static enum gdbwire_result
-file_list_exec_source_files(
+thread_info(
     struct gdbwire_mi_result_record *result_record,
     struct gdbwire_mi_command **out)
 {
     enum gdbwire_result result = GDBWIRE_OK;
     struct gdbwire_mi_result *mi_result;
-    struct gdbwire_mi_source_file *files = 0, *cur_node, *new_node;
+    struct gdbwire_mi_thread *threads = 0, *cur_thread = 0;
+    struct gdbwire_mi_thread *new_thread;
+    int current_thread_id = -1;
+
+    *out = 0;
 
     GDBWIRE_ASSERT(result_record->result_class == GDBWIRE_MI_DONE);
-    GDBWIRE_ASSERT(result_record->result);
 
-    mi_result = result_record->result;
+    for (mi_result = result_record->result; mi_result;
+            mi_result = mi_result->next) {
+        struct gdbwire_mi_result *tuple;
 
-    GDBWIRE_ASSERT(mi_result->kind == GDBWIRE_MI_LIST);
-    GDBWIRE_ASSERT(strcmp(mi_result->variable, "files") == 0);
-    GDBWIRE_ASSERT(!mi_result->next);
+        if (mi_result->kind == GDBWIRE_MI_CSTRING &&
+                mi_result->key == GDBWIRE_MI_KEY_CURRENT_THREAD_ID) {
+            current_thread_id = atoi(mi_result->variant.cstring);
+            continue;
+        }
 
-    mi_result = mi_result->variant.result;
+        if (mi_result->kind != GDBWIRE_MI_LIST ||
+                mi_result->key != GDBWIRE_MI_KEY_THREADS) {
+            continue;
+        }
 
-    while (mi_result) {
-        struct gdbwire_mi_result *tuple;
-        char *file = 0, *fullname = 0;
-        enum gdbwire_mi_debug_fully_read_kind debug_fully_read =
-            GDBWIRE_MI_DEBUG_FULLY_READ_UNKNOWN;
-        GDBWIRE_ASSERT_GOTO(mi_result->kind == GDBWIRE_MI_TUPLE, result, err);
-        tuple = mi_result->variant.result;
+        for (tuple = mi_result->variant.result; tuple; tuple = tuple->next) {
+            struct gdbwire_mi_result *fresult;
+            struct gdbwire_mi_result *frame = 0;
+            const char *id = 0, *target_id = 0, *name = 0;
+            const char *state = 0, *core = 0;
 
-        while (tuple) {
-            /* file field */
-            GDBWIRE_ASSERT_GOTO(tuple->kind == GDBWIRE_MI_CSTRING, result, err);
+            GDBWIRE_ASSERT_GOTO(tuple->kind == GDBWIRE_MI_TUPLE, result, err);
 
-            if (strcmp(tuple->variable, "file") == 0) {
-                file = tuple->variant.cstring;
-            } else if (strcmp(tuple->variable, "fullname") == 0) {
-                fullname = tuple->variant.cstring;
-            } else if (strcmp(tuple->variable, "debug-fully-read") == 0) {
-                if (strcmp(tuple->variant.cstring, "false") == 0) {
-                    debug_fully_read =
-                        GDBWIRE_MI_DEBUG_FULLY_READ_FALSE;
-                } else if (strcmp(tuple->variant.cstring, "true") == 0) {
-                    debug_fully_read =
-                        GDBWIRE_MI_DEBUG_FULLY_READ_TRUE;
+            for (fresult = tuple->variant.result; fresult;
+                    fresult = fresult->next) {
+                if (fresult->kind == GDBWIRE_MI_TUPLE) {
+                    if (fresult->key == GDBWIRE_MI_KEY_FRAME) {
+                        frame = fresult->variant.result;
+                    }
+                    continue;
                 }
-            }
 
-            tuple = tuple->next;
-        }
+                if (fresult->kind != GDBWIRE_MI_CSTRING) {
+                    continue;
+                }
 
-        // file is required, but fullname and debug_fully_read is not
-        GDBWIRE_ASSERT_GOTO(file, result, err);
+                switch (fresult->key) {
+                    case GDBWIRE_MI_KEY_ID:
+                        id = fresult->variant.cstring;
+                        break;
+                    case GDBWIRE_MI_KEY_TARGET_ID:
+                        target_id = fresult->variant.cstring;
+                        break;
+                    case GDBWIRE_MI_KEY_NAME:
+                        name = fresult->variant.cstring;
+                        break;
+                    case GDBWIRE_MI_KEY_STATE:
+                        state = fresult->variant.cstring;
+                        break;
+                    case GDBWIRE_MI_KEY_CORE:
+                        core = fresult->variant.cstring;
+                        break;
+                    default:
+                        break;
+                }
+            }
 
-        /* Create the new */
-        new_node = calloc(1, sizeof(struct gdbwire_mi_source_file));
-        GDBWIRE_ASSERT_GOTO(new_node, result, err);
+            GDBWIRE_ASSERT_GOTO(id && target_id, result, err);
 
-        new_node->file = gdbwire_strdup(file);
-        new_node->fullname = (fullname)?gdbwire_strdup(fullname):0;
-        new_node->debug_fully_read = debug_fully_read;
-        new_node->next = 0;
+            new_thread = calloc(1, sizeof(struct gdbwire_mi_thread));
+            GDBWIRE_ASSERT_GOTO(new_thread, result, err);
 
-        /* Append the node to the list */
-        if (files) {
-            cur_node->next = new_node;
-            cur_node = cur_node->next;
-        } else {
-            files = cur_node = new_node;
-        }
+            new_thread->id = atoi(id);
+            new_thread->target_id = target_id;
+            new_thread->name = name;
+            new_thread->running = state && strcmp(state, "running") == 0;
+            new_thread->core = (core)?atoi(core):-1;
 
-        GDBWIRE_ASSERT_GOTO(new_node->file && (new_node->fullname || !fullname),
-            result, err);
+            /* Append the thread to the list */
+            if (threads) {
+                cur_thread->next = new_thread;
+                cur_thread = cur_thread->next;
+            } else {
+                threads = cur_thread = new_thread;
+            }
 
-        mi_result = mi_result->next;
+            if (frame) {
+                result = stack_frame(frame, &new_thread->frame);
+                if (result != GDBWIRE_OK) {
+                    goto err;
+                }
+            }
+        }
     }
 
     *out = calloc(1, sizeof(struct gdbwire_mi_command));
     GDBWIRE_ASSERT_GOTO(*out, result, err);
-    (*out)->kind = GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILES;
-    (*out)->variant.file_list_exec_source_files.files = files;
+    (*out)->kind = GDBWIRE_MI_THREAD_INFO;
+    (*out)->variant.thread_info.threads = threads;
+    (*out)->variant.thread_info.current_thread_id = current_thread_id;
 
     return result;
 
 err:
-    gdbwire_mi_source_files_free(files); 
+    gdbwire_mi_threads_free(threads);
 
     return result;
 }
@@ -3411,12 +5102,41 @@ gdbwire_get_mi_command(enum gdbwire_mi_command_kind kind,
         case GDBWIRE_MI_STACK_INFO_FRAME:
             result = stack_info_frame(result_record, out);
             break;
+        case GDBWIRE_MI_STACK_LIST_FRAMES:
+            result = stack_list_frames(result_record, out);
+            break;
+        case GDBWIRE_MI_STACK_LIST_VARIABLES:
+            result = stack_list_variables(result_record, out);
+            break;
+        case GDBWIRE_MI_VAR_CREATE:
+            result = var_create(result_record, out);
+            break;
+        case GDBWIRE_MI_VAR_LIST_CHILDREN:
+            result = var_list_children(result_record, out);
+            break;
+        case GDBWIRE_MI_VAR_UPDATE:
+            result = var_update(result_record, out);
+            break;
         case GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILE:
             result = file_list_exec_source_file(result_record, out);
             break;
         case GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILES:
             result = file_list_exec_source_files(result_record, out);
             break;
+        case GDBWIRE_MI_DATA_DISASSEMBLE:
+            result = data_disassemble(result_record, out);
+            break;
+        case GDBWIRE_MI_DATA_LIST_REGISTER_NAMES:
+        case GDBWIRE_MI_DATA_LIST_CHANGED_REGISTERS:
+        case GDBWIRE_MI_DATA_LIST_REGISTER_VALUES:
+            result = data_list_registers(result_record, kind, out);
+            break;
+        case GDBWIRE_MI_DATA_READ_MEMORY_BYTES:
+            result = data_read_memory_bytes(result_record, out);
+            break;
+        case GDBWIRE_MI_THREAD_INFO:
+            result = thread_info(result_record, out);
+            break;
     }
     
     return result;
@@ -3434,6 +5154,26 @@ void gdbwire_mi_command_free(struct gdbwire_mi_command *mi_command)
                 gdbwire_mi_stack_frame_free(
                     mi_command->variant.stack_info_frame.frame);
                 break;
+            case GDBWIRE_MI_STACK_LIST_FRAMES:
+                gdbwire_mi_stack_frames_free(
+                    mi_command->variant.stack_list_frames.frames);
+                break;
+            case GDBWIRE_MI_STACK_LIST_VARIABLES:
+                gdbwire_mi_variables_free(
+                    mi_command->variant.stack_list_variables.variables);
+                break;
+            case GDBWIRE_MI_VAR_CREATE:
+                gdbwire_mi_varobjs_free(
+                    mi_command->variant.var_create.varobj);
+                break;
+            case GDBWIRE_MI_VAR_LIST_CHILDREN:
+                gdbwire_mi_varobjs_free(
+                    mi_command->variant.var_list_children.children);
+                break;
+            case GDBWIRE_MI_VAR_UPDATE:
+                gdbwire_mi_varobj_changes_free(
+                    mi_command->variant.var_update.changes);
+                break;
             case GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILE:
                 free(mi_command->variant.file_list_exec_source_file.file);
                 free(mi_command->variant.file_list_exec_source_file.fullname);
@@ -3442,6 +5182,32 @@ void gdbwire_mi_command_free(struct gdbwire_mi_command *mi_command)
                 gdbwire_mi_source_files_free(
                     mi_command->variant.file_list_exec_source_files.files);
                 break;
+            case GDBWIRE_MI_DATA_DISASSEMBLE:
+                gdbwire_mi_asm_insns_free(
+                    mi_command->variant.data_disassemble.asm_insns);
+                gdbwire_mi_src_and_asm_lines_free(
+                    mi_command->variant.data_disassemble.src_and_asm_lines);
+                break;
+            case GDBWIRE_MI_DATA_LIST_REGISTER_NAMES:
+                gdbwire_mi_registers_free(
+                    mi_command->variant.data_list_register_names.registers);
+                break;
+            case GDBWIRE_MI_DATA_LIST_CHANGED_REGISTERS:
+                gdbwire_mi_registers_free(
+                    mi_command->variant.data_list_changed_registers.registers);
+                break;
+            case GDBWIRE_MI_DATA_LIST_REGISTER_VALUES:
+                gdbwire_mi_registers_free(
+                    mi_command->variant.data_list_register_values.registers);
+                break;
+            case GDBWIRE_MI_DATA_READ_MEMORY_BYTES:
+                gdbwire_mi_memory_blocks_free(
+                    mi_command->variant.data_read_memory_bytes.blocks);
+                break;
+            case GDBWIRE_MI_THREAD_INFO:
+                gdbwire_mi_threads_free(
+                    mi_command->variant.thread_info.threads);
+                break;
         }
 
         free(mi_command);
@@ -7427,6 +9193,7 @@ yyreduce:
                              {
   (yyval.u_result) = gdbwire_mi_result_alloc();
   (yyval.u_result)->variable = (yyvsp[-1].u_variable);
+  (yyval.u_result)->key = gdbwire_mi_key_lookup((yyval.u_result)->variable);
   (yyval.u_result)->kind = GDBWIRE_MI_CSTRING;
   (yyval.u_result)->variant.cstring = (yyvsp[0].u_cstring);
 }
@@ -7436,6 +9203,7 @@ yyreduce:
                            {
   (yyval.u_result) = gdbwire_mi_result_alloc();
   (yyval.u_result)->variable = (yyvsp[-1].u_variable);
+  (yyval.u_result)->key = gdbwire_mi_key_lookup((yyval.u_result)->variable);
   (yyval.u_result)->kind = GDBWIRE_MI_TUPLE;
   (yyval.u_result)->variant.result = (yyvsp[0].u_tuple);
 }
@@ -7445,6 +9213,7 @@ yyreduce:
                           {
   (yyval.u_result) = gdbwire_mi_result_alloc();
   (yyval.u_result)->variable = (yyvsp[-1].u_variable);
+  (yyval.u_result)->key = gdbwire_mi_key_lookup((yyval.u_result)->variable);
   (yyval.u_result)->kind = GDBWIRE_MI_LIST;
   (yyval.u_result)->variant.result = (yyvsp[0].u_list);
 }
@@ -8114,6 +9883,32 @@ static void gdbwire_interpreter_exec_async_record(void *context,
     ctx->result = GDBWIRE_LOGIC;
 }
 
+/**
+ * If the strings of a command point into the result record it came from.
+ *
+ * @param kind
+ * The kind of command.
+ *
+ * @return
+ * True if the command can't be used after the result record is freed.
+ */
+static int gdbwire_mi_command_borrows(enum gdbwire_mi_command_kind kind)
+{
+    switch (kind) {
+        case GDBWIRE_MI_STACK_INFO_FRAME:
+        case GDBWIRE_MI_STACK_LIST_FRAMES:
+        case GDBWIRE_MI_STACK_LIST_VARIABLES:
+        case GDBWIRE_MI_VAR_CREATE:
+        case GDBWIRE_MI_VAR_LIST_CHILDREN:
+        case GDBWIRE_MI_VAR_UPDATE:
+        case GDBWIRE_MI_DATA_READ_MEMORY_BYTES:
+        case GDBWIRE_MI_THREAD_INFO:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
 static void gdbwire_interpreter_exec_result_record(void *context,
     struct gdbwire_mi_result_record *result_record)
 {
@@ -8123,6 +9918,14 @@ static void gdbwire_interpreter_exec_result_record(void *context,
     if (ctx->result == GDBWIRE_OK) {
         ctx->result = gdbwire_get_mi_command(
             ctx->kind, result_record, &ctx->mi_command);
+
+        /* The command can't point into the record past this callback */
+        if (ctx->result == GDBWIRE_OK &&
+                gdbwire_mi_command_borrows(ctx->kind)) {
+            gdbwire_mi_command_free(ctx->mi_command);
+            ctx->mi_command = 0;
+            ctx->result = GDBWIRE_LOGIC;
+        }
     }
 }
 
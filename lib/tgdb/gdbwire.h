@@ -1139,6 +1139,56 @@ enum gdbwire_mi_result_kind {
     GDBWIRE_MI_LIST
 };
 
+/**
+ * The keys of GDB/MI results that gdbwire knows.
+ *
+ * The key of each result is looked up with a perfect hash when the result
+ * is parsed, so the commands and the front end match fields by comparing
+ * integers, not strings.
+ */
+enum gdbwire_mi_key {
+    /** The result has no key, or one gdbwire doesn't know */
+    GDBWIRE_MI_KEY_UNKNOWN,
+    GDBWIRE_MI_KEY_ADDR,
+    GDBWIRE_MI_KEY_ARG,
+    GDBWIRE_MI_KEY_BEGIN,
+    GDBWIRE_MI_KEY_CHANGELIST,
+    GDBWIRE_MI_KEY_CHILD,
+    GDBWIRE_MI_KEY_CHILDREN,
+    GDBWIRE_MI_KEY_CONTENTS,
+    GDBWIRE_MI_KEY_CORE,
+    GDBWIRE_MI_KEY_CURRENT_THREAD_ID,
+    GDBWIRE_MI_KEY_END,
+    GDBWIRE_MI_KEY_EXP,
+    GDBWIRE_MI_KEY_FILE,
+    GDBWIRE_MI_KEY_FRAME,
+    GDBWIRE_MI_KEY_FROM,
+    GDBWIRE_MI_KEY_FULLNAME,
+    GDBWIRE_MI_KEY_FUNC,
+    GDBWIRE_MI_KEY_GROUP_ID,
+    GDBWIRE_MI_KEY_ID,
+    GDBWIRE_MI_KEY_IN_SCOPE,
+    GDBWIRE_MI_KEY_LEVEL,
+    GDBWIRE_MI_KEY_LINE,
+    GDBWIRE_MI_KEY_MEMORY,
+    GDBWIRE_MI_KEY_NAME,
+    GDBWIRE_MI_KEY_NEW_THREAD_ID,
+    GDBWIRE_MI_KEY_NEW_NUM_CHILDREN,
+    GDBWIRE_MI_KEY_NEW_TYPE,
+    GDBWIRE_MI_KEY_NUMCHILD,
+    GDBWIRE_MI_KEY_OFFSET,
+    GDBWIRE_MI_KEY_STACK,
+    GDBWIRE_MI_KEY_STATE,
+    GDBWIRE_MI_KEY_STOPPED_THREADS,
+    GDBWIRE_MI_KEY_TARGET_ID,
+    GDBWIRE_MI_KEY_THREAD_ID,
+    GDBWIRE_MI_KEY_THREADS,
+    GDBWIRE_MI_KEY_TYPE,
+    GDBWIRE_MI_KEY_TYPE_CHANGED,
+    GDBWIRE_MI_KEY_VALUE,
+    GDBWIRE_MI_KEY_VARIABLES
+};
+
 /**
  * A GDB/MI result list.
  *
@@ -1158,6 +1208,9 @@ struct gdbwire_mi_result {
     /** The key being described by the result. */
     char *variable;
 
+    /** The key of the result, from variable. */
+    enum gdbwire_mi_key key;
+
     union {
         /** When kind is GDBWIRE_MI_CSTRING */
         char *cstring;
@@ -1860,6 +1913,56 @@ enum gdbwire_mi_result_kind {
     GDBWIRE_MI_LIST
 };
 
+/**
+ * The keys of GDB/MI results that gdbwire knows.
+ *
+ * The key of each result is looked up with a perfect hash when the result
+ * is parsed, so the commands and the front end match fields by comparing
+ * integers, not strings.
+ */
+enum gdbwire_mi_key {
+    /** The result has no key, or one gdbwire doesn't know */
+    GDBWIRE_MI_KEY_UNKNOWN,
+    GDBWIRE_MI_KEY_ADDR,
+    GDBWIRE_MI_KEY_ARG,
+    GDBWIRE_MI_KEY_BEGIN,
+    GDBWIRE_MI_KEY_CHANGELIST,
+    GDBWIRE_MI_KEY_CHILD,
+    GDBWIRE_MI_KEY_CHILDREN,
+    GDBWIRE_MI_KEY_CONTENTS,
+    GDBWIRE_MI_KEY_CORE,
+    GDBWIRE_MI_KEY_CURRENT_THREAD_ID,
+    GDBWIRE_MI_KEY_END,
+    GDBWIRE_MI_KEY_EXP,
+    GDBWIRE_MI_KEY_FILE,
+    GDBWIRE_MI_KEY_FRAME,
+    GDBWIRE_MI_KEY_FROM,
+    GDBWIRE_MI_KEY_FULLNAME,
+    GDBWIRE_MI_KEY_FUNC,
+    GDBWIRE_MI_KEY_GROUP_ID,
+    GDBWIRE_MI_KEY_ID,
+    GDBWIRE_MI_KEY_IN_SCOPE,
+    GDBWIRE_MI_KEY_LEVEL,
+    GDBWIRE_MI_KEY_LINE,
+    GDBWIRE_MI_KEY_MEMORY,
+    GDBWIRE_MI_KEY_NAME,
+    GDBWIRE_MI_KEY_NEW_THREAD_ID,
+    GDBWIRE_MI_KEY_NEW_NUM_CHILDREN,
+    GDBWIRE_MI_KEY_NEW_TYPE,
+    GDBWIRE_MI_KEY_NUMCHILD,
+    GDBWIRE_MI_KEY_OFFSET,
+    GDBWIRE_MI_KEY_STACK,
+    GDBWIRE_MI_KEY_STATE,
+    GDBWIRE_MI_KEY_STOPPED_THREADS,
+    GDBWIRE_MI_KEY_TARGET_ID,
+    GDBWIRE_MI_KEY_THREAD_ID,
+    GDBWIRE_MI_KEY_THREADS,
+    GDBWIRE_MI_KEY_TYPE,
+    GDBWIRE_MI_KEY_TYPE_CHANGED,
+    GDBWIRE_MI_KEY_VALUE,
+    GDBWIRE_MI_KEY_VARIABLES
+};
+
 /**
  * A GDB/MI result list.
  *
@@ -1879,6 +1982,9 @@ struct gdbwire_mi_result {
     /** The key being described by the result. */
     char *variable;
 
+    /** The key of the result, from variable. */
+    enum gdbwire_mi_key key;
+
     union {
         /** When kind is GDBWIRE_MI_CSTRING */
         char *cstring;
@@ -2059,11 +2165,36 @@ enum gdbwire_mi_command_kind {
 
     /* -stack-info-frame */
     GDBWIRE_MI_STACK_INFO_FRAME,
+    /* -stack-list-frames */
+    GDBWIRE_MI_STACK_LIST_FRAMES,
+    /* -stack-list-variables */
+    GDBWIRE_MI_STACK_LIST_VARIABLES,
+
+    /* -var-create */
+    GDBWIRE_MI_VAR_CREATE,
+    /* -var-list-children */
+    GDBWIRE_MI_VAR_LIST_CHILDREN,
+    /* -var-update */
+    GDBWIRE_MI_VAR_UPDATE,
 
     /* -file-list-exec-source-file */
     GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILE,
     /* -file-list-exec-source-files */
-    GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILES
+    GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILES,
+
+    /* -data-disassemble */
+    GDBWIRE_MI_DATA_DISASSEMBLE,
+    /* -data-list-register-names */
+    GDBWIRE_MI_DATA_LIST_REGISTER_NAMES,
+    /* -data-list-changed-registers */
+    GDBWIRE_MI_DATA_LIST_CHANGED_REGISTERS,
+    /* -data-list-register-values */
+    GDBWIRE_MI_DATA_LIST_REGISTER_VALUES,
+    /* -data-read-memory-bytes */
+    GDBWIRE_MI_DATA_READ_MEMORY_BYTES,
+
+    /* -thread-info */
+    GDBWIRE_MI_THREAD_INFO
 };
 
 /**
@@ -2289,22 +2420,22 @@ struct gdbwire_mi_stack_frame {
      *
      * May be NULL if GDB can not determine the frame address.
      */
-    char *address;
+    const char *address;
 
    /**
     * The function name for the frame. May be NULL if unknown.
     */
-   char *func;
+   const char *func;
 
    /**
     * The file name for the frame. May be NULL if unknown.
     */
-   char *file;
+   const char *file;
 
    /**
     * The fullname name for the frame. May be NULL if unknown.
     */
-   char *fullname;
+   const char *fullname;
 
    /**
     * Line number corresponding to the $pc. Maybe be 0 if unknown.
@@ -2317,7 +2448,214 @@ struct gdbwire_mi_stack_frame {
     * This is only given if the frame's function is not known. 
     * May be NULL if unknown.
     */
-   char *from;
+   const char *from;
+
+   /** The next frame in a list of frames or NULL if no more. */
+   struct gdbwire_mi_stack_frame *next;
+};
+
+/** A local variable or argument of a frame, from -stack-list-variables. */
+struct gdbwire_mi_variable {
+    /** The name of the variable, never NULL */
+    const char *name;
+
+    /** True if the variable is an argument of the function */
+    char arg:1;
+
+    /**
+     * The value of the variable.
+     *
+     * Only given with --all-values, or with --simple-values for variables
+     * of simple types, otherwise NULL.
+     */
+    const char *value;
+
+    /** The next variable or NULL if no more. */
+    struct gdbwire_mi_variable *next;
+};
+
+/** A variable object, from the -var-create and -var-list-children commands. */
+struct gdbwire_mi_varobj {
+    /** The name GDB knows the variable object by, never NULL */
+    const char *name;
+
+    /**
+     * What the child is of its parent, like a field name or an index.
+     *
+     * Only given for children, otherwise NULL.
+     */
+    const char *exp;
+
+    /** The number of children the variable object has */
+    int numchild;
+
+    /** The value of the variable object, NULL if not given */
+    const char *value;
+
+    /**
+     * The type of the variable object.
+     *
+     * NULL if not given, like for the public, private and protected
+     * children C++ classes have.
+     */
+    const char *type;
+
+    /** The next variable object or NULL if no more. */
+    struct gdbwire_mi_varobj *next;
+};
+
+/** If a variable object can still be evaluated, from -var-update. */
+enum gdbwire_mi_varobj_in_scope_kind {
+    /** The variable object can be evaluated */
+    GDBWIRE_MI_VAROBJ_IN_SCOPE,
+    /** The variable object can't be evaluated now, its value is stale */
+    GDBWIRE_MI_VAROBJ_NOT_IN_SCOPE,
+    /** The variable object can never be evaluated again, delete it */
+    GDBWIRE_MI_VAROBJ_INVALID
+};
+
+/** A variable object that changed, from the -var-update command. */
+struct gdbwire_mi_varobj_change {
+    /** The name GDB knows the variable object by, never NULL */
+    const char *name;
+
+    /**
+     * The new value of the variable object.
+     *
+     * Only given with --all-values, or with --simple-values for variable
+     * objects of simple types, otherwise NULL.
+     */
+    const char *value;
+
+    /** If the variable object can still be evaluated */
+    enum gdbwire_mi_varobj_in_scope_kind in_scope;
+
+    /**
+     * True if the type of the variable object changed.
+     *
+     * GDB deletes the children of the variable object when this happens.
+     */
+    char type_changed:1;
+
+    /** The new type when type_changed is true, otherwise NULL */
+    const char *new_type;
+
+    /** The new number of children, or -1 if it did not change */
+    int new_num_children;
+
+    /** The next change or NULL if no more. */
+    struct gdbwire_mi_varobj_change *next;
+};
+
+/**
+ * A register, from the -data-list-register-names,
+ * -data-list-changed-registers and -data-list-register-values commands.
+ */
+struct gdbwire_mi_register {
+    /** The number GDB knows the register by */
+    int number;
+
+    /** The name of the register, only from -data-list-register-names */
+    char *name;
+
+    /** The value of the register, only from -data-list-register-values */
+    char *value;
+
+    /** The next register or NULL if no more. */
+    struct gdbwire_mi_register *next;
+};
+
+/**
+ * A block of memory that could be read, from -data-read-memory-bytes.
+ *
+ * The memory that couldn't be read is left out, so there may be several
+ * blocks with gaps between them.
+ */
+struct gdbwire_mi_memory_block {
+    /** The address of the first byte of the block, never NULL */
+    const char *begin;
+
+    /** The offset of begin from the address that was read, never NULL */
+    const char *offset;
+
+    /** The address after the last byte of the block, never NULL */
+    const char *end;
+
+    /** The bytes of the block, two hex digits per byte, never NULL */
+    const char *contents;
+
+    /** The next block or NULL if no more. */
+    struct gdbwire_mi_memory_block *next;
+};
+
+/** A thread, from the -thread-info command. */
+struct gdbwire_mi_thread {
+    /** The global number GDB knows the thread by */
+    int id;
+
+    /** The target's name for the thread, like "Thread 0x7f (LWP 42)" */
+    const char *target_id;
+
+    /** The name of the thread, NULL if it has none */
+    const char *name;
+
+    /** True if the thread is running, false if it is stopped */
+    char running:1;
+
+    /** The core the thread was last seen on, -1 if unknown */
+    int core;
+
+    /** The innermost frame of the thread, NULL while it is running */
+    struct gdbwire_mi_stack_frame *frame;
+
+    /** The next thread or NULL if no more. */
+    struct gdbwire_mi_thread *next;
+};
+
+/** An instruction from the -data-disassemble command. */
+struct gdbwire_mi_asm_insn {
+    /** The address of the instruction, never NULL */
+    char *address;
+
+    /** The function the instruction is in, NULL if unknown */
+    char *func_name;
+
+    /** The offset of the instruction into func_name */
+    unsigned long offset;
+
+    /**
+     * The raw bytes of the instruction in hex, separated by spaces.
+     *
+     * Only given in the raw modes (2, 3 and 5), otherwise NULL.
+     */
+    char *opcodes;
+
+    /** The text of the instruction, never NULL */
+    char *inst;
+
+    /** The next instruction or NULL if no more. */
+    struct gdbwire_mi_asm_insn *next;
+};
+
+/**
+ * A source line and the instructions it was compiled into, from the
+ * -data-disassemble command in the source modes (1, 3, 4 and 5).
+ */
+struct gdbwire_mi_src_and_asm_line {
+    /** The line number in the source file */
+    int line;
+
+    /** The source file, usually a relative path, NULL if unknown */
+    char *file;
+
+    /** The source file as an absolute path, NULL if unknown */
+    char *fullname;
+
+    /** The instructions for this line, NULL if none */
+    struct gdbwire_mi_asm_insn *asm_insns;
+
+    /** The next source line or NULL if no more. */
+    struct gdbwire_mi_src_and_asm_line *next;
 };
 
 /**
@@ -2341,6 +2679,36 @@ struct gdbwire_mi_command {
             struct gdbwire_mi_stack_frame *frame;
         } stack_info_frame;
 
+        /** When kind == GDBWIRE_MI_STACK_LIST_FRAMES */
+        struct {
+            /** The frames asked for, innermost first, NULL if none */
+            struct gdbwire_mi_stack_frame *frames;
+        } stack_list_frames;
+
+        /** When kind == GDBWIRE_MI_STACK_LIST_VARIABLES */
+        struct {
+            /** The locals and arguments of the frame, NULL if none */
+            struct gdbwire_mi_variable *variables;
+        } stack_list_variables;
+
+        /** When kind == GDBWIRE_MI_VAR_CREATE */
+        struct {
+            /** The new variable object, never NULL */
+            struct gdbwire_mi_varobj *varobj;
+        } var_create;
+
+        /** When kind == GDBWIRE_MI_VAR_LIST_CHILDREN */
+        struct {
+            /** The children of the variable object, NULL if none */
+            struct gdbwire_mi_varobj *children;
+        } var_list_children;
+
+        /** When kind == GDBWIRE_MI_VAR_UPDATE */
+        struct {
+            /** The variable objects that changed, NULL if none */
+            struct gdbwire_mi_varobj_change *changes;
+        } var_update;
+
         /** When kind == GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILE */
         struct {
             /**
@@ -2396,6 +2764,59 @@ struct gdbwire_mi_command {
              */
             struct gdbwire_mi_source_file *files;
         } file_list_exec_source_files;
+
+        /** When kind == GDBWIRE_MI_DATA_DISASSEMBLE */
+        struct {
+            /**
+             * The instructions, when disassembled without source
+             * (mode 0 or 2). NULL if none or in a source mode.
+             */
+            struct gdbwire_mi_asm_insn *asm_insns;
+
+            /**
+             * The source lines, when disassembled with source (mode 1, 3,
+             * 4 or 5). NULL if none or not in a source mode.
+             */
+            struct gdbwire_mi_src_and_asm_line *src_and_asm_lines;
+        } data_disassemble;
+
+        /** When kind == GDBWIRE_MI_DATA_LIST_REGISTER_NAMES */
+        struct {
+            /**
+             * The registers, by number, NULL if none.
+             *
+             * GDB leaves gaps in the register numbers, no register is
+             * given for a number without a name.
+             */
+            struct gdbwire_mi_register *registers;
+        } data_list_register_names;
+
+        /** When kind == GDBWIRE_MI_DATA_LIST_CHANGED_REGISTERS */
+        struct {
+            /** The registers that changed, NULL if none */
+            struct gdbwire_mi_register *registers;
+        } data_list_changed_registers;
+
+        /** When kind == GDBWIRE_MI_DATA_LIST_REGISTER_VALUES */
+        struct {
+            /** The registers asked for with their values, NULL if none */
+            struct gdbwire_mi_register *registers;
+        } data_list_register_values;
+
+        /** When kind == GDBWIRE_MI_DATA_READ_MEMORY_BYTES */
+        struct {
+            /** The blocks that could be read, lowest address first */
+            struct gdbwire_mi_memory_block *blocks;
+        } data_read_memory_bytes;
+
+        /** When kind == GDBWIRE_MI_THREAD_INFO */
+        struct {
+            /** The threads asked for, NULL if none */
+            struct gdbwire_mi_thread *threads;
+
+            /** The id of the selected thread, -1 if none is */
+            int current_thread_id;
+        } thread_info;
         
     } variant;
 };
@@ -2414,6 +2835,10 @@ struct gdbwire_mi_command {
  * from this function. You should free this memory with
  * gdbwire_mi_command_free when you are done with it.
  *
+ * The strings of the stack, variable, variable object, memory and thread
+ * commands aren't copied, they point into result_record. Those commands
+ * must be freed before result_record is.
+ *
  * @return
  * The result of this function.
  */
@@ -2649,11 +3074,36 @@ enum gdbwire_mi_command_kind {
 
     /* -stack-info-frame */
     GDBWIRE_MI_STACK_INFO_FRAME,
+    /* -stack-list-frames */
+    GDBWIRE_MI_STACK_LIST_FRAMES,
+    /* -stack-list-variables */
+    GDBWIRE_MI_STACK_LIST_VARIABLES,
+
+    /* -var-create */
+    GDBWIRE_MI_VAR_CREATE,
+    /* -var-list-children */
+    GDBWIRE_MI_VAR_LIST_CHILDREN,
+    /* -var-update */
+    GDBWIRE_MI_VAR_UPDATE,
 
     /* -file-list-exec-source-file */
     GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILE,
     /* -file-list-exec-source-files */
-    GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILES
+    GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILES,
+
+    /* -data-disassemble */
+    GDBWIRE_MI_DATA_DISASSEMBLE,
+    /* -data-list-register-names */
+    GDBWIRE_MI_DATA_LIST_REGISTER_NAMES,
+    /* -data-list-changed-registers */
+    GDBWIRE_MI_DATA_LIST_CHANGED_REGISTERS,
+    /* -data-list-register-values */
+    GDBWIRE_MI_DATA_LIST_REGISTER_VALUES,
+    /* -data-read-memory-bytes */
+    GDBWIRE_MI_DATA_READ_MEMORY_BYTES,
+
+    /* -thread-info */
+    GDBWIRE_MI_THREAD_INFO
 };
 
 /**
@@ -2879,22 +3329,22 @@ struct gdbwire_mi_stack_frame {
      *
      * May be NULL if GDB can not determine the frame address.
      */
-    char *address;
+    const char *address;
 
    /**
     * The function name for the frame. May be NULL if unknown.
     */
-   char *func;
+   const char *func;
 
    /**
     * The file name for the frame. May be NULL if unknown.
     */
-   char *file;
+   const char *file;
 
    /**
     * The fullname name for the frame. May be NULL if unknown.
     */
-   char *fullname;
+   const char *fullname;
 
    /**
     * Line number corresponding to the $pc. Maybe be 0 if unknown.
@@ -2907,7 +3357,214 @@ struct gdbwire_mi_stack_frame {
     * This is only given if the frame's function is not known. 
     * May be NULL if unknown.
     */
-   char *from;
+   const char *from;
+
+   /** The next frame in a list of frames or NULL if no more. */
+   struct gdbwire_mi_stack_frame *next;
+};
+
+/** A local variable or argument of a frame, from -stack-list-variables. */
+struct gdbwire_mi_variable {
+    /** The name of the variable, never NULL */
+    const char *name;
+
+    /** True if the variable is an argument of the function */
+    char arg:1;
+
+    /**
+     * The value of the variable.
+     *
+     * Only given with --all-values, or with --simple-values for variables
+     * of simple types, otherwise NULL.
+     */
+    const char *value;
+
+    /** The next variable or NULL if no more. */
+    struct gdbwire_mi_variable *next;
+};
+
+/** A variable object, from the -var-create and -var-list-children commands. */
+struct gdbwire_mi_varobj {
+    /** The name GDB knows the variable object by, never NULL */
+    const char *name;
+
+    /**
+     * What the child is of its parent, like a field name or an index.
+     *
+     * Only given for children, otherwise NULL.
+     */
+    const char *exp;
+
+    /** The number of children the variable object has */
+    int numchild;
+
+    /** The value of the variable object, NULL if not given */
+    const char *value;
+
+    /**
+     * The type of the variable object.
+     *
+     * NULL if not given, like for the public, private and protected
+     * children C++ classes have.
+     */
+    const char *type;
+
+    /** The next variable object or NULL if no more. */
+    struct gdbwire_mi_varobj *next;
+};
+
+/** If a variable object can still be evaluated, from -var-update. */
+enum gdbwire_mi_varobj_in_scope_kind {
+    /** The variable object can be evaluated */
+    GDBWIRE_MI_VAROBJ_IN_SCOPE,
+    /** The variable object can't be evaluated now, its value is stale */
+    GDBWIRE_MI_VAROBJ_NOT_IN_SCOPE,
+    /** The variable object can never be evaluated again, delete it */
+    GDBWIRE_MI_VAROBJ_INVALID
+};
+
+/** A variable object that changed, from the -var-update command. */
+struct gdbwire_mi_varobj_change {
+    /** The name GDB knows the variable object by, never NULL */
+    const char *name;
+
+    /**
+     * The new value of the variable object.
+     *
+     * Only given with --all-values, or with --simple-values for variable
+     * objects of simple types, otherwise NULL.
+     */
+    const char *value;
+
+    /** If the variable object can still be evaluated */
+    enum gdbwire_mi_varobj_in_scope_kind in_scope;
+
+    /**
+     * True if the type of the variable object changed.
+     *
+     * GDB deletes the children of the variable object when this happens.
+     */
+    char type_changed:1;
+
+    /** The new type when type_changed is true, otherwise NULL */
+    const char *new_type;
+
+    /** The new number of children, or -1 if it did not change */
+    int new_num_children;
+
+    /** The next change or NULL if no more. */
+    struct gdbwire_mi_varobj_change *next;
+};
+
+/**
+ * A register, from the -data-list-register-names,
+ * -data-list-changed-registers and -data-list-register-values commands.
+ */
+struct gdbwire_mi_register {
+    /** The number GDB knows the register by */
+    int number;
+
+    /** The name of the register, only from -data-list-register-names */
+    char *name;
+
+    /** The value of the register, only from -data-list-register-values */
+    char *value;
+
+    /** The next register or NULL if no more. */
+    struct gdbwire_mi_register *next;
+};
+
+/**
+ * A block of memory that could be read, from -data-read-memory-bytes.
+ *
+ * The memory that couldn't be read is left out, so there may be several
+ * blocks with gaps between them.
+ */
+struct gdbwire_mi_memory_block {
+    /** The address of the first byte of the block, never NULL */
+    const char *begin;
+
+    /** The offset of begin from the address that was read, never NULL */
+    const char *offset;
+
+    /** The address after the last byte of the block, never NULL */
+    const char *end;
+
+    /** The bytes of the block, two hex digits per byte, never NULL */
+    const char *contents;
+
+    /** The next block or NULL if no more. */
+    struct gdbwire_mi_memory_block *next;
+};
+
+/** A thread, from the -thread-info command. */
+struct gdbwire_mi_thread {
+    /** The global number GDB knows the thread by */
+    int id;
+
+    /** The target's name for the thread, like "Thread 0x7f (LWP 42)" */
+    const char *target_id;
+
+    /** The name of the thread, NULL if it has none */
+    const char *name;
+
+    /** True if the thread is running, false if it is stopped */
+    char running:1;
+
+    /** The core the thread was last seen on, -1 if unknown */
+    int core;
+
+    /** The innermost frame of the thread, NULL while it is running */
+    struct gdbwire_mi_stack_frame *frame;
+
+    /** The next thread or NULL if no more. */
+    struct gdbwire_mi_thread *next;
+};
+
+/** An instruction from the -data-disassemble command. */
+struct gdbwire_mi_asm_insn {
+    /** The address of the instruction, never NULL */
+    char *address;
+
+    /** The function the instruction is in, NULL if unknown */
+    char *func_name;
+
+    /** The offset of the instruction into func_name */
+    unsigned long offset;
+
+    /**
+     * The raw bytes of the instruction in hex, separated by spaces.
+     *
+     * Only given in the raw modes (2, 3 and 5), otherwise NULL.
+     */
+    char *opcodes;
+
+    /** The text of the instruction, never NULL */
+    char *inst;
+
+    /** The next instruction or NULL if no more. */
+    struct gdbwire_mi_asm_insn *next;
+};
+
+/**
+ * A source line and the instructions it was compiled into, from the
+ * -data-disassemble command in the source modes (1, 3, 4 and 5).
+ */
+struct gdbwire_mi_src_and_asm_line {
+    /** The line number in the source file */
+    int line;
+
+    /** The source file, usually a relative path, NULL if unknown */
+    char *file;
+
+    /** The source file as an absolute path, NULL if unknown */
+    char *fullname;
+
+    /** The instructions for this line, NULL if none */
+    struct gdbwire_mi_asm_insn *asm_insns;
+
+    /** The next source line or NULL if no more. */
+    struct gdbwire_mi_src_and_asm_line *next;
 };
 
 /**
@@ -2931,6 +3588,36 @@ struct gdbwire_mi_command {
             struct gdbwire_mi_stack_frame *frame;
         } stack_info_frame;
 
+        /** When kind == GDBWIRE_MI_STACK_LIST_FRAMES */
+        struct {
+            /** The frames asked for, innermost first, NULL if none */
+            struct gdbwire_mi_stack_frame *frames;
+        } stack_list_frames;
+
+        /** When kind == GDBWIRE_MI_STACK_LIST_VARIABLES */
+        struct {
+            /** The locals and arguments of the frame, NULL if none */
+            struct gdbwire_mi_variable *variables;
+        } stack_list_variables;
+
+        /** When kind == GDBWIRE_MI_VAR_CREATE */
+        struct {
+            /** The new variable object, never NULL */
+            struct gdbwire_mi_varobj *varobj;
+        } var_create;
+
+        /** When kind == GDBWIRE_MI_VAR_LIST_CHILDREN */
+        struct {
+            /** The children of the variable object, NULL if none */
+            struct gdbwire_mi_varobj *children;
+        } var_list_children;
+
+        /** When kind == GDBWIRE_MI_VAR_UPDATE */
+        struct {
+            /** The variable objects that changed, NULL if none */
+            struct gdbwire_mi_varobj_change *changes;
+        } var_update;
+
         /** When kind == GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILE */
         struct {
             /**
@@ -2986,6 +3673,59 @@ struct gdbwire_mi_command {
              */
             struct gdbwire_mi_source_file *files;
         } file_list_exec_source_files;
+
+        /** When kind == GDBWIRE_MI_DATA_DISASSEMBLE */
+        struct {
+            /**
+             * The instructions, when disassembled without source
+             * (mode 0 or 2). NULL if none or in a source mode.
+             */
+            struct gdbwire_mi_asm_insn *asm_insns;
+
+            /**
+             * The source lines, when disassembled with source (mode 1, 3,
+             * 4 or 5). NULL if none or not in a source mode.
+             */
+            struct gdbwire_mi_src_and_asm_line *src_and_asm_lines;
+        } data_disassemble;
+
+        /** When kind == GDBWIRE_MI_DATA_LIST_REGISTER_NAMES */
+        struct {
+            /**
+             * The registers, by number, NULL if none.
+             *
+             * GDB leaves gaps in the register numbers, no register is
+             * given for a number without a name.
+             */
+            struct gdbwire_mi_register *registers;
+        } data_list_register_names;
+
+        /** When kind == GDBWIRE_MI_DATA_LIST_CHANGED_REGISTERS */
+        struct {
+            /** The registers that changed, NULL if none */
+            struct gdbwire_mi_register *registers;
+        } data_list_changed_registers;
+
+        /** When kind == GDBWIRE_MI_DATA_LIST_REGISTER_VALUES */
+        struct {
+            /** The registers asked for with their values, NULL if none */
+            struct gdbwire_mi_register *registers;
+        } data_list_register_values;
+
+        /** When kind == GDBWIRE_MI_DATA_READ_MEMORY_BYTES */
+        struct {
+            /** The blocks that could be read, lowest address first */
+            struct gdbwire_mi_memory_block *blocks;
+        } data_read_memory_bytes;
+
+        /** When kind == GDBWIRE_MI_THREAD_INFO */
+        struct {
+            /** The threads asked for, NULL if none */
+            struct gdbwire_mi_thread *threads;
+
+            /** The id of the selected thread, -1 if none is */
+            int current_thread_id;
+        } thread_info;
         
     } variant;
 };
@@ -3004,6 +3744,10 @@ struct gdbwire_mi_command {
  * from this function. You should free this memory with
  * gdbwire_mi_command_free when you are done with it.
  *
+ * The strings of the stack, variable, variable object, memory and thread
+ * commands aren't copied, they point into result_record. Those commands
+ * must be freed before result_record is.
+ *
  * @return
  * The result of this function.
  */
@@ -3193,7 +3937,9 @@ enum gdbwire_result gdbwire_push_data(struct gdbwire *wire, const char *data,
  * The MI output from GDB for the interpreter exec command.
  *
  * @param kind
- * The interpreter-exec command kind.
+ * The interpreter-exec command kind. The commands whose strings point
+ * into the result record, like GDBWIRE_MI_STACK_INFO_FRAME, can't be
+ * interpreted this way since the record is gone when this returns.
  *
  * @param out_mi_command
  * Will return an allocated gdbwire mi command if GDBWIRE_OK is returned
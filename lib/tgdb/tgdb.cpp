@@ -23,11 +23,36 @@
 #include <sys/wait.h>
 #endif
 
+#if HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+
+#if HAVE_SYS_UIO_H
+#include <sys/uio.h>
+#endif
+
+#if HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+
+#if HAVE_ERRNO_H
+#include <errno.h>
+#endif
+
+#if HAVE_LIMITS_H
+#include <limits.h> /* IOV_MAX */
+#endif
+
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
 
+#include <algorithm>
+#include <deque>
+#include <fstream>
 #include <list>
+#include <map>
 #include <sstream>
+#include <vector>
 
 #include "tgdb.h"
 #include "fork_util.h"
@@ -45,6 +70,19 @@
 typedef struct tgdb_request *tgdb_request_ptr;
 typedef std::list<tgdb_request_ptr> tgdb_request_ptr_list;
 
+/**
+ * The bytes waiting to be written to one of GDB's descriptors.
+ *
+ * Each command or group of keystrokes is a chunk. The chunks are written
+ * with a single writev when tgdb_flush is called.
+ */
+struct tgdb_output {
+    std::deque<std::string> chunks;
+
+    /** The number of bytes of the first chunk already written */
+    size_t written;
+};
+
 /**
  * The TGDB context data structure.
  */
@@ -69,6 +107,12 @@ struct tgdb {
     /** The pid of child process */
     pid_t debugger_pid;
 
+    /** The output waiting to be written to debugger_stdin */
+    tgdb_output console_output;
+
+    /** The output waiting to be written to gdb_mi_ui_fd */
+    tgdb_output mi_output;
+
     /** The list of command requests to process */
     tgdb_request_ptr_list *command_requests;
 
@@ -83,6 +127,11 @@ struct tgdb {
      * Basically whether gdb is at prompt or not. */
     int is_gdb_ready_for_next_command;
 
+    /** Non-zero once gdb gave its first prompt, after loading the program.
+     * Until then, the commands for the console are queued too, so they
+     * don't run before the program is loaded. */
+    int gdb_started;
+
     /** If ^c was hit by user */
     sig_atomic_t control_c;
 
@@ -92,9 +141,41 @@ struct tgdb {
     // The current command request type that is executing. NULL to start.
     enum tgdb_request_type current_request_type;
 
-    // The disassemble command output.
-    std::list<std::string> disasm;
-    uint64_t address_start, address_end;
+    // The source files of the inferior, from the last time they were asked for.
+    std::list<std::string> source_files;
+
+    // True if source_files is up to date. GDB can be slow to list the
+    // source files of large programs, so the list is only asked for again
+    // after the objfiles GDB has loaded change.
+    bool source_files_valid;
+
+    // The address range asked for by the running disassemble range request.
+    uint64_t range_start, range_end;
+
+    // The instructions asked for by the running disassemble pc request,
+    // and the memory after the pc it asked GDB for.
+    int disasm_lines;
+    int disasm_bytes;
+
+    // The frames asked for by the running stack frames request.
+    int frames_low, frames_high;
+
+    // The thread the program last stopped in or that was last selected.
+    std::string thread_id;
+
+    // The threads of the program, by increasing id, kept up to date from
+    // the =thread-created, =thread-exited, *running and *stopped records.
+    std::vector<tgdb_thread> threads;
+
+    // The thread the running thread info request is for.
+    int thread_info_id;
+
+    // The variable object the running var create or children request is for.
+    std::string var_name;
+
+    // The memory asked for by the running read memory request.
+    std::string memory_addr;
+    int memory_count;
 
     // The gdbwire context to talk to GDB with.
     struct gdbwire *wire;
@@ -112,6 +193,15 @@ struct tgdb {
     // Temporary buffer used to store the line by line console output
     // in order to search for the unsupported new ui string above.
     std::string *undefined_new_ui_command;
+
+    // The file the traffic to and from GDB is recorded to, or NULL.
+    FILE *record;
+
+    // When the recording started, the recorded times are relative to it.
+    struct timeval record_start;
+
+    // True while a recording is being replayed. Nothing is sent to GDB.
+    bool replaying;
 };
 
 // This is the type of request
@@ -146,6 +236,8 @@ struct tgdb_request {
 
         struct {
             int lines;
+            // The memory after the pc to disassemble
+            int bytes;
         } disassemble;
 
         struct {
@@ -153,6 +245,11 @@ struct tgdb_request {
             int raw;
         } disassemble_func;
 
+        struct {
+            uint64_t start;
+            uint64_t end;
+        } disassemble_range;
+
         struct {
             // The filename to set the breakpoint in
             const char *file;
@@ -161,6 +258,37 @@ struct tgdb_request {
             // The address to set breakpoint in (if file is null)
             uint64_t addr;
         } until_line;
+
+        struct {
+            int low;
+            int high;
+        } stack_frames;
+
+        struct {
+            int level;
+        } select_frame;
+
+        struct {
+            // The name of the variable object
+            const char *name;
+            // The expression to create it for, when creating it
+            const char *expr;
+        } varobj;
+
+        struct {
+            // The register numbers, separated by spaces
+            const char *numbers;
+        } register_values;
+
+        struct {
+            // The expression for the address of the first byte
+            const char *addr;
+            int count;
+        } read_memory;
+
+        struct {
+            int id;
+        } thread;
     } choice;
 };
 
@@ -269,28 +397,232 @@ tgdb_commands_process_info_sources(struct tgdb *tgdb,
     result = gdbwire_get_mi_command(GDBWIRE_MI_FILE_LIST_EXEC_SOURCE_FILES,
         result_record, &mi_command);
     if (result == GDBWIRE_OK) {
-        std::list<std::string> source_files;
         struct gdbwire_mi_source_file *files =
             mi_command->variant.file_list_exec_source_files.files;
+
+        tgdb->source_files.clear();
         while (files) {
             char *file = (files->fullname)?files->fullname:files->file;
-            source_files.push_back(file);
+            tgdb->source_files.push_back(file);
             files = files->next;
         }
+        tgdb->source_files_valid = true;
 
-        tgdb_commands_send_source_files(tgdb, source_files);
+        tgdb_commands_send_source_files(tgdb, tgdb->source_files);
 
         gdbwire_mi_command_free(mi_command);
     }
 }
 
+/**
+ * Add the instructions from -data-disassemble to the disassembly.
+ *
+ * The lines are formatted the way the CLI disassemble command would.
+ *
+ * @param insns
+ * The instructions to add
+ *
+ * @param in_func
+ * True if the whole function is being disassembled, in which case the
+ * function name is left off of the offsets
+ *
+ * @param disasm
+ * The disassembly to add the instructions to
+ *
+ * @param addr_start
+ * Lowered to the address of the first instruction, if 0 it is set
+ *
+ * @param addr_end
+ * Raised to the address of the last instruction
+ */
+static void tgdb_add_disasm_insns(struct gdbwire_mi_asm_insn *insns,
+        bool in_func, std::list<tgdb_disasm_line> &disasm,
+        uint64_t &addr_start, uint64_t &addr_end)
+{
+    for (; insns; insns = insns->next) {
+        tgdb_disasm_line line;
+
+        cgdb_hexstr_to_u64(insns->address, &line.addr);
+
+        line.text = "   ";
+        line.text.append(insns->address);
+        if (insns->func_name) {
+            line.text.append(" <");
+            if (!in_func)
+                line.text.append(insns->func_name);
+            line.text.append("+");
+            line.text.append(std::to_string(insns->offset));
+            line.text.append(">");
+        }
+        line.text.append(":\t");
+        if (insns->opcodes) {
+            line.text.append(insns->opcodes);
+            line.text.append("\t");
+        }
+        line.text.append(insns->inst);
+
+        if (line.addr) {
+            addr_start = addr_start ? MIN(line.addr, addr_start) : line.addr;
+            addr_end = MAX(line.addr, addr_end);
+        }
+
+        disasm.push_back(std::move(line));
+    }
+}
+
+/**
+ * Get the text of a source line from -data-disassemble.
+ *
+ * The line is formatted the way the CLI disassemble /s command would,
+ * or as file:line if the source file can't be read.
+ *
+ * @param files
+ * The source files read so far, by name. A file is read the first time
+ * one of its lines is asked for.
+ *
+ * @param src_line
+ * The source line
+ *
+ * @return
+ * The text of the line
+ */
+static std::string tgdb_disasm_source_text(
+        std::map<std::string, std::vector<std::string>> &files,
+        struct gdbwire_mi_src_and_asm_line *src_line)
+{
+    const char *path = src_line->fullname ? src_line->fullname : src_line->file;
+    std::string text;
+
+    if (path) {
+        auto iter = files.find(path);
+
+        if (iter == files.end()) {
+            std::vector<std::string> &lines = files[path];
+            std::ifstream stream(path);
+
+            while (std::getline(stream, text))
+                lines.push_back(text);
+            iter = files.find(path);
+        }
+
+        if (src_line->line > 0 &&
+            (size_t)src_line->line <= iter->second.size()) {
+            text = std::to_string(src_line->line);
+            text.append("\t");
+            text.append(iter->second[src_line->line - 1]);
+            return text;
+        }
+    }
+
+    text = src_line->file ? src_line->file : "";
+    text.append(":");
+    text.append(std::to_string(src_line->line));
+
+    return text;
+}
+
 static void send_disassemble_func_complete_response(struct tgdb *tgdb,
         struct gdbwire_mi_result_record *result_record)
 {
     bool error = result_record->result_class == GDBWIRE_MI_ERROR;
-    
-    tgdb->callbacks.tgdb_disassemble_func_fn(tgdb->callbacks.context,
-            tgdb->address_start, tgdb->address_end, error, tgdb->disasm);
+    bool in_func = tgdb->current_request_type == TGDB_REQUEST_DISASSEMBLE_FUNC;
+    std::list<tgdb_disasm_line> disasm;
+    uint64_t addr_start = 0, addr_end = 0;
+
+    /* GDB fails the whole request if any of the memory after the pc can't
+     * be read, as at the end of a mapping. Ask again for half as much,
+     * down to a single instruction, before giving up. */
+    if (error && tgdb->current_request_type == TGDB_REQUEST_DISASSEMBLE_PC &&
+        tgdb->disasm_bytes > 15) {
+        tgdb_request_ptr request;
+        request = (tgdb_request_ptr) cgdb_malloc(sizeof (struct tgdb_request));
+        request->header = TGDB_REQUEST_DISASSEMBLE_PC;
+        request->choice.disassemble.lines = tgdb->disasm_lines;
+        request->choice.disassemble.bytes = tgdb->disasm_bytes / 2;
+        tgdb_run_or_queue_request(tgdb, request, true);
+        return;
+    }
+
+    if (!error) {
+        struct gdbwire_mi_command *mi_command = 0;
+        struct gdbwire_mi_src_and_asm_line *src_line;
+        std::map<std::string, std::vector<std::string>> files;
+        const char *func_name = 0;
+        enum gdbwire_result result;
+
+        result = gdbwire_get_mi_command(GDBWIRE_MI_DATA_DISASSEMBLE,
+                result_record, &mi_command);
+        if (result != GDBWIRE_OK) {
+            clog_error(CLOG_CGDB, "Unable to parse the disassembly");
+            error = true;
+        } else {
+            tgdb_add_disasm_insns(
+                    mi_command->variant.data_disassemble.asm_insns,
+                    in_func, disasm, addr_start, addr_end);
+
+            /* Put each source line above the instructions it became */
+            src_line = mi_command->variant.data_disassemble.src_and_asm_lines;
+            for (; src_line; src_line = src_line->next) {
+                tgdb_disasm_line line;
+
+                line.addr = 0;
+                line.text = tgdb_disasm_source_text(files, src_line);
+                disasm.push_back(std::move(line));
+
+                tgdb_add_disasm_insns(src_line->asm_insns,
+                        in_func, disasm, addr_start, addr_end);
+            }
+
+            if (mi_command->variant.data_disassemble.asm_insns) {
+                func_name =
+                    mi_command->variant.data_disassemble.asm_insns->func_name;
+            } else {
+                src_line =
+                    mi_command->variant.data_disassemble.src_and_asm_lines;
+                for (; src_line && !func_name; src_line = src_line->next) {
+                    if (src_line->asm_insns)
+                        func_name = src_line->asm_insns->func_name;
+                }
+            }
+
+            /* Title a function's disassembly as the CLI would */
+            if (in_func && func_name) {
+                tgdb_disasm_line line;
+
+                line.addr = 0;
+                line.text = "Dump of assembler code for function ";
+                line.text.append(func_name);
+                line.text.append(":");
+                disasm.push_front(std::move(line));
+
+                line.text = "End of assembler dump.";
+                disasm.push_back(std::move(line));
+            }
+
+            gdbwire_mi_command_free(mi_command);
+        }
+    }
+
+    switch (tgdb->current_request_type) {
+        case TGDB_REQUEST_DISASSEMBLE_PC:
+            /* The request asks for more memory than the instructions
+             * could need, only the first lines are wanted */
+            while (disasm.size() > (size_t)tgdb->disasm_lines)
+                disasm.pop_back();
+            if (!disasm.empty())
+                addr_end = disasm.back().addr;
+            tgdb->callbacks.tgdb_disassemble_pc_fn(tgdb->callbacks.context,
+                    addr_start, addr_end, error, disasm);
+            break;
+        case TGDB_REQUEST_DISASSEMBLE_RANGE:
+            tgdb->callbacks.tgdb_disassemble_range_fn(tgdb->callbacks.context,
+                    tgdb->range_start, tgdb->range_end, error, disasm);
+            break;
+        default:
+            tgdb->callbacks.tgdb_disassemble_func_fn(tgdb->callbacks.context,
+                    addr_start, addr_end, error, disasm);
+            break;
+    }
 }
 
 static void
@@ -365,52 +697,368 @@ static void tgdb_commands_process_info_frame(struct tgdb *tgdb,
     }
 }
 
-static void gdbwire_stream_record_callback(void *context,
-    struct gdbwire_mi_stream_record *stream_record)
+static void tgdb_commands_convert_frame(tgdb_frame &f,
+        struct gdbwire_mi_stack_frame *frame)
 {
-    struct tgdb *tgdb = (struct tgdb*)context;
+    f.level = frame->level;
+    f.addr = 0;
+    if (frame->address)
+        cgdb_hexstr_to_u64(frame->address, &f.addr);
+    if (frame->func)
+        f.func = frame->func;
+    if (frame->fullname || frame->file)
+        f.path = frame->fullname ? frame->fullname : frame->file;
+    f.line = frame->line;
+    if (frame->from)
+        f.from = frame->from;
+}
 
-    switch (stream_record->kind) {
-        case GDBWIRE_MI_CONSOLE:
-            if (tgdb->current_request_type == TGDB_REQUEST_DISASSEMBLE_PC ||
-                tgdb->current_request_type == TGDB_REQUEST_DISASSEMBLE_FUNC)
-            {
-                uint64_t address;
-                int result;
-                char *str = stream_record->cstring;
-                size_t length = strlen(str);
-                char *colon = 0, colon_char = 0;
-
-                if (str[length-1] == '\n') {
-                    str[length-1] = 0;
-                }
+static void tgdb_commands_process_stack_frames(struct tgdb *tgdb,
+        struct gdbwire_mi_result_record *result_record)
+{
+    std::list<tgdb_frame> frames;
+    bool error = result_record->result_class == GDBWIRE_MI_ERROR;
 
-                /* Trim the gdb current location pointer off */
-                if (length > 2 && str[0] == '=' && str[1] == '>') {
-                    str[0] = ' ';
-                    str[1] = ' ';
-                }
+    if (!error) {
+        enum gdbwire_result result;
+        struct gdbwire_mi_command *mi_command = 0;
+        result = gdbwire_get_mi_command(GDBWIRE_MI_STACK_LIST_FRAMES,
+            result_record, &mi_command);
+        if (result == GDBWIRE_OK) {
+            struct gdbwire_mi_stack_frame *frame =
+                mi_command->variant.stack_list_frames.frames;
 
-                tgdb->disasm.push_back(str);
+            for (; frame; frame = frame->next) {
+                tgdb_frame f;
 
-                colon = strchr((char*)str, ':');
-                if (colon) {
-                    colon_char = *colon;
-                    *colon = 0;
-                }
+                tgdb_commands_convert_frame(f, frame);
+                frames.push_back(f);
+            }
+
+            gdbwire_mi_command_free(mi_command);
+        } else {
+            error = true;
+        }
+    }
 
-                result = cgdb_hexstr_to_u64(str, &address);
+    tgdb->callbacks.tgdb_stack_frames_fn(tgdb->callbacks.context,
+            tgdb->frames_low, tgdb->frames_high, error, frames);
+}
 
-                if (colon) {
-                    *colon = colon_char;
-                }
+static void tgdb_commands_process_stack_variables(struct tgdb *tgdb,
+        struct gdbwire_mi_result_record *result_record)
+{
+    std::list<std::string> names;
+    bool error = result_record->result_class == GDBWIRE_MI_ERROR;
 
-                if (result == 0 && address) {
-                    tgdb->address_start = tgdb->address_start ?
-                         MIN(address, tgdb->address_start) : address;
-                    tgdb->address_end = MAX(address, tgdb->address_end);
-                }
+    if (!error) {
+        enum gdbwire_result result;
+        struct gdbwire_mi_command *mi_command = 0;
+        result = gdbwire_get_mi_command(GDBWIRE_MI_STACK_LIST_VARIABLES,
+            result_record, &mi_command);
+        if (result == GDBWIRE_OK) {
+            struct gdbwire_mi_variable *variable =
+                mi_command->variant.stack_list_variables.variables;
+
+            for (; variable; variable = variable->next)
+                names.push_back(variable->name);
+
+            gdbwire_mi_command_free(mi_command);
+        } else {
+            error = true;
+        }
+    }
+
+    tgdb->callbacks.tgdb_stack_variables_fn(tgdb->callbacks.context,
+            error, names);
+}
+
+static void tgdb_commands_convert_varobj(tgdb_varobj &v,
+        struct gdbwire_mi_varobj *varobj)
+{
+    v.name = varobj->name;
+    v.exp = varobj->exp ? varobj->exp : "";
+    v.value = varobj->value ? varobj->value : "";
+    v.type = varobj->type ? varobj->type : "";
+    v.numchild = varobj->numchild;
+}
+
+static void tgdb_commands_process_var_create(struct tgdb *tgdb,
+        struct gdbwire_mi_result_record *result_record)
+{
+    tgdb_varobj v;
+    bool error = result_record->result_class == GDBWIRE_MI_ERROR;
+
+    v.numchild = 0;
+
+    if (!error) {
+        enum gdbwire_result result;
+        struct gdbwire_mi_command *mi_command = 0;
+        result = gdbwire_get_mi_command(GDBWIRE_MI_VAR_CREATE,
+            result_record, &mi_command);
+        if (result == GDBWIRE_OK) {
+            tgdb_commands_convert_varobj(v,
+                    mi_command->variant.var_create.varobj);
+            gdbwire_mi_command_free(mi_command);
+        } else {
+            error = true;
+        }
+    }
+
+    tgdb->callbacks.tgdb_var_created_fn(tgdb->callbacks.context,
+            tgdb->var_name, error, v);
+}
+
+static void tgdb_commands_process_var_children(struct tgdb *tgdb,
+        struct gdbwire_mi_result_record *result_record)
+{
+    std::list<tgdb_varobj> children;
+    bool error = result_record->result_class == GDBWIRE_MI_ERROR;
+
+    if (!error) {
+        enum gdbwire_result result;
+        struct gdbwire_mi_command *mi_command = 0;
+        result = gdbwire_get_mi_command(GDBWIRE_MI_VAR_LIST_CHILDREN,
+            result_record, &mi_command);
+        if (result == GDBWIRE_OK) {
+            struct gdbwire_mi_varobj *child =
+                mi_command->variant.var_list_children.children;
+
+            for (; child; child = child->next) {
+                tgdb_varobj v;
+                tgdb_commands_convert_varobj(v, child);
+                children.push_back(v);
+            }
+
+            gdbwire_mi_command_free(mi_command);
+        } else {
+            error = true;
+        }
+    }
+
+    tgdb->callbacks.tgdb_var_children_fn(tgdb->callbacks.context,
+            tgdb->var_name, error, children);
+}
+
+static void tgdb_commands_process_var_update(struct tgdb *tgdb,
+        struct gdbwire_mi_result_record *result_record)
+{
+    std::list<tgdb_varobj_change> changes;
+    bool error = result_record->result_class == GDBWIRE_MI_ERROR;
+
+    if (!error) {
+        enum gdbwire_result result;
+        struct gdbwire_mi_command *mi_command = 0;
+        result = gdbwire_get_mi_command(GDBWIRE_MI_VAR_UPDATE,
+            result_record, &mi_command);
+        if (result == GDBWIRE_OK) {
+            struct gdbwire_mi_varobj_change *change =
+                mi_command->variant.var_update.changes;
+
+            for (; change; change = change->next) {
+                tgdb_varobj_change c;
+
+                c.name = change->name;
+                c.value = change->value ? change->value : "";
+                c.in_scope = change->in_scope == GDBWIRE_MI_VAROBJ_IN_SCOPE;
+                c.invalid = change->in_scope == GDBWIRE_MI_VAROBJ_INVALID;
+                c.type_changed = change->type_changed;
+                c.new_type = change->new_type ? change->new_type : "";
+                c.new_num_children = change->new_num_children;
+
+                changes.push_back(c);
+            }
+
+            gdbwire_mi_command_free(mi_command);
+        } else {
+            error = true;
+        }
+    }
+
+    tgdb->callbacks.tgdb_var_changes_fn(tgdb->callbacks.context,
+            error, changes);
+}
+
+static void tgdb_commands_process_registers(struct tgdb *tgdb,
+        struct gdbwire_mi_result_record *result_record)
+{
+    std::list<tgdb_register> registers;
+    bool names = tgdb->current_request_type == TGDB_REQUEST_REGISTER_NAMES;
+    bool error = result_record->result_class == GDBWIRE_MI_ERROR;
+
+    if (!error) {
+        enum gdbwire_result result;
+        struct gdbwire_mi_command *mi_command = 0;
+        result = gdbwire_get_mi_command(names ?
+            GDBWIRE_MI_DATA_LIST_REGISTER_NAMES :
+            GDBWIRE_MI_DATA_LIST_REGISTER_VALUES,
+            result_record, &mi_command);
+        if (result == GDBWIRE_OK) {
+            struct gdbwire_mi_register *reg = names ?
+                mi_command->variant.data_list_register_names.registers :
+                mi_command->variant.data_list_register_values.registers;
+
+            for (; reg; reg = reg->next) {
+                tgdb_register r;
+
+                r.number = reg->number;
+                r.name = reg->name ? reg->name : "";
+                r.value = reg->value ? reg->value : "";
+
+                registers.push_back(r);
+            }
+
+            gdbwire_mi_command_free(mi_command);
+        } else {
+            error = true;
+        }
+    }
+
+    if (names)
+        tgdb->callbacks.tgdb_register_names_fn(tgdb->callbacks.context,
+                error, registers);
+    else
+        tgdb->callbacks.tgdb_register_values_fn(tgdb->callbacks.context,
+                error, registers);
+}
+
+static void tgdb_commands_process_changed_registers(struct tgdb *tgdb,
+        struct gdbwire_mi_result_record *result_record)
+{
+    std::list<int> numbers;
+    bool error = result_record->result_class == GDBWIRE_MI_ERROR;
+
+    if (!error) {
+        enum gdbwire_result result;
+        struct gdbwire_mi_command *mi_command = 0;
+        result = gdbwire_get_mi_command(
+            GDBWIRE_MI_DATA_LIST_CHANGED_REGISTERS,
+            result_record, &mi_command);
+        if (result == GDBWIRE_OK) {
+            struct gdbwire_mi_register *reg =
+                mi_command->variant.data_list_changed_registers.registers;
+
+            for (; reg; reg = reg->next)
+                numbers.push_back(reg->number);
+
+            gdbwire_mi_command_free(mi_command);
+        } else {
+            error = true;
+        }
+    }
+
+    tgdb->callbacks.tgdb_changed_registers_fn(tgdb->callbacks.context,
+            error, numbers);
+}
+
+/* Convert the two hex digit per byte contents GDB sends to bytes */
+static void tgdb_commands_convert_hex(std::vector<unsigned char> &bytes,
+        const char *hex)
+{
+    char digits[3] = { 0, 0, 0 };
+
+    for (; hex[0] && hex[1]; hex += 2) {
+        digits[0] = hex[0];
+        digits[1] = hex[1];
+        bytes.push_back((unsigned char)strtoul(digits, NULL, 16));
+    }
+}
+
+static void tgdb_commands_process_read_memory(struct tgdb *tgdb,
+        struct gdbwire_mi_result_record *result_record)
+{
+    std::list<tgdb_memory_block> blocks;
+    uint64_t start = 0;
+    bool error = result_record->result_class == GDBWIRE_MI_ERROR;
+
+    if (!error) {
+        enum gdbwire_result result;
+        struct gdbwire_mi_command *mi_command = 0;
+        result = gdbwire_get_mi_command(GDBWIRE_MI_DATA_READ_MEMORY_BYTES,
+            result_record, &mi_command);
+        if (result == GDBWIRE_OK) {
+            struct gdbwire_mi_memory_block *block =
+                mi_command->variant.data_read_memory_bytes.blocks;
+
+            /* The offset is from the address that was asked for */
+            if (block)
+                start = strtoull(block->begin, NULL, 16) -
+                    strtoull(block->offset, NULL, 16);
+
+            for (; block; block = block->next) {
+                tgdb_memory_block b;
+
+                b.begin = strtoull(block->begin, NULL, 16);
+                tgdb_commands_convert_hex(b.contents, block->contents);
+
+                blocks.push_back(b);
+            }
+
+            /* None of it could be read */
+            error = blocks.empty();
+
+            gdbwire_mi_command_free(mi_command);
+        } else {
+            error = true;
+        }
+    }
+
+    tgdb->callbacks.tgdb_memory_fn(tgdb->callbacks.context,
+            tgdb->memory_addr, start, tgdb->memory_count, error, blocks);
+}
+
+static void tgdb_commands_process_thread_info(struct tgdb *tgdb,
+        struct gdbwire_mi_result_record *result_record)
+{
+    tgdb_thread_info info;
+    bool error = result_record->result_class == GDBWIRE_MI_ERROR;
+
+    info.id = tgdb->thread_info_id;
+    info.running = false;
+    info.core = -1;
+    info.frame.level = 0;
+    info.frame.addr = 0;
+    info.frame.line = 0;
+
+    if (!error) {
+        enum gdbwire_result result;
+        struct gdbwire_mi_command *mi_command = 0;
+        result = gdbwire_get_mi_command(GDBWIRE_MI_THREAD_INFO,
+            result_record, &mi_command);
+        if (result == GDBWIRE_OK) {
+            struct gdbwire_mi_thread *thread =
+                mi_command->variant.thread_info.threads;
+
+            /* The thread exited */
+            if (!thread) {
+                error = true;
+            } else {
+                info.target_id = thread->target_id;
+                if (thread->name)
+                    info.name = thread->name;
+                info.running = thread->running;
+                info.core = thread->core;
+                if (thread->frame)
+                    tgdb_commands_convert_frame(info.frame, thread->frame);
             }
+
+            gdbwire_mi_command_free(mi_command);
+        } else {
+            error = true;
+        }
+    }
+
+    tgdb->callbacks.tgdb_thread_info_fn(tgdb->callbacks.context,
+            tgdb->thread_info_id, error, info);
+}
+
+static void gdbwire_stream_record_callback(void *context,
+    struct gdbwire_mi_stream_record *stream_record)
+{
+    struct tgdb *tgdb = (struct tgdb*)context;
+
+    switch (stream_record->kind) {
+        case GDBWIRE_MI_CONSOLE:
             break;
         case GDBWIRE_MI_TARGET:
         {
@@ -437,43 +1085,46 @@ static void gdbwire_stream_record_callback(void *context,
 static void
 source_position_changed(struct tgdb *tgdb, gdbwire_mi_result *result)
 {
-    std::string frame("frame");
-    std::string addr("addr");
-    std::string fullname("fullname");
-    std::string line("line");
-
     while (result) {
-        if (frame == result->variable &&
+        if (result->key == GDBWIRE_MI_KEY_FRAME &&
             result->kind == GDBWIRE_MI_TUPLE) {
 
             uint64_t addr_value = 0;
             bool addr_value_set = false;
 
-            std::string fullname_value;
-            bool fullname_value_set = false;
+            const char *fullname_value = NULL;
 
             int line_value = 0;
             bool line_value_set = false;
 
             struct gdbwire_mi_result *fresult = result->variant.result;
 
+            /* The fields are looked at in place, nothing is copied */
             while (fresult) {
-                if (addr == fresult->variable) {
-                    addr_value = std::stoull(
-                            fresult->variant.cstring, 0, 16);
-                    addr_value_set = true;
-                } else if (fullname == fresult->variable) {
-                    fullname_value = fresult->variant.cstring;
-                    fullname_value_set = true;
-                } else if (line == fresult->variable) {
-                    line_value = std::stoi(fresult->variant.cstring);
-                    line_value_set = true;
+                if (fresult->kind == GDBWIRE_MI_CSTRING) {
+                    switch (fresult->key) {
+                        case GDBWIRE_MI_KEY_ADDR:
+                            addr_value_set = cgdb_hexstr_to_u64(
+                                    fresult->variant.cstring,
+                                    &addr_value) == 0;
+                            break;
+                        case GDBWIRE_MI_KEY_FULLNAME:
+                            fullname_value = fresult->variant.cstring;
+                            break;
+                        case GDBWIRE_MI_KEY_LINE:
+                            line_value = atoi(fresult->variant.cstring);
+                            line_value_set = true;
+                            break;
+                        default:
+                            break;
+                    }
                 }
                 fresult = fresult->next;
             }
 
-            if(addr_value_set || (fullname_value_set && line_value_set)) {
-                tgdb_commands_send_source_file(tgdb, fullname_value.c_str(),
+            if(addr_value_set || (fullname_value && line_value_set)) {
+                tgdb_commands_send_source_file(tgdb,
+                        fullname_value ? fullname_value : "",
                         NULL, addr_value, NULL, NULL, line_value);
             }
         }
@@ -482,6 +1133,195 @@ source_position_changed(struct tgdb *tgdb, gdbwire_mi_result *result)
     }
 }
 
+/**
+ * Find a string field of a record, like the thread-id of *stopped.
+ *
+ * @return
+ * The value of the field, or NULL if it is not there
+ */
+static const char *
+tgdb_result_cstring(struct gdbwire_mi_result *result, enum gdbwire_mi_key key)
+{
+    for (; result; result = result->next) {
+        if (result->kind == GDBWIRE_MI_CSTRING && result->key == key)
+            return result->variant.cstring;
+    }
+
+    return NULL;
+}
+
+/**
+ * The program stopped or a thread was selected, the stack may have changed.
+ *
+ * Selecting another frame of the same thread, like the up command does,
+ * leaves the stack alone.
+ */
+static void stack_changed(struct tgdb *tgdb,
+        struct gdbwire_mi_async_record *async_record)
+{
+    const char *thread_id;
+
+    if (async_record->async_class == GDBWIRE_MI_ASYNC_STOPPED) {
+        thread_id = tgdb_result_cstring(async_record->result,
+                GDBWIRE_MI_KEY_THREAD_ID);
+    } else {
+        thread_id = tgdb_result_cstring(async_record->result,
+                GDBWIRE_MI_KEY_ID);
+        if (thread_id && tgdb->thread_id == thread_id)
+            return;
+    }
+
+    tgdb->thread_id = thread_id ? thread_id : "";
+    tgdb->callbacks.tgdb_stack_changed_fn(tgdb->callbacks.context);
+}
+
+static bool tgdb_thread_less(const tgdb_thread &thread, int id)
+{
+    return thread.id < id;
+}
+
+/* Find a thread in the thread table, or where it would go */
+static std::vector<tgdb_thread>::iterator tgdb_find_thread(struct tgdb *tgdb,
+        int id)
+{
+    return std::lower_bound(tgdb->threads.begin(), tgdb->threads.end(),
+            id, tgdb_thread_less);
+}
+
+static void threads_set_running_id(struct tgdb *tgdb, const char *id_str,
+        bool running)
+{
+    int id = atoi(id_str);
+    std::vector<tgdb_thread>::iterator iter = tgdb_find_thread(tgdb, id);
+
+    if (iter != tgdb->threads.end() && iter->id == id)
+        iter->running = running;
+}
+
+/* Set whether the threads a *running or *stopped record is for are running.
+ * The threads are "all", one thread id, or a list of thread ids. */
+static void threads_set_running(struct tgdb *tgdb,
+        struct gdbwire_mi_result *threads, bool running)
+{
+    std::vector<tgdb_thread>::iterator iter;
+
+    if (!threads || (threads->kind == GDBWIRE_MI_CSTRING &&
+            strcmp(threads->variant.cstring, "all") == 0)) {
+        for (iter = tgdb->threads.begin(); iter != tgdb->threads.end(); ++iter)
+            iter->running = running;
+        return;
+    }
+
+    if (threads->kind == GDBWIRE_MI_CSTRING) {
+        threads_set_running_id(tgdb, threads->variant.cstring, running);
+    } else if (threads->kind == GDBWIRE_MI_LIST) {
+        for (threads = threads->variant.result; threads;
+                threads = threads->next) {
+            if (threads->kind == GDBWIRE_MI_CSTRING)
+                threads_set_running_id(tgdb, threads->variant.cstring,
+                        running);
+        }
+    }
+}
+
+/* Find a field of a record, of any kind */
+static struct gdbwire_mi_result *
+tgdb_result_field(struct gdbwire_mi_result *result, enum gdbwire_mi_key key)
+{
+    for (; result; result = result->next) {
+        if (result->key == key)
+            return result;
+    }
+
+    return NULL;
+}
+
+/**
+ * Keep the thread table up to date.
+ *
+ * Only the thread the record is for is looked at, so a program with
+ * thousands of threads doesn't cost a -thread-info on each event.
+ */
+static void threads_changed(struct tgdb *tgdb,
+        struct gdbwire_mi_async_record *async_record)
+{
+    std::vector<tgdb_thread>::iterator iter;
+    const char *id = tgdb_result_cstring(async_record->result,
+            GDBWIRE_MI_KEY_ID);
+    const char *group_id;
+
+    switch (async_record->async_class) {
+        case GDBWIRE_MI_ASYNC_THREAD_CREATED: {
+            tgdb_thread thread;
+
+            if (!id)
+                return;
+
+            group_id = tgdb_result_cstring(async_record->result,
+                    GDBWIRE_MI_KEY_GROUP_ID);
+
+            thread.id = atoi(id);
+            thread.group_id = group_id ? group_id : "";
+            thread.running = false;
+
+            /* A new thread runs along with the threads of its process */
+            for (iter = tgdb->threads.begin(); iter != tgdb->threads.end();
+                    ++iter) {
+                if (iter->group_id == thread.group_id && iter->running) {
+                    thread.running = true;
+                    break;
+                }
+            }
+
+            iter = tgdb_find_thread(tgdb, thread.id);
+            if (iter != tgdb->threads.end() && iter->id == thread.id)
+                return;
+
+            tgdb->threads.insert(iter, thread);
+            break;
+        }
+        case GDBWIRE_MI_ASYNC_THREAD_EXITED:
+            if (!id)
+                return;
+
+            iter = tgdb_find_thread(tgdb, atoi(id));
+            if (iter == tgdb->threads.end() || iter->id != atoi(id))
+                return;
+
+            tgdb->threads.erase(iter);
+            break;
+        case GDBWIRE_MI_ASYNC_THREAD_GROUP_EXITED: {
+            std::vector<tgdb_thread> threads;
+
+            /* The process exited, all its threads are gone */
+            for (iter = tgdb->threads.begin(); iter != tgdb->threads.end();
+                    ++iter) {
+                if (!id || iter->group_id != id)
+                    threads.push_back(*iter);
+            }
+
+            tgdb->threads.swap(threads);
+            break;
+        }
+        case GDBWIRE_MI_ASYNC_RUNNING:
+            threads_set_running(tgdb,
+                    tgdb_result_field(async_record->result,
+                        GDBWIRE_MI_KEY_THREAD_ID),
+                    true);
+            break;
+        case GDBWIRE_MI_ASYNC_STOPPED:
+            threads_set_running(tgdb,
+                    tgdb_result_field(async_record->result,
+                        GDBWIRE_MI_KEY_STOPPED_THREADS),
+                    false);
+            break;
+        default:
+            return;
+    }
+
+    tgdb->callbacks.tgdb_threads_changed_fn(tgdb->callbacks.context);
+}
+
 void tgdb_breakpoints_changed(void *context);
 static void gdbwire_async_record_callback(void *context,
         struct gdbwire_mi_async_record *async_record)
@@ -490,14 +1330,32 @@ static void gdbwire_async_record_callback(void *context,
 
     switch (async_record->async_class) {
         case GDBWIRE_MI_ASYNC_STOPPED:
+            threads_changed(tgdb, async_record);
+            /* fall through */
         case GDBWIRE_MI_ASYNC_THREAD_SELECTED:
             source_position_changed(tgdb, async_record->result);
+            stack_changed(tgdb, async_record);
+            tgdb->callbacks.tgdb_frame_changed_fn(tgdb->callbacks.context);
             break;
         case GDBWIRE_MI_ASYNC_BREAKPOINT_CREATED:
         case GDBWIRE_MI_ASYNC_BREAKPOINT_MODIFIED:
         case GDBWIRE_MI_ASYNC_BREAKPOINT_DELETED:
             tgdb_breakpoints_changed(tgdb);
             break;
+        case GDBWIRE_MI_ASYNC_THREAD_CREATED:
+        case GDBWIRE_MI_ASYNC_THREAD_EXITED:
+        case GDBWIRE_MI_ASYNC_THREAD_GROUP_EXITED:
+        case GDBWIRE_MI_ASYNC_RUNNING:
+            threads_changed(tgdb, async_record);
+            break;
+        case GDBWIRE_MI_ASYNC_LIBRARY_LOADED:
+        case GDBWIRE_MI_ASYNC_LIBRARY_UNLOADED:
+        case GDBWIRE_MI_ASYNC_THREAD_GROUP_STARTED:
+            /* The objfiles changed, or a new process (which may be running
+             * a new executable) started. The source files must be asked
+             * for again. */
+            tgdb->source_files_valid = false;
+            break;
         default:
             break;
     }
@@ -517,6 +1375,7 @@ static void gdbwire_result_record_callback(void *context,
             break;
         case TGDB_REQUEST_DISASSEMBLE_PC:
         case TGDB_REQUEST_DISASSEMBLE_FUNC:
+        case TGDB_REQUEST_DISASSEMBLE_RANGE:
             send_disassemble_func_complete_response(tgdb, result_record);
             break;
         case TGDB_REQUEST_DATA_DISASSEMBLE_MODE_QUERY:
@@ -536,6 +1395,59 @@ static void gdbwire_result_record_callback(void *context,
         case TGDB_REQUEST_INFO_FRAME:
             tgdb_commands_process_info_frame(tgdb, result_record);
             break;
+        case TGDB_REQUEST_STACK_FRAMES:
+            tgdb_commands_process_stack_frames(tgdb, result_record);
+            break;
+        case TGDB_REQUEST_SELECT_FRAME:
+            /* -stack-select-frame doesn't say where the frame is */
+            if (result_record->result_class == GDBWIRE_MI_DONE) {
+                tgdb_request_current_location(tgdb);
+                tgdb->callbacks.tgdb_frame_changed_fn(
+                        tgdb->callbacks.context);
+            }
+            break;
+        case TGDB_REQUEST_STACK_VARIABLES:
+            tgdb_commands_process_stack_variables(tgdb, result_record);
+            break;
+        case TGDB_REQUEST_VAR_CREATE:
+            tgdb_commands_process_var_create(tgdb, result_record);
+            break;
+        case TGDB_REQUEST_VAR_LIST_CHILDREN:
+            tgdb_commands_process_var_children(tgdb, result_record);
+            break;
+        case TGDB_REQUEST_VAR_UPDATE:
+            tgdb_commands_process_var_update(tgdb, result_record);
+            break;
+        case TGDB_REQUEST_REGISTER_NAMES:
+        case TGDB_REQUEST_REGISTER_VALUES:
+            tgdb_commands_process_registers(tgdb, result_record);
+            break;
+        case TGDB_REQUEST_CHANGED_REGISTERS:
+            tgdb_commands_process_changed_registers(tgdb, result_record);
+            break;
+        case TGDB_REQUEST_READ_MEMORY:
+            tgdb_commands_process_read_memory(tgdb, result_record);
+            break;
+        case TGDB_REQUEST_THREAD_INFO:
+            tgdb_commands_process_thread_info(tgdb, result_record);
+            break;
+        case TGDB_REQUEST_SELECT_THREAD:
+            /* Like =thread-selected, which GDB doesn't send for this */
+            if (result_record->result_class == GDBWIRE_MI_DONE) {
+                const char *id = tgdb_result_cstring(result_record->result,
+                        GDBWIRE_MI_KEY_NEW_THREAD_ID);
+
+                tgdb->thread_id = id ? id : "";
+                tgdb->callbacks.tgdb_stack_changed_fn(
+                        tgdb->callbacks.context);
+                tgdb->callbacks.tgdb_threads_changed_fn(
+                        tgdb->callbacks.context);
+                tgdb_request_current_location(tgdb);
+                tgdb->callbacks.tgdb_frame_changed_fn(
+                        tgdb->callbacks.context);
+            }
+            break;
+        case TGDB_REQUEST_VAR_DELETE:
         case TGDB_REQUEST_TTY:
         case TGDB_REQUEST_DEBUGGER_COMMAND:
         case TGDB_REQUEST_MODIFY_BREAKPOINT:
@@ -612,16 +1524,24 @@ static struct tgdb *initialize_tgdb_context(tgdb_callbacks callbacks)
 
     obj->gdb_mi_ui_fd = -1;
 
+    obj->console_output.written = 0;
+    obj->mi_output.written = 0;
+
     obj->new_ui_pty_pair = NULL;
 
     obj->command_requests = new tgdb_request_ptr_list();
 
     obj->is_gdb_ready_for_next_command = 0;
+    obj->gdb_started = 0;
 
     obj->callbacks = callbacks;
 
-    obj->address_start = 0;
-    obj->address_end = 0;
+    obj->range_start = 0;
+    obj->range_end = 0;
+    obj->disasm_lines = 0;
+    obj->disasm_bytes = 0;
+
+    obj->source_files_valid = false;
 
     wire_callbacks.context = (void*)obj;
     obj->wire = gdbwire_create(wire_callbacks);
@@ -630,6 +1550,9 @@ static struct tgdb *initialize_tgdb_context(tgdb_callbacks callbacks)
     obj->gdb_supports_new_ui_command = true;
     obj->undefined_new_ui_command = new std::string();
 
+    obj->record = NULL;
+    obj->replaying = false;
+
     return obj;
 }
 
@@ -672,9 +1595,17 @@ void tgdb_console_at_prompt(void *context)
 
     tgdb->is_gdb_ready_for_next_command = 1;
 
-    if (tgdb->command_requests->size() > 0) {
+    /* Commands for the console don't wait for a prompt, so keep sending
+     * until one for the mi channel is sent */
+    while (tgdb->is_gdb_ready_for_next_command &&
+            tgdb->command_requests->size() > 0) {
         tgdb_unqueue_and_deliver_command(tgdb);
     }
+
+    if (!tgdb->gdb_started) {
+        tgdb->gdb_started = 1;
+        tgdb->callbacks.tgdb_gdb_started_fn(tgdb->callbacks.context);
+    }
 }
 
 /**
@@ -701,8 +1632,25 @@ static void tgdb_request_destroy(tgdb_request_ptr request_ptr)
             free((char *) request_ptr->choice.until_line.file);
             request_ptr->choice.until_line.file = NULL;
             break;
+        case TGDB_REQUEST_VAR_CREATE:
+        case TGDB_REQUEST_VAR_LIST_CHILDREN:
+        case TGDB_REQUEST_VAR_DELETE:
+            free((char *) request_ptr->choice.varobj.name);
+            request_ptr->choice.varobj.name = NULL;
+            free((char *) request_ptr->choice.varobj.expr);
+            request_ptr->choice.varobj.expr = NULL;
+            break;
+        case TGDB_REQUEST_REGISTER_VALUES:
+            free((char *) request_ptr->choice.register_values.numbers);
+            request_ptr->choice.register_values.numbers = NULL;
+            break;
+        case TGDB_REQUEST_READ_MEMORY:
+            free((char *) request_ptr->choice.read_memory.addr);
+            request_ptr->choice.read_memory.addr = NULL;
+            break;
         case TGDB_REQUEST_DISASSEMBLE_PC:
         case TGDB_REQUEST_DISASSEMBLE_FUNC:
+        case TGDB_REQUEST_DISASSEMBLE_RANGE:
             break;
         default:
             break;
@@ -751,6 +1699,18 @@ struct tgdb *tgdb_initialize(tgdb_callbacks callbacks)
     return tgdb;
 }
 
+static int tgdb_set_nonblocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL);
+
+    if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1) {
+        clog_error(CLOG_CGDB, "fcntl failed: %s", strerror(errno));
+        return -1;
+    }
+
+    return 0;
+}
+
 int tgdb_start_gdb(struct tgdb *tgdb,
         const char *debugger, int argc, char **argv,
         int gdb_win_rows, int gdb_win_cols, int *gdb_console_fd,
@@ -764,6 +1724,11 @@ int tgdb_start_gdb(struct tgdb *tgdb,
     if (tgdb->debugger_pid == -1)
         return -1;
 
+    /* Writes to GDB are queued and flushed without blocking */
+    if (tgdb_set_nonblocking(tgdb->debugger_stdin) == -1 ||
+        tgdb_set_nonblocking(tgdb->gdb_mi_ui_fd) == -1)
+        return -1;
+
     *gdb_console_fd = tgdb->debugger_stdout;
     *gdb_mi_fd = tgdb->gdb_mi_ui_fd;
 
@@ -782,6 +1747,9 @@ int tgdb_shutdown(struct tgdb *tgdb)
     delete tgdb->command_requests;
     tgdb->command_requests = 0;
 
+    /* Give GDB what it will still take */
+    tgdb_flush(tgdb);
+
     if (tgdb->debugger_stdin != -1) {
         cgdb_close(tgdb->debugger_stdin);
         tgdb->debugger_stdin = -1;
@@ -789,6 +1757,11 @@ int tgdb_shutdown(struct tgdb *tgdb)
 
     gdbwire_destroy(tgdb->wire);
 
+    if (tgdb->record) {
+        fclose(tgdb->record);
+        tgdb->record = NULL;
+    }
+
     delete tgdb;
 
     return 0;
@@ -897,9 +1870,10 @@ void tgdb_run_or_queue_request(struct tgdb *tgdb,
     // Debugger commands currently get executed in the gdb console
     // rather than the gdb mi channel. The gdb console is no longer
     // queued by CGDB, rather CGDB passes everything along to it that the
-    // user types. So always issue debugger commands for now.
+    // user types. So always issue debugger commands once gdb started.
+    // Before that, they wait in order with the rest for the first prompt.
     if (request->header == TGDB_REQUEST_DEBUGGER_COMMAND) {
-        can_issue = 1;
+        can_issue = tgdb->gdb_started;
     } else {
         can_issue = tgdb->is_gdb_ready_for_next_command;
     }
@@ -918,6 +1892,181 @@ void tgdb_run_or_queue_request(struct tgdb *tgdb,
 int tgdb_get_gdb_command(struct tgdb *tgdb, tgdb_request_ptr request,
         std::string &command);
 
+/* Recording {{{*/
+
+/**
+ * A recording starts with TGDB_RECORD_MAGIC. Each read or write after that
+ * is a header of TGDB_RECORD_HEADER_SIZE bytes followed by the bytes:
+ *   1 byte  the tgdb_record_kind
+ *   4 bytes the number of bytes, little endian
+ *   8 bytes the microseconds since the recording started, little endian
+ * A read of zero bytes is GDB closing the descriptor.
+ */
+#define TGDB_RECORD_MAGIC "TGDBREC1"
+#define TGDB_RECORD_MAGIC_SIZE 8
+#define TGDB_RECORD_HEADER_SIZE 13
+
+enum tgdb_record_kind {
+    TGDB_RECORD_CONSOLE_READ,
+    TGDB_RECORD_CONSOLE_WRITE,
+    TGDB_RECORD_MI_READ,
+    TGDB_RECORD_MI_WRITE
+};
+
+int tgdb_record_start(struct tgdb *tgdb, const char *path)
+{
+    FILE *fp = fopen(path, "wb");
+    if (!fp) {
+        clog_error(CLOG_CGDB, "Can not record to %s: %s",
+                path, strerror(errno));
+        return -1;
+    }
+
+    if (fwrite(TGDB_RECORD_MAGIC, 1, TGDB_RECORD_MAGIC_SIZE, fp) !=
+            TGDB_RECORD_MAGIC_SIZE) {
+        clog_error(CLOG_CGDB, "Can not write to %s", path);
+        fclose(fp);
+        return -1;
+    }
+
+    if (tgdb->record) {
+        fclose(tgdb->record);
+    }
+
+    tgdb->record = fp;
+    gettimeofday(&tgdb->record_start, NULL);
+
+    return 0;
+}
+
+/**
+ * Add a read or write to the recording, if tgdb is recording.
+ *
+ * @param tgdb
+ * An instance of tgdb
+ *
+ * @param kind
+ * Which descriptor and direction the bytes went
+ *
+ * @param buf
+ * The bytes read or written
+ *
+ * @param size
+ * The number of bytes in buf
+ */
+static void tgdb_record(struct tgdb *tgdb, enum tgdb_record_kind kind,
+        const char *buf, size_t size)
+{
+    unsigned char header[TGDB_RECORD_HEADER_SIZE];
+    struct timeval now;
+    uint64_t usec;
+    int i;
+
+    if (!tgdb->record) {
+        return;
+    }
+
+    gettimeofday(&now, NULL);
+    usec = (uint64_t)(now.tv_sec - tgdb->record_start.tv_sec) * 1000000 +
+            now.tv_usec - tgdb->record_start.tv_usec;
+
+    header[0] = kind;
+    for (i = 0; i < 4; ++i) {
+        header[1 + i] = (size >> (i * 8)) & 0xff;
+    }
+    for (i = 0; i < 8; ++i) {
+        header[5 + i] = (usec >> (i * 8)) & 0xff;
+    }
+
+    if (fwrite(header, 1, sizeof(header), tgdb->record) != sizeof(header) ||
+        fwrite(buf, 1, size, tgdb->record) != size) {
+        clog_error(CLOG_CGDB, "Can not write to the recording, stopping");
+        fclose(tgdb->record);
+        tgdb->record = NULL;
+    }
+}
+
+/* }}}*/
+
+/**
+ * The most chunks handed to a single writev.
+ */
+#define TGDB_OUTPUT_IOVECS 64
+
+/**
+ * Queue bytes to be written to GDB by the next tgdb_flush.
+ *
+ * @param output
+ * The output of the descriptor the bytes are for
+ *
+ * @param buf
+ * The bytes to write
+ *
+ * @param n
+ * The number of bytes in buf
+ */
+static void tgdb_queue_output(struct tgdb_output *output,
+        const char *buf, size_t n)
+{
+    if (n > 0)
+        output->chunks.push_back(std::string(buf, n));
+}
+
+/**
+ * Write as much of the queued output as GDB will take without blocking.
+ *
+ * What GDB doesn't take is kept for the next call.
+ *
+ * @param output
+ * The output to write
+ *
+ * @param fd
+ * The non blocking descriptor to write it to
+ *
+ * @return
+ * 0 on success, or -1 on error
+ */
+static int tgdb_flush_output(struct tgdb_output *output, int fd)
+{
+    while (!output->chunks.empty()) {
+        struct iovec iov[TGDB_OUTPUT_IOVECS];
+        std::deque<std::string>::iterator iter = output->chunks.begin();
+        ssize_t nwritten;
+        int count;
+
+        for (count = 0; iter != output->chunks.end() &&
+                count < TGDB_OUTPUT_IOVECS; ++iter, ++count) {
+            size_t skip = (count == 0) ? output->written : 0;
+
+            iov[count].iov_base = (void *)(iter->data() + skip);
+            iov[count].iov_len = iter->size() - skip;
+        }
+
+        nwritten = writev(fd, iov, count);
+        if (nwritten == -1) {
+            if (errno == EINTR)
+                continue;
+
+            /* GDB isn't reading, try again later */
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return 0;
+
+            clog_error(CLOG_CGDB, "writev failed: %s", strerror(errno));
+            return -1;
+        }
+
+        /* Drop the chunks that were written completely */
+        output->written += nwritten;
+        while (!output->chunks.empty() &&
+                output->written >= output->chunks.front().size()) {
+            output->written -= output->chunks.front().size();
+            output->chunks.pop_front();
+        }
+    }
+
+    return 0;
+}
+
 /**
  * Send a command to gdb.
  *
@@ -940,12 +2089,39 @@ static void tgdb_run_request(struct tgdb *tgdb, struct tgdb_request *request)
         command.push_back('\n');
     }
 
-    /* Send what we're doing to log file */
-    std::string str = sys_quote_nonprintables(command.c_str(), -1);
-    clog_debug(CLOG_GDBMIIO, "%s", str.c_str());
+    /* Send what we're doing to log file */
+    std::string str = sys_quote_nonprintables(command.c_str(), -1);
+    clog_debug(CLOG_GDBMIIO, "%s", str.c_str());
+
+    /* A command for the debugger */
+    tgdb_commands_set_current_request_type(tgdb, request->header);
+
+    if (request->header == TGDB_REQUEST_DISASSEMBLE_PC) {
+        tgdb->disasm_lines = request->choice.disassemble.lines;
+        tgdb->disasm_bytes = request->choice.disassemble.bytes;
+    }
+
+    if (request->header == TGDB_REQUEST_DISASSEMBLE_RANGE) {
+        tgdb->range_start = request->choice.disassemble_range.start;
+        tgdb->range_end = request->choice.disassemble_range.end;
+    }
+
+    if (request->header == TGDB_REQUEST_STACK_FRAMES) {
+        tgdb->frames_low = request->choice.stack_frames.low;
+        tgdb->frames_high = request->choice.stack_frames.high;
+    }
+
+    if (request->header == TGDB_REQUEST_VAR_CREATE ||
+        request->header == TGDB_REQUEST_VAR_LIST_CHILDREN)
+        tgdb->var_name = request->choice.varobj.name;
+
+    if (request->header == TGDB_REQUEST_READ_MEMORY) {
+        tgdb->memory_addr = request->choice.read_memory.addr;
+        tgdb->memory_count = request->choice.read_memory.count;
+    }
 
-    /* A command for the debugger */
-    tgdb_commands_set_current_request_type(tgdb, request->header);
+    if (request->header == TGDB_REQUEST_THREAD_INFO)
+        tgdb->thread_info_id = request->choice.thread.id;
 
     if (request->header == TGDB_REQUEST_DEBUGGER_COMMAND) {
         // since debugger commands are sent to the debugger's stdin
@@ -953,9 +2129,19 @@ static void tgdb_run_request(struct tgdb *tgdb, struct tgdb_request *request)
         // for gdb to respond with an mi prompt. CGDB can send as many
         // commands as it likes, just as if the user typed it at the console
         tgdb->is_gdb_ready_for_next_command = 1;
-        io_writen(tgdb->debugger_stdin, command.c_str(), command.size());
+        tgdb_record(tgdb, TGDB_RECORD_CONSOLE_WRITE,
+                command.c_str(), command.size());
+        if (!tgdb->replaying) {
+            tgdb_queue_output(&tgdb->console_output,
+                    command.c_str(), command.size());
+        }
     } else {
-        io_writen(tgdb->gdb_mi_ui_fd, command.c_str(), command.size());
+        tgdb_record(tgdb, TGDB_RECORD_MI_WRITE,
+                command.c_str(), command.size());
+        if (!tgdb->replaying) {
+            tgdb_queue_output(&tgdb->mi_output,
+                    command.c_str(), command.size());
+        }
     }
 
     tgdb_request_destroy(request);
@@ -978,16 +2164,77 @@ static void tgdb_unqueue_and_deliver_command(struct tgdb *tgdb)
     }
 }
 
+/**
+ * A command was entered at the gdb console.
+ *
+ * The file, symbol-file and add-symbol-file commands change the source
+ * files without an mi notification. GDB runs the command before it
+ * answers any request sent after it, so the source files are asked for
+ * again the next time they are wanted.
+ *
+ * @param tgdb
+ * An instance of tgdb
+ */
+static void tgdb_console_command_entered(struct tgdb *tgdb)
+{
+    tgdb->source_files_valid = false;
+}
+
 int tgdb_send_char(struct tgdb *tgdb, char c)
 {
-    if (io_write_byte(tgdb->debugger_stdin, c) == -1) {
-        clog_error(CLOG_CGDB, "io_write_byte failed");
-        return -1;
+    tgdb_record(tgdb, TGDB_RECORD_CONSOLE_WRITE, &c, 1);
+
+    if (c == '\r' || c == '\n') {
+        tgdb_console_command_entered(tgdb);
+    }
+
+    if (tgdb->replaying) {
+        return 0;
+    }
+
+    tgdb_queue_output(&tgdb->console_output, &c, 1);
+
+    return 0;
+}
+
+int tgdb_send_chars(struct tgdb *tgdb, const char *buf, size_t n)
+{
+    tgdb_record(tgdb, TGDB_RECORD_CONSOLE_WRITE, buf, n);
+
+    if (memchr(buf, '\r', n) || memchr(buf, '\n', n)) {
+        tgdb_console_command_entered(tgdb);
+    }
+
+    if (tgdb->replaying) {
+        return 0;
     }
 
+    tgdb_queue_output(&tgdb->console_output, buf, n);
+
     return 0;
 }
 
+int tgdb_flush(struct tgdb *tgdb)
+{
+    int result = 0;
+
+    if (tgdb->debugger_stdin != -1 &&
+        tgdb_flush_output(&tgdb->console_output, tgdb->debugger_stdin) == -1)
+        result = -1;
+
+    if (tgdb->gdb_mi_ui_fd != -1 &&
+        tgdb_flush_output(&tgdb->mi_output, tgdb->gdb_mi_ui_fd) == -1)
+        result = -1;
+
+    return result;
+}
+
+int tgdb_has_pending_output(struct tgdb *tgdb)
+{
+    return !tgdb->console_output.chunks.empty() ||
+           !tgdb->mi_output.chunks.empty();
+}
+
 /**
  * TGDB is going to quit.
  *
@@ -1081,6 +2328,52 @@ static void tgdb_search_for_unsupported_new_ui_message(
     }
 }
 
+/**
+ * Process output read from GDB.
+ *
+ * @param tgdb
+ * An instance of tgdb
+ *
+ * @param mi
+ * True if buf was read from the mi channel, false for the console
+ *
+ * @param buf
+ * The bytes read
+ *
+ * @param size
+ * The number of bytes in buf, 0 if GDB closed the descriptor
+ */
+static void tgdb_process_output(struct tgdb *tgdb, bool mi,
+        const char *buf, size_t size)
+{
+    if (size == 0) {
+        // Read EOF from GDB
+        clog_info(CLOG_GDBIO, "read EOF from GDB, closing down");
+        tgdb_add_quit_command(tgdb, false);
+    } else if (!mi) {
+        // Read some GDB console output, process it
+        std::string str = sys_quote_nonprintables(buf, size);
+        clog_debug(CLOG_GDBIO, "%s", str.c_str());
+        std::string msg(buf, size);
+
+        // Determine if this gdb supports the new-ui command.
+        // If it does not, send the quit command to alert the user
+        // that they need a newer gdb.
+        tgdb_search_for_unsupported_new_ui_message(tgdb, msg);
+        if (!tgdb->gdb_supports_new_ui_command) {
+            tgdb_add_quit_command(tgdb, true);
+        }
+
+        tgdb->callbacks.console_output_callback(
+                tgdb->callbacks.context, msg);
+    } else {
+        // Read some GDB console output, process it
+        std::string msg(buf, size);
+        clog_debug(CLOG_GDBMIIO, "%s", msg.c_str());
+        tgdb_commands_process(tgdb, msg);
+    }
+}
+
 int tgdb_process(struct tgdb * tgdb, int fd)
 {
     const int n = 4096;
@@ -1092,41 +2385,74 @@ int tgdb_process(struct tgdb * tgdb, int fd)
     tgdb_handle_control_c(tgdb);
 
     size = io_read(fd, buf, n);
-    if (size < 0) {
+    if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        // The descriptor is non blocking, nothing to read after all
+        return 0;
+    } else if (size < 0) {
         // Error reading from GDB
         clog_error(CLOG_CGDB, "Error reading from gdb's stdout, closing down");
         result = -1;
         tgdb_add_quit_command(tgdb, false);
-    } else if (size == 0) {
-        // Read EOF from GDB
-        clog_info(CLOG_GDBIO, "read EOF from GDB, closing down");
-        tgdb_add_quit_command(tgdb, false);
-    } else {
-        if (fd == tgdb->debugger_stdout) {
-            // Read some GDB console output, process it
-            std::string str = sys_quote_nonprintables(buf, size);
-            clog_debug(CLOG_GDBIO, "%s", str.c_str());
-            std::string msg(buf, size);
-
-            // Determine if this gdb supports the new-ui command.
-            // If it does not, send the quit command to alert the user
-            // that they need a newer gdb.
-            tgdb_search_for_unsupported_new_ui_message(tgdb, msg);
-            if (!tgdb->gdb_supports_new_ui_command) {
-                tgdb_add_quit_command(tgdb, true);
-            }
+    } else if (fd == tgdb->debugger_stdout) {
+        tgdb_record(tgdb, TGDB_RECORD_CONSOLE_READ, buf, size);
+        tgdb_process_output(tgdb, false, buf, size);
+    } else if (fd == tgdb->gdb_mi_ui_fd) {
+        tgdb_record(tgdb, TGDB_RECORD_MI_READ, buf, size);
+        tgdb_process_output(tgdb, true, buf, size);
+    }
 
-            tgdb->callbacks.console_output_callback(
-                    tgdb->callbacks.context, msg);
-        } else if (fd == tgdb->gdb_mi_ui_fd){
-            // Read some GDB console output, process it
-            std::string msg(buf, size);
-            clog_debug(CLOG_GDBMIIO, "%s", msg.c_str());
-            tgdb_commands_process(tgdb, msg);
-        } else {
+    return result;
+}
+
+int tgdb_replay(struct tgdb *tgdb, const char *path)
+{
+    char magic[TGDB_RECORD_MAGIC_SIZE];
+    unsigned char header[TGDB_RECORD_HEADER_SIZE];
+    std::vector<char> buf;
+    int result = 0;
+
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        clog_error(CLOG_CGDB, "Can not replay %s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    if (fread(magic, 1, sizeof(magic), fp) != sizeof(magic) ||
+        memcmp(magic, TGDB_RECORD_MAGIC, sizeof(magic)) != 0) {
+        clog_error(CLOG_CGDB, "%s is not a tgdb recording", path);
+        fclose(fp);
+        return -1;
+    }
+
+    tgdb->replaying = true;
+
+    while (fread(header, 1, sizeof(header), fp) == sizeof(header)) {
+        enum tgdb_record_kind kind = (enum tgdb_record_kind)header[0];
+        size_t size = 0;
+        int i;
+
+        for (i = 0; i < 4; ++i) {
+            size |= (size_t)header[1 + i] << (i * 8);
+        }
+
+        buf.resize(size + 1);
+        if (fread(buf.data(), 1, size, fp) != size) {
+            clog_error(CLOG_CGDB, "%s is truncated", path);
+            result = -1;
+            break;
+        }
+
+        // The writes are what tgdb sent while recording. They are sent
+        // again (and dropped) as the recorded output is processed.
+        if (kind == TGDB_RECORD_CONSOLE_READ || kind == TGDB_RECORD_MI_READ) {
+            tgdb_handle_control_c(tgdb);
+            tgdb_process_output(tgdb, kind == TGDB_RECORD_MI_READ,
+                    buf.data(), size);
         }
     }
 
+    fclose(fp);
+
     return result;
 }
 
@@ -1196,6 +2522,11 @@ void tgdb_request_inferiors_source_files(struct tgdb * tgdb)
 {
     tgdb_request_ptr request_ptr;
 
+    if (tgdb->source_files_valid) {
+        tgdb_commands_send_source_files(tgdb, tgdb->source_files);
+        return;
+    }
+
     request_ptr = (tgdb_request_ptr)cgdb_malloc(sizeof (struct tgdb_request));
 
     request_ptr->header = TGDB_REQUEST_INFO_SOURCES;
@@ -1263,6 +2594,22 @@ void tgdb_request_disassemble_pc(struct tgdb *tgdb, int lines)
     request_ptr->header = TGDB_REQUEST_DISASSEMBLE_PC;
 
     request_ptr->choice.disassemble.lines = lines;
+    /* An instruction is at most 15 bytes long on x86 */
+    request_ptr->choice.disassemble.bytes = lines * 15;
+
+    tgdb_run_or_queue_request(tgdb, request_ptr, false);
+}
+
+void tgdb_request_disassemble_range(struct tgdb *tgdb,
+        uint64_t addr_start, uint64_t addr_end)
+{
+    tgdb_request_ptr request_ptr;
+
+    request_ptr = (tgdb_request_ptr)cgdb_malloc(sizeof (struct tgdb_request));
+    request_ptr->header = TGDB_REQUEST_DISASSEMBLE_RANGE;
+
+    request_ptr->choice.disassemble_range.start = addr_start;
+    request_ptr->choice.disassemble_range.end = addr_end;
 
     tgdb_run_or_queue_request(tgdb, request_ptr, false);
 }
@@ -1296,10 +2643,198 @@ void tgdb_request_until_line(struct tgdb *tgdb,
     tgdb_run_or_queue_request(tgdb, request_ptr, false);
 }
 
+void tgdb_request_stack_frames(struct tgdb *tgdb, int low, int high)
+{
+    tgdb_request_ptr request_ptr;
+
+    request_ptr = (tgdb_request_ptr)cgdb_malloc(sizeof (struct tgdb_request));
+    request_ptr->header = TGDB_REQUEST_STACK_FRAMES;
+
+    request_ptr->choice.stack_frames.low = low;
+    request_ptr->choice.stack_frames.high = high;
+
+    tgdb_run_or_queue_request(tgdb, request_ptr, false);
+}
+
+void tgdb_request_select_frame(struct tgdb *tgdb, int level)
+{
+    tgdb_request_ptr request_ptr;
+
+    request_ptr = (tgdb_request_ptr)cgdb_malloc(sizeof (struct tgdb_request));
+    request_ptr->header = TGDB_REQUEST_SELECT_FRAME;
+
+    request_ptr->choice.select_frame.level = level;
+
+    tgdb_run_or_queue_request(tgdb, request_ptr, false);
+}
+
+void tgdb_request_stack_variables(struct tgdb *tgdb)
+{
+    tgdb_issue_request(tgdb, TGDB_REQUEST_STACK_VARIABLES, false);
+}
+
+/**
+ * Queue a request about a variable object.
+ *
+ * @param tgdb
+ * An instance of tgdb
+ *
+ * @param header
+ * The kind of request
+ *
+ * @param name
+ * The name of the variable object
+ *
+ * @param expr
+ * The expression to create the variable object for, or NULL
+ */
+static void tgdb_request_varobj(struct tgdb *tgdb,
+        enum tgdb_request_type header, const char *name, const char *expr)
+{
+    tgdb_request_ptr request_ptr;
+
+    request_ptr = (tgdb_request_ptr)cgdb_malloc(sizeof (struct tgdb_request));
+    request_ptr->header = header;
+
+    request_ptr->choice.varobj.name = cgdb_strdup(name);
+    request_ptr->choice.varobj.expr = expr ? cgdb_strdup(expr) : NULL;
+
+    tgdb_run_or_queue_request(tgdb, request_ptr, false);
+}
+
+void tgdb_request_var_create(struct tgdb *tgdb, const char *name,
+        const char *expr)
+{
+    tgdb_request_varobj(tgdb, TGDB_REQUEST_VAR_CREATE, name, expr);
+}
+
+void tgdb_request_var_list_children(struct tgdb *tgdb, const char *name)
+{
+    tgdb_request_varobj(tgdb, TGDB_REQUEST_VAR_LIST_CHILDREN, name, NULL);
+}
+
+void tgdb_request_var_update(struct tgdb *tgdb)
+{
+    tgdb_issue_request(tgdb, TGDB_REQUEST_VAR_UPDATE, false);
+}
+
+void tgdb_request_var_delete(struct tgdb *tgdb, const char *name)
+{
+    tgdb_request_varobj(tgdb, TGDB_REQUEST_VAR_DELETE, name, NULL);
+}
+
+void tgdb_request_register_names(struct tgdb *tgdb)
+{
+    tgdb_issue_request(tgdb, TGDB_REQUEST_REGISTER_NAMES, false);
+}
+
+void tgdb_request_changed_registers(struct tgdb *tgdb)
+{
+    tgdb_issue_request(tgdb, TGDB_REQUEST_CHANGED_REGISTERS, false);
+}
+
+void tgdb_request_register_values(struct tgdb *tgdb,
+        const std::list<int> &numbers)
+{
+    tgdb_request_ptr request_ptr;
+    std::ostringstream numbers_str;
+    std::list<int>::const_iterator iter;
+
+    if (numbers.empty())
+        return;
+
+    for (iter = numbers.begin(); iter != numbers.end(); ++iter) {
+        if (iter != numbers.begin())
+            numbers_str << " ";
+        numbers_str << *iter;
+    }
+
+    request_ptr = (tgdb_request_ptr)cgdb_malloc(sizeof (struct tgdb_request));
+    request_ptr->header = TGDB_REQUEST_REGISTER_VALUES;
+
+    request_ptr->choice.register_values.numbers =
+        cgdb_strdup(numbers_str.str().c_str());
+
+    tgdb_run_or_queue_request(tgdb, request_ptr, false);
+}
+
+void tgdb_request_thread_info(struct tgdb *tgdb, int id)
+{
+    tgdb_request_ptr request_ptr;
+
+    request_ptr = (tgdb_request_ptr)cgdb_malloc(sizeof (struct tgdb_request));
+    request_ptr->header = TGDB_REQUEST_THREAD_INFO;
+
+    request_ptr->choice.thread.id = id;
+
+    tgdb_run_or_queue_request(tgdb, request_ptr, false);
+}
+
+void tgdb_request_select_thread(struct tgdb *tgdb, int id)
+{
+    tgdb_request_ptr request_ptr;
+
+    request_ptr = (tgdb_request_ptr)cgdb_malloc(sizeof (struct tgdb_request));
+    request_ptr->header = TGDB_REQUEST_SELECT_THREAD;
+
+    request_ptr->choice.thread.id = id;
+
+    tgdb_run_or_queue_request(tgdb, request_ptr, false);
+}
+
+const std::vector<tgdb_thread> &tgdb_get_threads(struct tgdb *tgdb)
+{
+    return tgdb->threads;
+}
+
+int tgdb_get_current_thread(struct tgdb *tgdb)
+{
+    return tgdb->thread_id.empty() ? -1 : atoi(tgdb->thread_id.c_str());
+}
+
+void tgdb_request_read_memory(struct tgdb *tgdb, const char *addr, int count)
+{
+    tgdb_request_ptr request_ptr;
+
+    request_ptr = (tgdb_request_ptr)cgdb_malloc(sizeof (struct tgdb_request));
+    request_ptr->header = TGDB_REQUEST_READ_MEMORY;
+
+    request_ptr->choice.read_memory.addr = cgdb_strdup(addr);
+    request_ptr->choice.read_memory.count = count;
+
+    tgdb_run_or_queue_request(tgdb, request_ptr, false);
+}
+
 /* }}}*/
 
 /* Process {{{*/
 
+/**
+ * Quote a string as a GDB/MI c-string parameter.
+ *
+ * @param str
+ * The string to quote
+ *
+ * @return
+ * The string in double quotes, with quotes and backslashes escaped
+ */
+static std::string tgdb_mi_quote(const char *str)
+{
+    std::string result("\"");
+
+    for (; *str; ++str) {
+        if (*str == '"' || *str == '\\')
+            result.push_back('\\');
+        else if (*str == '\n' || *str == '\r')
+            continue;
+        result.push_back(*str);
+    }
+
+    result.push_back('"');
+
+    return result;
+}
+
 int tgdb_get_gdb_command(struct tgdb *tgdb, tgdb_request_ptr request,
         std::string &command)
 {
@@ -1357,13 +2892,23 @@ int tgdb_get_gdb_command(struct tgdb *tgdb, tgdb_request_ptr request,
             str = NULL;
             break;
         case TGDB_REQUEST_DISASSEMBLE_PC:
-            str = sys_aprintf("x/%di $pc\n", request->choice.disassemble.lines);
+            str = sys_aprintf("-data-disassemble -s $pc -e $pc+%d -- 0\n",
+                    request->choice.disassemble.bytes);
+            command = str;
+            free(str);
+            str = NULL;
+            break;
+        case TGDB_REQUEST_DISASSEMBLE_RANGE:
+            str = sys_aprintf(
+                    "-data-disassemble -s 0x%" PRIx64 " -e 0x%" PRIx64 " -- 0\n",
+                    request->choice.disassemble_range.start,
+                    request->choice.disassemble_range.end);
             command = str;
             free(str);
             str = NULL;
             break;
         case TGDB_REQUEST_DISASSEMBLE_FUNC: {
-            /* GDB 7.11 adds /s command to disassemble
+            /* GDB 7.11 adds mode 4, /s in the CLI, to -data-disassemble
 
             https://sourceware.org/git/gitweb.cgi?p=binutils-gdb.git;a=commit;h=6ff0ba5f7b8a2b10642bbb233a32043595c55670
                 The "source centric" /m option to the disassemble command is
@@ -1373,30 +2918,98 @@ int tgdb_get_gdb_command(struct tgdb *tgdb, tgdb_request_ptr request,
                 source file, leaving out instructions from
                 e.g., inlined functions from other files.
 
-            disassemble
-                 /m: source lines included
-                 /s: source lines included, output in pc order (7.10 and higher)
-                 /r: raw instructions included in hex
-                 single argument: function surrounding is dumped
-                 two arguments: start,end or start,+length
-                 disassemble 'driver.cpp'::main
-                 interp mi "disassemble /s 'driver.cpp'::main,+10"
-                 interp mi "disassemble /r 'driver.cpp'::main,+10"
+            -data-disassemble ... -- mode
+                 0: instructions only
+                 1: source lines included (/m)
+                 2: raw instructions included in hex (/r)
+                 3: source lines and raw instructions (/m /r)
+                 4: source lines included, output in pc order (/s)
+                 5: source lines in pc order and raw instructions (/s /r)
+                 -a addr: the function surrounding addr is dumped
+                 -s start -e end: the instructions from start to end
+
+            GDBs without -a report an error, and the caller can fall back
+            to disassembling the memory around the pc.
              */
-            const char *data = NULL;
+            int mode = 0;
             if (request->choice.disassemble_func.raw) {
-                data = "/r";
+                mode = 2;
             } else if (request->choice.disassemble_func.source &&
                     tgdb_commands_disassemble_supports_s_mode(tgdb)) {
-                data = "/s";
+                mode = 4;
             }
-            str = sys_aprintf("disassemble%s%s\n",
-                    data ? " " : "", data ? data : "");
+            str = sys_aprintf("-data-disassemble -a $pc -- %d\n", mode);
             command = str;
             free(str);
             str = NULL;
             break;
         }
+        case TGDB_REQUEST_STACK_FRAMES:
+            str = sys_aprintf("-stack-list-frames %d %d\n",
+                    request->choice.stack_frames.low,
+                    request->choice.stack_frames.high);
+            command = str;
+            free(str);
+            str = NULL;
+            break;
+        case TGDB_REQUEST_SELECT_FRAME:
+            str = sys_aprintf("-stack-select-frame %d\n",
+                    request->choice.select_frame.level);
+            command = str;
+            free(str);
+            str = NULL;
+            break;
+        case TGDB_REQUEST_STACK_VARIABLES:
+            command = "-stack-list-variables --no-values\n";
+            break;
+        case TGDB_REQUEST_VAR_CREATE:
+            /* @ makes a floating variable object, it is evaluated in the
+             * selected frame each time it is updated */
+            command = std::string("-var-create ") +
+                request->choice.varobj.name + " @ " +
+                tgdb_mi_quote(request->choice.varobj.expr) + "\n";
+            break;
+        case TGDB_REQUEST_VAR_LIST_CHILDREN:
+            command = std::string("-var-list-children --all-values ") +
+                request->choice.varobj.name + "\n";
+            break;
+        case TGDB_REQUEST_VAR_UPDATE:
+            command = "-var-update --all-values *\n";
+            break;
+        case TGDB_REQUEST_VAR_DELETE:
+            command = std::string("-var-delete ") +
+                request->choice.varobj.name + "\n";
+            break;
+        case TGDB_REQUEST_REGISTER_NAMES:
+            command = "-data-list-register-names\n";
+            break;
+        case TGDB_REQUEST_CHANGED_REGISTERS:
+            command = "-data-list-changed-registers\n";
+            break;
+        case TGDB_REQUEST_REGISTER_VALUES:
+            command = std::string("-data-list-register-values N ") +
+                request->choice.register_values.numbers + "\n";
+            break;
+        case TGDB_REQUEST_THREAD_INFO:
+            str = sys_aprintf("-thread-info %d\n", request->choice.thread.id);
+            command = str;
+            free(str);
+            str = NULL;
+            break;
+        case TGDB_REQUEST_SELECT_THREAD:
+            str = sys_aprintf("-thread-select %d\n",
+                    request->choice.thread.id);
+            command = str;
+            free(str);
+            str = NULL;
+            break;
+        case TGDB_REQUEST_READ_MEMORY:
+            str = sys_aprintf(" %d\n", request->choice.read_memory.count);
+            command = "-data-read-memory-bytes " +
+                tgdb_mi_quote(request->choice.read_memory.addr) + str;
+            free(str);
+            str = NULL;
+            break;
     }
 
     return 0;
@@ -1418,18 +3031,21 @@ int tgdb_signal_notification(struct tgdb *tgdb, int signum)
     if (signum == SIGINT) {     /* ^c */
         tgdb->control_c = 1;
         sig_char = &t.c_cc[VINTR];
-        if (write(tgdb->debugger_stdin, sig_char, 1) < 1)
-            return -1;
     } else if (signum == SIGQUIT) { /* ^\ */
         sig_char = &t.c_cc[VQUIT];
-        if (write(tgdb->debugger_stdin, sig_char, 1) < 1)
-            return -1;
     } else if (signum == SIGCHLD) {
         // GDB has died, clean up the zombie and send the quit command
         tgdb_handle_sigchld(tgdb);
         tgdb_add_quit_command(tgdb, false);
     }
 
+    /* The signal character goes after the keys typed before it. If gdb
+     * isn't reading, it stays queued until gdb takes it. */
+    if (sig_char) {
+        tgdb_queue_output(&tgdb->console_output, (const char *)sig_char, 1);
+        return tgdb_flush(tgdb);
+    }
+
     return 0;
 }
 
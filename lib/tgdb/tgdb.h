@@ -6,6 +6,7 @@
 #endif
 
 #include <list>
+#include <vector>
 
 /*! 
  * \file
@@ -95,6 +96,134 @@
         const char *func;
     };
 
+    // A line of disassembly, formatted as the CLI disassemble command would.
+    struct tgdb_disasm_line {
+        // The address of the instruction, or 0 if the line is not an
+        // instruction, like a source line or a title.
+        uint64_t addr;
+
+        // The text to display
+        std::string text;
+    };
+
+    // A frame of the stack of the selected thread.
+    struct tgdb_frame {
+        // The frame number, where 0 is the innermost frame
+        int level;
+
+        // The address ($pc value) of the frame or 0 if unknown
+        uint64_t addr;
+
+        // The function name or empty if unknown
+        std::string func;
+
+        // The path to the file, absolute if GDB knows it, or empty if unknown
+        std::string path;
+
+        // The line number in the file or 0 if unknown
+        int line;
+
+        // The shared library the function is in, or empty if unknown
+        std::string from;
+    };
+
+    // A GDB variable object, an expression GDB keeps evaluating.
+    struct tgdb_varobj {
+        // The name GDB knows the variable object by
+        std::string name;
+
+        // What a child is of its parent, like a field name, or empty
+        std::string exp;
+
+        // The value, or empty if there is none
+        std::string value;
+
+        // The type, or empty if there is none
+        std::string type;
+
+        // The number of children
+        int numchild;
+    };
+
+    // A variable object that changed since it was last updated.
+    struct tgdb_varobj_change {
+        // The name GDB knows the variable object by
+        std::string name;
+
+        // The new value
+        std::string value;
+
+        // False if the variable object can't be evaluated now
+        bool in_scope;
+
+        // True if the variable object can never be evaluated again.
+        // It should be deleted.
+        bool invalid;
+
+        // True if the type changed, the children were deleted.
+        bool type_changed;
+
+        // The new type, when type_changed is true
+        std::string new_type;
+
+        // The new number of children, or -1 if it didn't change
+        int new_num_children;
+    };
+
+    // A register of the selected frame.
+    struct tgdb_register {
+        // The number GDB knows the register by
+        int number;
+
+        // The name, when the names were requested
+        std::string name;
+
+        // The value in GDB's natural format, when the values were requested
+        std::string value;
+    };
+
+    // A thread of the program, as tracked from GDB's notifications.
+    struct tgdb_thread {
+        // The global number GDB knows the thread by
+        int id;
+
+        // The thread group (the process) the thread is in, like "i1"
+        std::string group_id;
+
+        // True if the thread is running
+        bool running;
+    };
+
+    // The details of a thread, from -thread-info.
+    struct tgdb_thread_info {
+        // The global number GDB knows the thread by
+        int id;
+
+        // The target's name for the thread, like "Thread 0x7f (LWP 42)"
+        std::string target_id;
+
+        // The name of the thread, or empty if it has none
+        std::string name;
+
+        // True if the thread is running, it has no frame
+        bool running;
+
+        // The core the thread was last seen on, or -1 if unknown
+        int core;
+
+        // The innermost frame, when the thread isn't running
+        tgdb_frame frame;
+    };
+
+    // Memory that could be read. Memory that couldn't be read is left out.
+    struct tgdb_memory_block {
+        // The address of the first byte
+        uint64_t begin;
+
+        // The bytes
+        std::vector<unsigned char> contents;
+    };
+
     enum tgdb_request_type {
         // Get a list of all the source files in the program being debugged
         TGDB_REQUEST_INFO_SOURCES,
@@ -163,8 +292,59 @@
         // Request GDB to disassemble a function.
         TGDB_REQUEST_DISASSEMBLE_FUNC,
 
+        // Request GDB to disassemble the instructions in an address range.
+        TGDB_REQUEST_DISASSEMBLE_RANGE,
+
         // Request GDB to skip to the given line.
-        TGDB_REQUEST_UNTIL_LINE
+        TGDB_REQUEST_UNTIL_LINE,
+
+        // Get a range of the frames of the stack.
+        //
+        // GDB only unwinds as far as the last frame asked for, so deep
+        // stacks are fetched a window at a time.
+        TGDB_REQUEST_STACK_FRAMES,
+
+        // Select a frame of the stack, like the frame command.
+        TGDB_REQUEST_SELECT_FRAME,
+
+        // Get the names of the locals and arguments of the selected frame.
+        TGDB_REQUEST_STACK_VARIABLES,
+
+        // Create a variable object for an expression.
+        TGDB_REQUEST_VAR_CREATE,
+
+        // Get the children of a variable object.
+        TGDB_REQUEST_VAR_LIST_CHILDREN,
+
+        // Get the variable objects whose values changed.
+        //
+        // GDB only reports the changes, so the cost of a stop doesn't
+        // grow with the size of the variables being looked at.
+        TGDB_REQUEST_VAR_UPDATE,
+
+        // Delete a variable object and its children.
+        TGDB_REQUEST_VAR_DELETE,
+
+        // Get the names of the registers.
+        TGDB_REQUEST_REGISTER_NAMES,
+
+        // Get the registers that changed since this was last requested.
+        //
+        // Only the values of those registers need to be requested again,
+        // so a stop doesn't cost the whole register file.
+        TGDB_REQUEST_CHANGED_REGISTERS,
+
+        // Get the values of some registers.
+        TGDB_REQUEST_REGISTER_VALUES,
+
+        // Read memory from the program.
+        TGDB_REQUEST_READ_MEMORY,
+
+        // Get the details of a thread.
+        TGDB_REQUEST_THREAD_INFO,
+
+        // Select a thread, like the thread command.
+        TGDB_REQUEST_SELECT_THREAD
     };
 
     // This is the commands interface used between the front end and TGDB.
@@ -314,7 +494,7 @@
          */
         void (*tgdb_disassemble_func_fn)(void *context,
                 uint64_t addr_start, uint64_t addr_end, bool error,
-                const std::list<std::string> &disasm);
+                const std::list<tgdb_disasm_line> &disasm);
 
         /**
          * The disassemble for the $pc.
@@ -340,7 +520,30 @@
          */
         void (*tgdb_disassemble_pc_fn)(void *context,
                 uint64_t addr_start, uint64_t addr_end, bool error,
-                const std::list<std::string> &disasm);
+                const std::list<tgdb_disasm_line> &disasm);
+
+        /**
+         * The disassemble for an address range.
+         *
+         * @param context
+         * The tgdb instance to operate on
+         *
+         * @param addr_start
+         * The start address that was requested
+         *
+         * @param addr_end
+         * The end address that was requested
+         *
+         * @param error
+         * If an error occurred getting the disassembly
+         * In this case, the disasm param should not be used
+         *
+         * @param disasm
+         * The disassembly of the instructions that start in the range
+         */
+        void (*tgdb_disassemble_range_fn)(void *context,
+                uint64_t addr_start, uint64_t addr_end, bool error,
+                const std::list<tgdb_disasm_line> &disasm);
 
         /**
          * Update the file position
@@ -353,6 +556,235 @@
          */
         void (*tgdb_update_file_pos_fn)(void *context,
                 const tgdb_file_position &file_position);
+
+        /**
+         * A range of the frames of the stack.
+         *
+         * @param context
+         * The tgdb instance to operate on
+         *
+         * @param low
+         * The first frame that was requested
+         *
+         * @param high
+         * The last frame that was requested
+         *
+         * @param error
+         * If an error occurred getting the frames, like when low is past
+         * the outermost frame or the program is not running.
+         * In this case, the frames param should not be used
+         *
+         * @param frames
+         * The frames from low up to high, fewer than requested if the
+         * outermost frame was reached
+         */
+        void (*tgdb_stack_frames_fn)(void *context, int low, int high,
+                bool error, const std::list<tgdb_frame> &frames);
+
+        /**
+         * The program stopped, or another thread was selected.
+         *
+         * The frames gotten before this are out of date.
+         *
+         * @param context
+         * The tgdb instance to operate on
+         */
+        void (*tgdb_stack_changed_fn)(void *context);
+
+        /**
+         * The program stopped, or another thread or frame was selected.
+         *
+         * The locals of the selected frame may be different.
+         *
+         * @param context
+         * The tgdb instance to operate on
+         */
+        void (*tgdb_frame_changed_fn)(void *context);
+
+        /**
+         * The locals and arguments of the selected frame.
+         *
+         * @param context
+         * The tgdb instance to operate on
+         *
+         * @param error
+         * If an error occurred getting the variables, like when the
+         * program is not running.
+         * In this case, the names param should not be used
+         *
+         * @param names
+         * The names of the arguments and the locals, innermost block first
+         */
+        void (*tgdb_stack_variables_fn)(void *context, bool error,
+                const std::list<std::string> &names);
+
+        /**
+         * A variable object was created.
+         *
+         * @param context
+         * The tgdb instance to operate on
+         *
+         * @param name
+         * The name the variable object was requested with
+         *
+         * @param error
+         * If the variable object couldn't be created, like when the
+         * expression can't be evaluated in the selected frame.
+         * In this case, the varobj param should not be used
+         *
+         * @param varobj
+         * The new variable object
+         */
+        void (*tgdb_var_created_fn)(void *context, const std::string &name,
+                bool error, const tgdb_varobj &varobj);
+
+        /**
+         * The children of a variable object.
+         *
+         * @param context
+         * The tgdb instance to operate on
+         *
+         * @param name
+         * The variable object whose children were requested
+         *
+         * @param error
+         * If an error occurred getting the children.
+         * In this case, the children param should not be used
+         *
+         * @param children
+         * The children, GDB created a variable object for each
+         */
+        void (*tgdb_var_children_fn)(void *context, const std::string &name,
+                bool error, const std::list<tgdb_varobj> &children);
+
+        /**
+         * The variable objects that changed since the last update.
+         *
+         * @param context
+         * The tgdb instance to operate on
+         *
+         * @param error
+         * If an error occurred updating the variable objects.
+         * In this case, the changes param should not be used
+         *
+         * @param changes
+         * The variable objects that changed
+         */
+        void (*tgdb_var_changes_fn)(void *context, bool error,
+                const std::list<tgdb_varobj_change> &changes);
+
+        /**
+         * The names of the registers.
+         *
+         * @param context
+         * The tgdb instance to operate on
+         *
+         * @param error
+         * If an error occurred getting the names.
+         * In this case, the registers param should not be used
+         *
+         * @param registers
+         * The registers, by number, with only the name set
+         */
+        void (*tgdb_register_names_fn)(void *context, bool error,
+                const std::list<tgdb_register> &registers);
+
+        /**
+         * The registers that changed since they were last asked for.
+         *
+         * @param context
+         * The tgdb instance to operate on
+         *
+         * @param error
+         * If an error occurred, like when the program is not running.
+         * In this case, the numbers param should not be used
+         *
+         * @param numbers
+         * The numbers of the registers that changed
+         */
+        void (*tgdb_changed_registers_fn)(void *context, bool error,
+                const std::list<int> &numbers);
+
+        /**
+         * The values of the registers that were asked for.
+         *
+         * @param context
+         * The tgdb instance to operate on
+         *
+         * @param error
+         * If an error occurred getting the values.
+         * In this case, the registers param should not be used
+         *
+         * @param registers
+         * The registers, with only the value set
+         */
+        void (*tgdb_register_values_fn)(void *context, bool error,
+                const std::list<tgdb_register> &registers);
+
+        /**
+         * Memory that was read.
+         *
+         * @param context
+         * The tgdb instance to operate on
+         *
+         * @param addr
+         * The address expression the memory was requested with
+         *
+         * @param start
+         * The address addr evaluated to, when error is false
+         *
+         * @param count
+         * The number of bytes requested
+         *
+         * @param error
+         * If none of the memory could be read.
+         * In this case, the start and blocks params should not be used
+         *
+         * @param blocks
+         * The memory that could be read, lowest address first
+         */
+        void (*tgdb_memory_fn)(void *context, const std::string &addr,
+                uint64_t start, int count, bool error,
+                const std::list<tgdb_memory_block> &blocks);
+
+        /**
+         * A thread was created, exited, started running or stopped.
+         *
+         * The threads are gotten with tgdb_get_threads.
+         *
+         * @param context
+         * The tgdb instance to operate on
+         */
+        void (*tgdb_threads_changed_fn)(void *context);
+
+        /**
+         * The details of a thread.
+         *
+         * @param context
+         * The tgdb instance to operate on
+         *
+         * @param id
+         * The thread the details were requested for
+         *
+         * @param error
+         * If an error occurred, like when the thread exited.
+         * In this case, the info param should not be used
+         *
+         * @param info
+         * The details of the thread
+         */
+        void (*tgdb_thread_info_fn)(void *context, int id, bool error,
+                const tgdb_thread_info &info);
+
+        /**
+         * GDB gave its first prompt, it is done loading the program.
+         *
+         * The commands requested before it was ready are sent now.
+         *
+         * @param context
+         * The tgdb instance to operate on
+         */
+        void (*tgdb_gdb_started_fn)(void *context);
     };
 
   /**
@@ -462,6 +894,50 @@
      */
     int tgdb_send_char(struct tgdb *tgdb, char c);
 
+    /**
+     * Send several characters to the gdb console at once.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     *
+     * \param buf
+     * The characters to send to the gdb console
+     *
+     * \param n
+     * The number of characters in buf
+     *
+     * \return
+     * 0 on sucess, or -1 on error
+     */
+    int tgdb_send_chars(struct tgdb *tgdb, const char *buf, size_t n);
+
+    /**
+     * Write the commands and characters queued for gdb.
+     *
+     * Commands and characters sent to gdb are queued, and written
+     * together when this is called, once per pass through the caller's
+     * main loop. Nothing blocks if gdb is not reading, what gdb does not
+     * take stays queued for the next call.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     *
+     * \return
+     * 0 on sucess, or -1 on error
+     */
+    int tgdb_flush(struct tgdb *tgdb);
+
+    /**
+     * Determine if some of the queued output was not written yet.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     *
+     * \return
+     * 1 if tgdb_flush should be called again, otherwise 0
+     */
+    int tgdb_has_pending_output(struct tgdb *tgdb);
+
     /**
      * Resize the gdb console.
      *
@@ -479,6 +955,45 @@
      */
     int tgdb_resize_console(struct tgdb *tgdb, int rows, int cols);
 
+    /**
+     * Record the raw bytes read from and written to GDB, on both the
+     * console and the mi channel, to a file.
+     *
+     * Each read and write is stored with the time it happened, so the
+     * exact stream GDB produced can later be fed back with tgdb_replay.
+     * Recording stops when tgdb_shutdown is called.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     *
+     * \param path
+     * The file to record to. It is overwritten if it exists.
+     *
+     * \return
+     * 0 on sucess, or -1 on error
+     */
+    int tgdb_record_start(struct tgdb *tgdb, const char *path);
+
+    /**
+     * Feed a recording made by tgdb_record_start through tgdb, as if
+     * the recorded GDB were running.
+     *
+     * The recorded reads are processed in order as fast as possible, the
+     * console output and responses are sent to the callbacks as usual.
+     * Nothing is written to GDB from here on, tgdb_start_gdb should not
+     * be called on this instance.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     *
+     * \param path
+     * The recording to replay.
+     *
+     * \return
+     * 0 on sucess, or -1 on error
+     */
+    int tgdb_replay(struct tgdb *tgdb, const char *path);
+
 /*@}*/
 /* }}}*/
 
@@ -495,6 +1010,10 @@
   /**
    * Gets a list of source files that make up the program being debugged.
    *
+   * The list is remembered until GDB loads or unloads a library, or
+   * starts a new process. Until then, the remembered list is sent to the
+   * tgdb_inferiors_soure_files_fn callback right away, without asking GDB.
+   *
    * \param tgdb
    * An instance of the tgdb library to operate on.
    */
@@ -562,6 +1081,21 @@
      */
     void tgdb_request_disassemble_pc(struct tgdb *tgdb, int lines);
 
+    /**
+     * Used to get the disassembly of part of memory, a window at a time.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     *
+     * \param addr_start
+     * The address of the first instruction to disassemble.
+     *
+     * \param addr_end
+     * The instructions starting before this address are disassembled.
+     */
+    void tgdb_request_disassemble_range(struct tgdb *tgdb,
+            uint64_t addr_start, uint64_t addr_end);
+
    /**
     * Get disassembly for entire function.
     *
@@ -595,6 +1129,181 @@
     void tgdb_request_until_line(struct tgdb *tgdb,
             const char *file, int line, uint64_t addr);
 
+    /**
+     * Get a range of the frames of the stack of the selected thread.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     *
+     * \param low
+     * The first frame to get, where 0 is the innermost frame.
+     *
+     * \param high
+     * The last frame to get.
+     */
+    void tgdb_request_stack_frames(struct tgdb *tgdb, int low, int high);
+
+    /**
+     * Select a frame of the stack of the selected thread.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     *
+     * \param level
+     * The frame to select, where 0 is the innermost frame.
+     */
+    void tgdb_request_select_frame(struct tgdb *tgdb, int level);
+
+    /**
+     * Get the names of the locals and arguments of the selected frame.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     */
+    void tgdb_request_stack_variables(struct tgdb *tgdb);
+
+    /**
+     * Create a variable object for an expression.
+     *
+     * The variable object floats, it is evaluated in whichever frame is
+     * selected when it is updated.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     *
+     * \param name
+     * The name to give the variable object, it must be unique.
+     *
+     * \param expr
+     * The expression to evaluate.
+     */
+    void tgdb_request_var_create(struct tgdb *tgdb, const char *name,
+            const char *expr);
+
+    /**
+     * Get the children of a variable object, with their values.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     *
+     * \param name
+     * The variable object to get the children of.
+     */
+    void tgdb_request_var_list_children(struct tgdb *tgdb, const char *name);
+
+    /**
+     * Get the values of all the variable objects that changed since they
+     * were last updated.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     */
+    void tgdb_request_var_update(struct tgdb *tgdb);
+
+    /**
+     * Delete a variable object and its children.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     *
+     * \param name
+     * The variable object to delete.
+     */
+    void tgdb_request_var_delete(struct tgdb *tgdb, const char *name);
+
+    /**
+     * Get the names of the registers.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     */
+    void tgdb_request_register_names(struct tgdb *tgdb);
+
+    /**
+     * Get the registers that changed since this was last requested.
+     *
+     * The first request sets where the changes are counted from.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     */
+    void tgdb_request_changed_registers(struct tgdb *tgdb);
+
+    /**
+     * Get the values of some registers in the selected frame.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     *
+     * \param numbers
+     * The numbers of the registers, nothing is requested if empty.
+     */
+    void tgdb_request_register_values(struct tgdb *tgdb,
+            const std::list<int> &numbers);
+
+    /**
+     * Read memory from the program.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     *
+     * \param addr
+     * An expression for the address of the first byte, like 0x601040
+     * or &buf.
+     *
+     * \param count
+     * The number of bytes to read.
+     */
+    void tgdb_request_read_memory(struct tgdb *tgdb, const char *addr,
+            int count);
+
+    /**
+     * Get the details of a thread, like its frame.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     *
+     * \param id
+     * The global number of the thread.
+     */
+    void tgdb_request_thread_info(struct tgdb *tgdb, int id);
+
+    /**
+     * Select a thread.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     *
+     * \param id
+     * The global number of the thread.
+     */
+    void tgdb_request_select_thread(struct tgdb *tgdb, int id);
+
+    /**
+     * Get the threads of the program.
+     *
+     * TGDB keeps the threads up to date from GDB's notifications, so
+     * getting them doesn't ask GDB for anything.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     *
+     * @return
+     * The threads, by increasing id.
+     */
+    const std::vector<tgdb_thread> &tgdb_get_threads(struct tgdb *tgdb);
+
+    /**
+     * Get the thread the program last stopped in or that was last selected.
+     *
+     * \param tgdb
+     * An instance of the tgdb library to operate on.
+     *
+     * @return
+     * The global number of the thread, or -1 if there is none.
+     */
+    int tgdb_get_current_thread(struct tgdb *tgdb);
+
 /*@}*/
 /* }}}*/
 
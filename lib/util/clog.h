@@ -6,6 +6,7 @@
  * - Four log levels (debug, info, warn, error).
  * - Custom formats.
  * - Fast.
+ * - Optional buffering, flushed by the application when it is idle.
  *
  * Dependencies:
  * - Should conform to C89, C++98 (but requires vsnprintf, unfortunately).
@@ -83,6 +84,10 @@
  * they will not appear in the log. */
 #define CLOG_DATETIME_LENGTH 256
 
+/* A buffered logger writes out its pending messages once they grow past
+ * this many bytes, even if the application hasn't flushed it. */
+#define CLOG_BUFFER_LIMIT 65536
+
 /* Default format strings. */
 #define CLOG_DEFAULT_FORMAT "%d %t %f(%n): %l: %m\n"
 #define CLOG_DEFAULT_DATE_FORMAT "%Y-%m-%d"
@@ -237,6 +242,44 @@ int clog_set_date_fmt(int id, const char *fmt);
  */
 int clog_set_fmt(int id, const char *fmt);
 
+/**
+ * Turn buffering on or off for a logger.  A buffered logger keeps formatted
+ * messages in memory until clog_flush is called, the buffer grows past
+ * CLOG_BUFFER_LIMIT bytes, an error is logged or the logger is freed.
+ * Loggers are created unbuffered.  Turning buffering off flushes the logger.
+ *
+ * @param id
+ * The identifier of the logger.
+ *
+ * @param buffered
+ * Non-zero to buffer messages, zero to write each message as it is logged.
+ *
+ * @return
+ * Zero on success, non-zero on failure.
+ */
+int clog_set_buffered(int id, int buffered);
+
+/**
+ * Write out the messages waiting in a buffered logger.
+ *
+ * @param id
+ * The identifier of the logger.
+ */
+void clog_flush(int id);
+
+/**
+ * Write out the messages waiting in every logger.  An application with
+ * buffered loggers should call this before it blocks waiting for input.
+ */
+void clog_flush_all(void);
+
+/**
+ * Throw away the messages waiting in every logger and stop buffering.
+ * A child process calls this right after fork, as the parent still writes
+ * out the messages it had waiting. Otherwise they would be logged twice.
+ */
+void clog_forked(void);
+
 /*
  * No need to read below this point.
  */
@@ -275,6 +318,21 @@ struct clog {
 
     /* Tracks whether the fd needs to be closed eventually. */
     int opened;
+
+    /* Non-zero if messages are kept in buf until the logger is flushed. */
+    int buffered;
+
+    /* Formatted messages not yet written to fd. */
+    char *buf;
+    size_t buf_len;
+    size_t buf_size;
+
+    /* The date and time last formatted, and the second they were formatted
+     * for. Loggers are written many times a second, so localtime and
+     * strftime only run when the second changes. */
+    time_t stamp;
+    char date[CLOG_DATETIME_LENGTH];
+    char time[CLOG_DATETIME_LENGTH];
 };
 
 void _clog_err(const char *fmt, ...) ATTRIBUTE_PRINTF(1, 2);
@@ -329,6 +387,11 @@ clog_init_fd(int id, int fd)
     logger->level = CLOG_DEBUG;
     logger->fd = fd;
     logger->opened = 0;
+    logger->buffered = 0;
+    logger->buf = NULL;
+    logger->buf_len = 0;
+    logger->buf_size = 0;
+    logger->stamp = (time_t) -1;
     strcpy(logger->fmt, CLOG_DEFAULT_FORMAT);
     strcpy(logger->date_fmt, CLOG_DEFAULT_DATE_FORMAT);
     strcpy(logger->time_fmt, CLOG_DEFAULT_TIME_FORMAT);
@@ -341,9 +404,11 @@ void
 clog_free(int id)
 {
     if (_clog_loggers[id]) {
+        clog_flush(id);
         if (_clog_loggers[id]->opened) {
             close(_clog_loggers[id]->fd);
         }
+        free(_clog_loggers[id]->buf);
         free(_clog_loggers[id]);
         _clog_loggers[ id ] = 0;
     }
@@ -375,6 +440,7 @@ clog_set_time_fmt(int id, const char *fmt)
         return 1;
     }
     strcpy(logger->time_fmt, fmt);
+    logger->stamp = (time_t) -1;
     return 0;
 }
 
@@ -391,6 +457,7 @@ clog_set_date_fmt(int id, const char *fmt)
         return 1;
     }
     strcpy(logger->date_fmt, fmt);
+    logger->stamp = (time_t) -1;
     return 0;
 }
 
@@ -410,51 +477,134 @@ clog_set_fmt(int id, const char *fmt)
     return 0;
 }
 
-/* Internal functions */
+int
+clog_set_buffered(int id, int buffered)
+{
+    struct clog *logger = _clog_loggers[id];
+    if (logger == NULL) {
+        _clog_err("clog_set_buffered: No such logger: %d\n", id);
+        return 1;
+    }
+    logger->buffered = buffered;
+    if (!buffered) {
+        clog_flush(id);
+    }
+    return 0;
+}
 
-size_t
-_clog_append_str(char **dst, char *orig_buf, const char *src, size_t cur_size)
+void
+clog_flush(int id)
 {
-    size_t new_size = cur_size;
+    struct clog *logger = _clog_loggers[id];
+    size_t written = 0;
 
-    while (strlen(*dst) + strlen(src) >= new_size) {
-        new_size *= 2;
+    if (logger == NULL) {
+        return;
     }
-    if (new_size != cur_size) {
-        if (*dst == orig_buf) {
-            *dst = (char *) malloc(new_size);
-            strcpy(*dst, orig_buf);
-        } else {
-            *dst = (char *) realloc(*dst, new_size);
+
+    while (written < logger->buf_len) {
+        ssize_t result = write(logger->fd, logger->buf + written,
+                               logger->buf_len - written);
+        if (result == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            _clog_err("Unable to write to log file: %s\n", strerror(errno));
+            break;
+        }
+        written += result;
+    }
+
+    logger->buf_len = 0;
+}
+
+void
+clog_flush_all(void)
+{
+    int id;
+
+    for (id = 0; id < CLOG_MAX_LOGGERS; ++id) {
+        if (_clog_loggers[id] && _clog_loggers[id]->buf_len > 0) {
+            clog_flush(id);
+        }
+    }
+}
+
+void
+clog_forked(void)
+{
+    int id;
+
+    for (id = 0; id < CLOG_MAX_LOGGERS; ++id) {
+        if (_clog_loggers[id]) {
+            _clog_loggers[id]->buf_len = 0;
+            _clog_loggers[id]->buffered = 0;
         }
     }
+}
+
+/* Internal functions */
+
+int
+_clog_append(struct clog *logger, const char *src, size_t len)
+{
+    if (logger->buf_len + len > logger->buf_size) {
+        size_t new_size = logger->buf_size ? logger->buf_size : 4096;
+        char *new_buf;
+
+        while (logger->buf_len + len > new_size) {
+            new_size *= 2;
+        }
+        new_buf = (char *) realloc(logger->buf, new_size);
+        if (new_buf == NULL) {
+            return 1;
+        }
+        logger->buf = new_buf;
+        logger->buf_size = new_size;
+    }
+
+    memcpy(logger->buf + logger->buf_len, src, len);
+    logger->buf_len += len;
+    return 0;
+}
 
-    strcat(*dst, src);
-    return new_size;
+int
+_clog_append_str(struct clog *logger, const char *src)
+{
+    return _clog_append(logger, src, strlen(src));
 }
 
-size_t
-_clog_append_int(char **dst, char *orig_buf, long int d, size_t cur_size)
+int
+_clog_append_int(struct clog *logger, long int d)
 {
     char buf[40]; /* Enough for 128-bit decimal */
     if (snprintf(buf, 40, "%ld", d) >= 40) {
-        return cur_size;
+        return 0;
     }
-    return _clog_append_str(dst, orig_buf, buf, cur_size);
+    return _clog_append_str(logger, buf);
 }
 
-size_t
-_clog_append_time(char **dst, char *orig_buf, struct tm *lt,
-                  const char *fmt, size_t cur_size)
+void
+_clog_update_stamp(struct clog *logger)
 {
-    char buf[CLOG_DATETIME_LENGTH];
-    size_t result = strftime(buf, CLOG_DATETIME_LENGTH, fmt, lt);
+    time_t t = time(NULL);
+    struct tm *lt;
 
-    if (result > 0) {
-        return _clog_append_str(dst, orig_buf, buf, cur_size);
+    if (t == logger->stamp) {
+        return;
     }
 
-    return cur_size;
+    /* Formatted times and dates that don't fit are left out of the log */
+    lt = localtime(&t);
+    if (strftime(logger->date, CLOG_DATETIME_LENGTH,
+                 logger->date_fmt, lt) == 0) {
+        logger->date[0] = 0;
+    }
+    if (strftime(logger->time, CLOG_DATETIME_LENGTH,
+                 logger->time_fmt, lt) == 0) {
+        logger->time[0] = 0;
+    }
+    logger->stamp = t;
 }
 
 const char *
@@ -473,55 +623,46 @@ _clog_basename(const char *path)
     return path;
 }
 
-char *
-_clog_format(const struct clog *logger, char buf[], size_t buf_size,
-             const char *sfile, int sline, const char *level,
-             const char *message)
+int
+_clog_format(struct clog *logger, const char *sfile, int sline,
+             const char *level, const char *message)
 {
-    size_t cur_size = buf_size;
-    char *result = buf;
     enum { NORMAL, SUBST } state = NORMAL;
-    size_t fmtlen = strlen(logger->fmt);
-    size_t i;
-    time_t t = time(NULL);
-    struct tm *lt = localtime(&t);
+    const char *fmt = logger->fmt;
+    int result = 0;
+
+    _clog_update_stamp(logger);
 
     sfile = _clog_basename(sfile);
-    result[0] = 0;
-    for (i = 0; i < fmtlen; ++i) {
+    for (; *fmt && result == 0; ++fmt) {
         if (state == NORMAL) {
-            if (logger->fmt[i] == '%') {
+            if (*fmt == '%') {
                 state = SUBST;
             } else {
-                char str[2] = { 0 };
-                str[0] = logger->fmt[i];
-                cur_size = _clog_append_str(&result, buf, str, cur_size);
+                result = _clog_append(logger, fmt, 1);
             }
         } else {
-            switch (logger->fmt[i]) {
+            switch (*fmt) {
                 case '%':
-                    cur_size = _clog_append_str(&result, buf, "%", cur_size);
+                    result = _clog_append(logger, "%", 1);
                     break;
                 case 't':
-                    cur_size = _clog_append_time(&result, buf, lt,
-                                                 logger->time_fmt, cur_size);
+                    result = _clog_append_str(logger, logger->time);
                     break;
                 case 'd':
-                    cur_size = _clog_append_time(&result, buf, lt,
-                                                 logger->date_fmt, cur_size);
+                    result = _clog_append_str(logger, logger->date);
                     break;
                 case 'l':
-                    cur_size = _clog_append_str(&result, buf, level, cur_size);
+                    result = _clog_append_str(logger, level);
                     break;
                 case 'n':
-                    cur_size = _clog_append_int(&result, buf, sline, cur_size);
+                    result = _clog_append_int(logger, sline);
                     break;
                 case 'f':
-                    cur_size = _clog_append_str(&result, buf, sfile, cur_size);
+                    result = _clog_append_str(logger, sfile);
                     break;
                 case 'm':
-                    cur_size = _clog_append_str(&result, buf, message,
-                                                cur_size);
+                    result = _clog_append_str(logger, message);
                     break;
             }
             state = NORMAL;
@@ -544,7 +685,6 @@ _clog_log(const char *sfile, int sline, enum clog_level level,
     char buf[4096];
     size_t buf_size = 4096;
     char *dynbuf = buf;
-    char *message;
     va_list ap_copy;
     int result;
     struct clog *logger = _clog_loggers[id];
@@ -575,28 +715,20 @@ _clog_log(const char *sfile, int sline, enum clog_level level,
     }
     va_end(ap_copy);
 
-    /* Format according to log format and write to log */
-    {
-        char message_buf[4096];
-        message = _clog_format(logger, message_buf, 4096, sfile, sline,
-                               CLOG_LEVEL_NAMES[level], dynbuf);
-        if (!message) {
-            _clog_err("Formatting failed (2).\n");
-            if (dynbuf != buf) {
-                free(dynbuf);
-            }
-            return;
-        }
-        result = write(logger->fd, message, strlen(message));
-        if (result == -1) {
-            _clog_err("Unable to write to log file: %s\n", strerror(errno));
-        }
-        if (message != message_buf) {
-            free(message);
-        }
-        if (dynbuf != buf) {
-            free(dynbuf);
-        }
+    /* Format according to log format onto the pending output. Unbuffered
+     * loggers, errors and buffers that have grown too big are written out
+     * right away. */
+    if (_clog_format(logger, sfile, sline, CLOG_LEVEL_NAMES[level],
+                     dynbuf) != 0) {
+        _clog_err("Formatting failed (2).\n");
+    }
+    if (!logger->buffered || level == CLOG_ERROR ||
+        logger->buf_len > CLOG_BUFFER_LIMIT) {
+        clog_flush(id);
+    }
+
+    if (dynbuf != buf) {
+        free(dynbuf);
     }
 }
 
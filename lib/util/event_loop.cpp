@@ -0,0 +1,366 @@
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#if HAVE_STDLIB_H
+#include <stdlib.h>
+#endif /* HAVE_STDLIB_H */
+
+#if HAVE_STRING_H
+#include <string.h>
+#endif /* HAVE_STRING_H */
+
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif /* HAVE_UNISTD_H */
+
+#if HAVE_ERRNO_H
+#include <errno.h>
+#endif /* HAVE_ERRNO_H */
+
+#if HAVE_TIME_H
+#include <time.h>
+#endif /* HAVE_TIME_H */
+
+#if HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+
+#include <vector>
+
+#include "sys_util.h"
+#include "event_loop.h"
+
+struct event_loop_fd {
+    int fd;
+    enum event_loop_priority priority;
+    event_loop_fd_callback callback;
+    void *context;
+};
+
+struct event_loop_timer {
+    int id;
+    unsigned long long deadline;    /* Monotonic milliseconds */
+    event_loop_callback callback;
+    void *context;
+};
+
+struct event_loop_idle {
+    int id;
+    event_loop_callback callback;
+    void *context;
+};
+
+struct event_loop {
+    std::vector<event_loop_fd> fds;
+    std::vector<event_loop_timer> timers;
+    std::vector<event_loop_idle> idles;
+
+    /* The descriptors found readable by the last wait */
+    std::vector<int> ready;
+
+    /* The last id given to a timer or an idle callback */
+    int last_id;
+
+#if HAVE_SYS_EPOLL_H
+    int epoll_fd;
+    std::vector<struct epoll_event> events;
+#else
+    std::vector<struct pollfd> pollfds;
+#endif
+};
+
+static unsigned long long event_loop_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static struct event_loop_fd *event_loop_find_fd(struct event_loop *loop,
+        int fd)
+{
+    for (auto &source : loop->fds) {
+        if (source.fd == fd)
+            return &source;
+    }
+
+    return NULL;
+}
+
+/**
+ * Wait for descriptors to become readable, and fill in loop->ready.
+ *
+ * @param timeout
+ * Milliseconds to wait, 0 to not wait or -1 to wait forever
+ *
+ * @return
+ * The number of readable descriptors, or -1 on error
+ */
+static int event_loop_wait(struct event_loop *loop, int timeout)
+{
+    int count, i;
+
+    loop->ready.clear();
+
+#if HAVE_SYS_EPOLL_H
+    loop->events.resize(loop->fds.size() > 0 ? loop->fds.size() : 1);
+    count = epoll_wait(loop->epoll_fd, loop->events.data(),
+            loop->events.size(), timeout);
+
+    for (i = 0; i < count; ++i)
+        loop->ready.push_back(loop->events[i].data.fd);
+#else
+    loop->pollfds.resize(loop->fds.size());
+    for (i = 0; i < (int)loop->fds.size(); ++i) {
+        loop->pollfds[i].fd = loop->fds[i].fd;
+        loop->pollfds[i].events = POLLIN;
+        loop->pollfds[i].revents = 0;
+    }
+
+    count = poll(loop->pollfds.data(), loop->pollfds.size(), timeout);
+
+    for (i = 0; count > 0 && i < (int)loop->pollfds.size(); ++i) {
+        if (loop->pollfds[i].revents)
+            loop->ready.push_back(loop->pollfds[i].fd);
+    }
+#endif
+
+    return count;
+}
+
+/* Milliseconds until the next timer expires, or -1 if there are none */
+static int event_loop_timeout(struct event_loop *loop)
+{
+    unsigned long long now, next;
+
+    if (loop->timers.empty())
+        return -1;
+
+    now = event_loop_now();
+    next = loop->timers[0].deadline;
+    for (const auto &timer : loop->timers) {
+        if (timer.deadline < next)
+            next = timer.deadline;
+    }
+
+    return next > now ? (int)(next - now) : 0;
+}
+
+/* Call back the expired timers, returns -1 if a callback failed */
+static int event_loop_run_timers(struct event_loop *loop)
+{
+    unsigned long long now = event_loop_now();
+    size_t i = 0;
+
+    while (i < loop->timers.size()) {
+        if (loop->timers[i].deadline <= now) {
+            struct event_loop_timer timer = loop->timers[i];
+
+            /* Remove it first, the callback may add another */
+            loop->timers.erase(loop->timers.begin() + i);
+            if (timer.callback(timer.context) == -1)
+                return -1;
+        } else {
+            ++i;
+        }
+    }
+
+    return 0;
+}
+
+struct event_loop *event_loop_create(void)
+{
+    struct event_loop *loop = new event_loop;
+
+    loop->last_id = 0;
+
+#if HAVE_SYS_EPOLL_H
+    loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (loop->epoll_fd == -1) {
+        clog_error(CLOG_CGDB, "epoll_create1 failed: %s", strerror(errno));
+        delete loop;
+        return NULL;
+    }
+#endif
+
+    return loop;
+}
+
+void event_loop_destroy(struct event_loop *loop)
+{
+    if (!loop)
+        return;
+
+#if HAVE_SYS_EPOLL_H
+    close(loop->epoll_fd);
+#endif
+
+    delete loop;
+}
+
+int event_loop_add_fd(struct event_loop *loop, int fd,
+        enum event_loop_priority priority,
+        event_loop_fd_callback callback, void *context)
+{
+    struct event_loop_fd source;
+
+    if (fd < 0 || event_loop_find_fd(loop, fd)) {
+        clog_error(CLOG_CGDB, "can't watch descriptor %d", fd);
+        return -1;
+    }
+
+#if HAVE_SYS_EPOLL_H
+    struct epoll_event event;
+
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, fd, &event) == -1) {
+        clog_error(CLOG_CGDB, "epoll_ctl add %d failed: %s", fd,
+                strerror(errno));
+        return -1;
+    }
+#endif
+
+    source.fd = fd;
+    source.priority = priority;
+    source.callback = callback;
+    source.context = context;
+    loop->fds.push_back(source);
+
+    return 0;
+}
+
+int event_loop_remove_fd(struct event_loop *loop, int fd)
+{
+    for (auto iter = loop->fds.begin(); iter != loop->fds.end(); ++iter) {
+        if (iter->fd == fd) {
+#if HAVE_SYS_EPOLL_H
+            epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+#endif
+            loop->fds.erase(iter);
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int event_loop_add_timer(struct event_loop *loop, int ms,
+        event_loop_callback callback, void *context)
+{
+    struct event_loop_timer timer;
+
+    timer.id = ++loop->last_id;
+    timer.deadline = event_loop_now() + (ms > 0 ? ms : 0);
+    timer.callback = callback;
+    timer.context = context;
+    loop->timers.push_back(timer);
+
+    return timer.id;
+}
+
+int event_loop_remove_timer(struct event_loop *loop, int id)
+{
+    for (auto iter = loop->timers.begin(); iter != loop->timers.end(); ++iter) {
+        if (iter->id == id) {
+            loop->timers.erase(iter);
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int event_loop_add_idle(struct event_loop *loop,
+        event_loop_callback callback, void *context)
+{
+    struct event_loop_idle idle;
+
+    idle.id = ++loop->last_id;
+    idle.callback = callback;
+    idle.context = context;
+    loop->idles.push_back(idle);
+
+    return idle.id;
+}
+
+int event_loop_remove_idle(struct event_loop *loop, int id)
+{
+    for (auto iter = loop->idles.begin(); iter != loop->idles.end(); ++iter) {
+        if (iter->id == id) {
+            loop->idles.erase(iter);
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int event_loop_run_once(struct event_loop *loop)
+{
+    enum event_loop_priority priority = EVENT_LOOP_PRIORITY_LOW;
+    size_t i;
+    int count;
+
+    /* Look for work without blocking first */
+    count = event_loop_wait(loop, 0);
+
+    if (count == 0 && event_loop_timeout(loop) != 0) {
+        /* Nothing to do, let the idle callbacks run before blocking.
+         * They may add or remove idle callbacks, so copy them. */
+        std::vector<event_loop_idle> idles = loop->idles;
+
+        for (const auto &idle : idles) {
+            if (idle.callback(idle.context) == -1)
+                return -1;
+        }
+
+        count = event_loop_wait(loop, event_loop_timeout(loop));
+    }
+
+    if (count == -1) {
+        if (errno == EINTR)
+            return 0;
+
+        clog_error(CLOG_CGDB, "event loop wait failed: %s", strerror(errno));
+        return -1;
+    }
+
+    /* Only the most important of the readable descriptors are handled,
+     * the rest are found readable again by the next wait */
+    for (i = 0; i < loop->ready.size(); ++i) {
+        struct event_loop_fd *source = event_loop_find_fd(loop, loop->ready[i]);
+
+        if (source && source->priority < priority)
+            priority = source->priority;
+    }
+
+    /* Handle them in the order they were added */
+    for (i = 0; i < loop->fds.size(); ++i) {
+        struct event_loop_fd source = loop->fds[i];
+        bool ready = false;
+
+        if (source.priority != priority)
+            continue;
+
+        for (int fd : loop->ready) {
+            if (fd == source.fd) {
+                ready = true;
+                break;
+            }
+        }
+
+        /* The callback may remove descriptors, including this one */
+        if (ready && event_loop_find_fd(loop, source.fd)) {
+            if (source.callback(source.context, source.fd) == -1)
+                return -1;
+        }
+    }
+
+    return event_loop_run_timers(loop);
+}
@@ -0,0 +1,198 @@
+#ifndef __EVENT_LOOP_H__
+#define __EVENT_LOOP_H__
+
+/*******************************************************************************
+ *
+ * The event loop waits for descriptors to become readable and for timers
+ * to expire, and calls back the code that handles them.
+ *
+ * Each descriptor has a priority. When descriptors of different priorities
+ * are readable at the same time, only the ones with the highest priority
+ * are handled before waiting again. This way a descriptor that is busy,
+ * like a flood of output from gdb, is handled a read at a time in between
+ * the more important ones, like the user's keystrokes.
+ *
+ * Idle callbacks are called when nothing is ready, right before the loop
+ * blocks. Work that can be put off, like drawing or writing out the logs,
+ * can be done there instead of after each read.
+ *
+ * epoll is used when available, otherwise poll.
+ *
+ ******************************************************************************/
+
+/* The priority of a descriptor, handled in this order */
+enum event_loop_priority {
+    EVENT_LOOP_PRIORITY_HIGH,
+    EVENT_LOOP_PRIORITY_DEFAULT,
+    EVENT_LOOP_PRIORITY_LOW
+};
+
+/**
+ * Called when a descriptor is readable.
+ *
+ * @param context
+ * The context the descriptor was added with
+ *
+ * @param fd
+ * The readable descriptor
+ *
+ * @return
+ * 0 on success, or -1 to stop the loop with an error
+ */
+typedef int (*event_loop_fd_callback)(void *context, int fd);
+
+/**
+ * Called when a timer expires, or when the loop is idle.
+ *
+ * @param context
+ * The context the callback was added with
+ *
+ * @return
+ * 0 on success, or -1 to stop the loop with an error
+ */
+typedef int (*event_loop_callback)(void *context);
+
+struct event_loop;
+
+/**
+ * Create an event loop.
+ *
+ * @return
+ * The new event loop, or NULL on error
+ */
+struct event_loop *event_loop_create(void);
+
+/**
+ * Destroy an event loop. The descriptors are not closed.
+ *
+ * @param loop
+ * The event loop to destroy, OK to pass NULL
+ */
+void event_loop_destroy(struct event_loop *loop);
+
+/**
+ * Call back when a descriptor is readable.
+ *
+ * Descriptors of the same priority are handled in the order added.
+ *
+ * @param loop
+ * The event loop
+ *
+ * @param fd
+ * The descriptor to watch, which must not already be watched
+ *
+ * @param priority
+ * The priority of the descriptor
+ *
+ * @param callback
+ * The function to call when fd is readable
+ *
+ * @param context
+ * Passed to callback
+ *
+ * @return
+ * 0 on success, or -1 on error
+ */
+int event_loop_add_fd(struct event_loop *loop, int fd,
+        enum event_loop_priority priority,
+        event_loop_fd_callback callback, void *context);
+
+/**
+ * Stop watching a descriptor.
+ *
+ * @param loop
+ * The event loop
+ *
+ * @param fd
+ * The descriptor to stop watching
+ *
+ * @return
+ * 0 on success, or -1 if fd was not being watched
+ */
+int event_loop_remove_fd(struct event_loop *loop, int fd);
+
+/**
+ * Call back once after some time has passed.
+ *
+ * @param loop
+ * The event loop
+ *
+ * @param ms
+ * The number of milliseconds from now to call back
+ *
+ * @param callback
+ * The function to call
+ *
+ * @param context
+ * Passed to callback
+ *
+ * @return
+ * An id for the timer that is never 0, to remove it with
+ */
+int event_loop_add_timer(struct event_loop *loop, int ms,
+        event_loop_callback callback, void *context);
+
+/**
+ * Cancel a timer that has not expired yet.
+ *
+ * @param loop
+ * The event loop
+ *
+ * @param id
+ * The id the timer was added with
+ *
+ * @return
+ * 0 on success, or -1 if there is no such timer
+ */
+int event_loop_remove_timer(struct event_loop *loop, int id);
+
+/**
+ * Call back each time the loop is about to block.
+ *
+ * @param loop
+ * The event loop
+ *
+ * @param callback
+ * The function to call
+ *
+ * @param context
+ * Passed to callback
+ *
+ * @return
+ * An id for the idle callback that is never 0, to remove it with
+ */
+int event_loop_add_idle(struct event_loop *loop,
+        event_loop_callback callback, void *context);
+
+/**
+ * Stop calling back an idle callback.
+ *
+ * @param loop
+ * The event loop
+ *
+ * @param id
+ * The id the idle callback was added with
+ *
+ * @return
+ * 0 on success, or -1 if there is no such idle callback
+ */
+int event_loop_remove_idle(struct event_loop *loop, int id);
+
+/**
+ * Wait for something to happen and handle it.
+ *
+ * If nothing is ready, the idle callbacks are called and then the loop
+ * waits for a descriptor or the next timer. The readable descriptors of
+ * the highest priority are handled, then the expired timers.
+ *
+ * A signal interrupting the wait is not an error.
+ *
+ * @param loop
+ * The event loop
+ *
+ * @return
+ * 0 on success, or -1 on error or if a callback returned -1
+ */
+int event_loop_run_once(struct event_loop *loop);
+
+#endif
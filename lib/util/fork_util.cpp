@@ -252,6 +252,9 @@ int invoke_debugger(const char *path,
         clog_error(CLOG_CGDB, "fork failed");
         return -1;
     } else if (pid == 0) {      /* child */
+        // The parent writes out the log messages it had waiting
+        clog_forked();
+
         // Close the master fd for new ui
         close(new_ui_masterfd);
         
@@ -122,6 +122,8 @@ ssize_t io_read(int fd, void *buf, size_t count)
     if ((amountRead = read(fd, buf, count)) == -1) {    /* error */
         if (errno == EINTR)
             goto tgdb_read;
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return -1;          /* Non blocking and nothing to read */
         else if (errno != EIO) {
             clog_error(CLOG_CGDB, "error reading from fd");
             return -1;
@@ -258,3 +260,45 @@ int io_getchar(int fd, unsigned int ms, int *key)
     *key = c;
     return 1;
 }
+
+int io_getchars(int fd, unsigned int ms, char *buf, int n)
+{
+    int ret;
+    int flag = 0;
+    int val;
+
+    if (!buf || n <= 0)
+        return -1;
+
+    val = io_data_ready(fd, ms);
+    if (val == -1) {
+        clog_error(CLOG_CGDB, "Errno(%d)\n", errno);
+        return -1;
+    }
+
+    if (val == 0)
+        return 0;               /* Nothing to read. */
+
+    /* Set nonblocking */
+    flag = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flag | O_NONBLOCK);
+
+  read_again:
+
+    /* Read everything that is available */
+    ret = read(fd, buf, n);
+
+    if (ret == -1 && errno == EINTR)
+        goto read_again;
+    else if (ret == -1 && errno != EAGAIN) {
+        clog_error(CLOG_CGDB, "Errno(%d)\n", errno);
+    } else if (ret == 0) {
+        ret = -1;
+        clog_error(CLOG_CGDB, "Read returned nothing\n");
+    }
+
+    /* Set to original state */
+    fcntl(fd, F_SETFL, flag);
+
+    return ret;
+}
@@ -24,7 +24,8 @@ int io_rw_byte(int source, int dest);
  *          data into buf.
  *          Returns: The amount read on success.
  *                   0 on EOF and
- *                   -1 on error 
+ *                   -1 on error, errno is EAGAIN if fd is non blocking
+ *                   and has nothing to read
  */
 ssize_t io_read(int fd, void *buf, size_t count);
 
@@ -86,4 +87,29 @@ int io_data_ready(int fd, int ms);
  */
 int io_getchar(int fd, unsigned int ms, int *key);
 
+/**
+ * Read in all of the characters that are available, up to n.
+ *
+ * This is the same as io_getchar, except that everything that can be read
+ * without blocking is read in with a single read.
+ *
+ * \param fd
+ * The descriptor to read in from.
+ *
+ * \param ms
+ * The The amount of time in milliseconds to wait for input.
+ * Pass 0, if you do not want to wait.
+ * Pass -1, if you want to block indefinitely.
+ *
+ * \param buf
+ * The characters read if the return value is successful
+ *
+ * \param n
+ * The size of buf
+ *
+ * @return
+ * -1 on error, 0 if no data is ready, or the number of characters read
+ */
+int io_getchars(int fd, unsigned int ms, char *buf, int n);
+
 #endif /* __IO_H__ */
@@ -155,6 +155,21 @@ int swin_scrl(int n)
     return scrl(n);
 }
 
+int swin_scrollok(SWINDOW *win, int bf)
+{
+    return scrollok((WINDOW *)win, bf);
+}
+
+int swin_wscrl(SWINDOW *win, int n)
+{
+    return wscrl((WINDOW *)win, n);
+}
+
+int swin_idlok(SWINDOW *win, int bf)
+{
+    return idlok((WINDOW *)win, bf);
+}
+
 int swin_keypad(SWINDOW *win, int bf)
 {
     return keypad((WINDOW *)win, bf);
@@ -210,6 +225,17 @@ int swin_getcury(const SWINDOW *win)
     return getcury((WINDOW *)win);
 }
 
+void swin_getsyx(int *y, int *x)
+{
+    *y = *x = -1;
+    getsyx(*y, *x);
+}
+
+void swin_setsyx(int y, int x)
+{
+    setsyx(y, x);
+}
+
 int swin_getbegx(const SWINDOW *win)
 {
     return getbegx((WINDOW *)win);
@@ -107,6 +107,17 @@ int swin_delwin(SWINDOW *win);
 /* Scroll window up n lines */
 int swin_scrl(int n);   
 
+/* Controls what happens when the cursor of a window is moved off the edge of
+   the window or scrolling region. It must be enabled for swin_wscrl to work. */
+int swin_scrollok(SWINDOW *win, int bf);
+/* Scroll the window up n lines (or down if n is negative). The lines exposed
+   are blanked, the cursor position is not changed. */
+int swin_wscrl(SWINDOW *win, int n);
+/* If enabled, curses may use the terminal's insert/delete line and scroll
+   region capabilities to update the window, instead of redrawing the lines
+   that moved. */
+int swin_idlok(SWINDOW *win, int bf);
+
 /* The keypad option enables the keypad of the user's terminal. If enabled 
    the user can press a function key (such as an arrow key) and wgetch returns
    a single value representing the function key, as in KEY_LEFT. If disabled
@@ -131,6 +142,10 @@ int swin_wattroff(SWINDOW *win, int attrs);
 int swin_getcurx(const SWINDOW *win);
 int swin_getcury(const SWINDOW *win);
 
+/* Get and set where the next doupdate leaves the cursor */
+void swin_getsyx(int *y, int *x);
+void swin_setsyx(int y, int x);
+
 int swin_getbegx(const SWINDOW *win);
 int swin_getbegy(const SWINDOW *win);
 int swin_getmaxx(const SWINDOW *win);
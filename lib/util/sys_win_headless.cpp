@@ -0,0 +1,777 @@
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif /* HAVE_CONFIG_H */
+
+#if HAVE_STDIO_H
+#include <stdio.h>
+#endif /* HAVE_STDIO_H */
+
+#if HAVE_STDARG_H
+#include <stdarg.h>
+#endif /* HAVE_STDARG_H */
+
+#if HAVE_STDLIB_H
+#include <stdlib.h>
+#endif /* HAVE_STDLIB_H */
+
+#if HAVE_STRING_H
+#include <string.h>
+#endif /* HAVE_STRING_H */
+
+#include <algorithm>
+#include <vector>
+
+#include "sys_util.h"
+#include "sys_win.h"
+#include "sys_win_headless.h"
+
+/* The attributes are laid out like curses lays them out. The low byte of
+ * a SWIN_CHTYPE is the character, the next byte is the color pair and the
+ * bits above that are the attributes. */
+#define HEADLESS_CHAR_MASK 0xff
+#define HEADLESS_PAIR_SHIFT 8
+#define HEADLESS_PAIR_MASK (0xff << HEADLESS_PAIR_SHIFT)
+
+const int SWIN_A_NORMAL = 0;
+const int SWIN_A_STANDOUT = 1 << 16;
+const int SWIN_A_UNDERLINE = 1 << 17;
+const int SWIN_A_REVERSE = 1 << 18;
+const int SWIN_A_BLINK = 1 << 19;
+const int SWIN_A_DIM = 1 << 20;
+const int SWIN_A_BOLD = 1 << 21;
+
+const int SWIN_KEY_BACKSPACE = 0407;
+
+SWIN_CHTYPE SWIN_SYM_VLINE;
+SWIN_CHTYPE SWIN_SYM_HLINE;
+SWIN_CHTYPE SWIN_SYM_LTEE;
+
+#define HEADLESS_COLORS 256
+#define HEADLESS_COLOR_PAIRS 256
+
+/* A position on a window or the screen */
+struct headless_cell {
+    /* The unicode character, 0 for a cell covered by a wide character */
+    int ch;
+    /* The attributes and color pair */
+    int attrs;
+};
+
+struct SWINDOW {
+    int begy, begx;
+    int lines, cols;
+    int cury, curx;
+
+    /* Attributes turned on with swin_wattron */
+    int attrs;
+    int scrollok;
+    int idlok;
+
+    /* The lines scrolled since the last swin_wnoutrefresh */
+    int scrolled;
+
+    std::vector<headless_cell> cells;
+};
+
+static int headless_lines = 24;
+static int headless_cols = 80;
+
+static SWINDOW *stdscr_win;
+
+/* What the windows copied with swin_wnoutrefresh want on the screen */
+static std::vector<headless_cell> virtual_screen;
+
+/* What the terminal is showing */
+static std::vector<headless_cell> physical_screen;
+
+/* Where the terminal cursor is and the attributes it is drawing with */
+static int term_y, term_x, term_attrs;
+
+/* A scroll of screen lines that swin_doupdate does with a scroll region */
+struct headless_scroll {
+    int top, bottom;
+    int n;
+};
+
+/* The scrolls of idlok windows copied with swin_wnoutrefresh */
+static std::vector<headless_scroll> pending_scrolls;
+
+/* Where swin_doupdate leaves the cursor, set by swin_wnoutrefresh */
+static int virtual_y, virtual_x;
+
+static size_t bytes_emitted;
+static size_t updates;
+
+static short pair_fore[HEADLESS_COLOR_PAIRS];
+static short pair_back[HEADLESS_COLOR_PAIRS];
+
+static const headless_cell blank_cell = { ' ', 0 };
+
+static headless_cell *win_cell(SWINDOW *win, int y, int x)
+{
+    return &win->cells[y * win->cols + x];
+}
+
+static void headless_clear_screens(void)
+{
+    int size = headless_lines * headless_cols;
+
+    virtual_screen.assign(size, blank_cell);
+    physical_screen.assign(size, blank_cell);
+    term_y = term_x = term_attrs = 0;
+    virtual_y = virtual_x = 0;
+    pending_scrolls.clear();
+}
+
+void swin_headless_set_size(int lines, int cols)
+{
+    headless_lines = lines;
+    headless_cols = cols;
+}
+
+size_t swin_headless_bytes_emitted(void)
+{
+    return bytes_emitted;
+}
+
+size_t swin_headless_updates(void)
+{
+    return updates;
+}
+
+int swin_headless_char_at(int y, int x)
+{
+    if (y < 0 || y >= headless_lines || x < 0 || x >= headless_cols ||
+        physical_screen.empty())
+        return 0;
+
+    return physical_screen[y * headless_cols + x].ch;
+}
+
+bool swin_start()
+{
+    bool success = swin_initscr() != NULL;
+    if (success) {
+        swin_start_color();
+        swin_use_default_colors();
+        swin_refresh();
+    }
+
+    return success;
+}
+
+SWINDOW *swin_initscr()
+{
+    SWIN_SYM_VLINE = '|';
+    SWIN_SYM_HLINE = '-';
+    SWIN_SYM_LTEE = '+';
+
+    if (!stdscr_win) {
+        headless_clear_screens();
+        bytes_emitted = 0;
+        updates = 0;
+        stdscr_win = swin_newwin(headless_lines, headless_cols, 0, 0);
+    }
+
+    return stdscr_win;
+}
+
+int swin_endwin()
+{
+    if (stdscr_win) {
+        swin_delwin(stdscr_win);
+        stdscr_win = NULL;
+    }
+
+    return 0;
+}
+
+int swin_lines()
+{
+    return headless_lines;
+}
+
+int swin_cols()
+{
+    return headless_cols;
+}
+
+int swin_colors()
+{
+    return HEADLESS_COLORS;
+}
+
+int swin_color_pairs()
+{
+    return HEADLESS_COLOR_PAIRS;
+}
+
+int swin_has_colors()
+{
+    return 1;
+}
+
+int swin_start_color()
+{
+    int i;
+
+    for (i = 0; i < HEADLESS_COLOR_PAIRS; ++i) {
+        pair_fore[i] = COLOR_WHITE;
+        pair_back[i] = COLOR_BLACK;
+    }
+
+    return 0;
+}
+
+int swin_use_default_colors()
+{
+    pair_fore[0] = -1;
+    pair_back[0] = -1;
+
+    return 0;
+}
+
+bool swin_supports_default_color_pairs_extension()
+{
+    return true;
+}
+
+int swin_resizeterm(int lines, int columns)
+{
+    headless_lines = lines;
+    headless_cols = columns;
+    headless_clear_screens();
+
+    if (stdscr_win) {
+        stdscr_win->lines = lines;
+        stdscr_win->cols = columns;
+        stdscr_win->cury = stdscr_win->curx = 0;
+        stdscr_win->cells.assign(lines * columns, blank_cell);
+    }
+
+    return 0;
+}
+
+SWINDOW *swin_newwin(int nlines, int ncols, int begin_y, int begin_x)
+{
+    SWINDOW *win;
+
+    /* Like curses, zero means to the edge of the screen */
+    if (nlines == 0)
+        nlines = headless_lines - begin_y;
+    if (ncols == 0)
+        ncols = headless_cols - begin_x;
+
+    if (nlines <= 0 || ncols <= 0)
+        return NULL;
+
+    win = new SWINDOW();
+    win->begy = begin_y;
+    win->begx = begin_x;
+    win->lines = nlines;
+    win->cols = ncols;
+    win->cury = win->curx = 0;
+    win->attrs = 0;
+    win->scrollok = 0;
+    win->idlok = 0;
+    win->scrolled = 0;
+    win->cells.assign(nlines * ncols, blank_cell);
+
+    return win;
+}
+
+int swin_delwin(SWINDOW *win)
+{
+    delete win;
+    return 0;
+}
+
+int swin_scrl(int n)
+{
+    return swin_wscrl(stdscr_win, n);
+}
+
+int swin_scrollok(SWINDOW *win, int bf)
+{
+    win->scrollok = bf;
+    return 0;
+}
+
+int swin_wscrl(SWINDOW *win, int n)
+{
+    int y;
+
+    if (!win)
+        return -1;
+
+    if (n > win->lines)
+        n = win->lines;
+    else if (n < -win->lines)
+        n = -win->lines;
+
+    win->scrolled += n;
+
+    if (n > 0) {
+        for (y = 0; y < win->lines - n; ++y)
+            memcpy(win_cell(win, y, 0), win_cell(win, y + n, 0),
+                   win->cols * sizeof(headless_cell));
+        for (; y < win->lines; ++y)
+            std::fill_n(win_cell(win, y, 0), win->cols, blank_cell);
+    } else if (n < 0) {
+        n = -n;
+        for (y = win->lines - 1; y >= n; --y)
+            memcpy(win_cell(win, y, 0), win_cell(win, y - n, 0),
+                   win->cols * sizeof(headless_cell));
+        for (; y >= 0; --y)
+            std::fill_n(win_cell(win, y, 0), win->cols, blank_cell);
+    }
+
+    return 0;
+}
+
+int swin_idlok(SWINDOW *win, int bf)
+{
+    win->idlok = bf;
+    return 0;
+}
+
+int swin_keypad(SWINDOW *win, int bf)
+{
+    return 0;
+}
+
+char *swin_tigetstr(const char *capname)
+{
+    return NULL;
+}
+
+int swin_move(int y, int x)
+{
+    return swin_wmove(stdscr_win, y, x);
+}
+
+int swin_wmove(SWINDOW *win, int y, int x)
+{
+    if (!win || y < 0 || y >= win->lines || x < 0 || x >= win->cols)
+        return -1;
+
+    win->cury = y;
+    win->curx = x;
+    return 0;
+}
+
+int swin_wattron(SWINDOW *win, int attrs)
+{
+    /* Turning on a color pair replaces the current one */
+    if (attrs & HEADLESS_PAIR_MASK)
+        win->attrs &= ~HEADLESS_PAIR_MASK;
+
+    win->attrs |= attrs;
+    return 0;
+}
+
+int swin_wattroff(SWINDOW *win, int attrs)
+{
+    win->attrs &= ~attrs;
+    return 0;
+}
+
+int swin_curs_set(int visibility)
+{
+    return 0;
+}
+
+int swin_getcurx(const SWINDOW *win)
+{
+    return win->curx;
+}
+
+int swin_getcury(const SWINDOW *win)
+{
+    return win->cury;
+}
+
+void swin_getsyx(int *y, int *x)
+{
+    *y = virtual_y;
+    *x = virtual_x;
+}
+
+void swin_setsyx(int y, int x)
+{
+    virtual_y = y;
+    virtual_x = x;
+}
+
+int swin_getbegx(const SWINDOW *win)
+{
+    return win->begx;
+}
+
+int swin_getbegy(const SWINDOW *win)
+{
+    return win->begy;
+}
+
+int swin_getmaxx(const SWINDOW *win)
+{
+    return win->cols;
+}
+
+int swin_getmaxy(const SWINDOW *win)
+{
+    return win->lines;
+}
+
+int swin_werase(SWINDOW *win)
+{
+    std::fill(win->cells.begin(), win->cells.end(), blank_cell);
+    win->cury = win->curx = 0;
+    return 0;
+}
+
+int swin_wvline(SWINDOW *win, SWIN_CHTYPE ch, int n)
+{
+    int y;
+
+    for (y = win->cury; y < win->lines && y < win->cury + n; ++y) {
+        headless_cell *cell = win_cell(win, y, win->curx);
+        cell->ch = ch & HEADLESS_CHAR_MASK;
+        cell->attrs = (ch & ~HEADLESS_CHAR_MASK) | win->attrs;
+    }
+
+    return 0;
+}
+
+/* Move the cursor to the start of the next line, scrolling if allowed */
+static int headless_newline(SWINDOW *win)
+{
+    if (win->cury + 1 < win->lines) {
+        win->cury++;
+    } else if (win->scrollok) {
+        swin_wscrl(win, 1);
+    } else {
+        return -1;
+    }
+
+    win->curx = 0;
+    return 0;
+}
+
+/* Put a character at the cursor and advance it, like waddch */
+static int headless_put(SWINDOW *win, int ch, int attrs)
+{
+    headless_cell *cell;
+
+    if (ch == '\n') {
+        swin_wclrtoeol(win);
+        return headless_newline(win);
+    } else if (ch == '\r') {
+        win->curx = 0;
+        return 0;
+    } else if (ch == '\b') {
+        if (win->curx > 0)
+            win->curx--;
+        return 0;
+    } else if (ch == '\t') {
+        do {
+            if (headless_put(win, ' ', attrs) == -1)
+                return -1;
+        } while (win->curx % 8 != 0);
+        return 0;
+    } else if (ch < ' ' || ch == 0x7f) {
+        /* Control characters are shown as ^X */
+        if (headless_put(win, '^', attrs) == -1)
+            return -1;
+        return headless_put(win, ch == 0x7f ? '?' : ch + '@', attrs);
+    }
+
+    cell = win_cell(win, win->cury, win->curx);
+    cell->ch = ch;
+    cell->attrs = attrs | win->attrs;
+
+    /* At the bottom right corner of a window that can't scroll, the
+     * cursor stays put */
+    if (++win->curx == win->cols && headless_newline(win) == -1) {
+        win->curx = win->cols - 1;
+        return -1;
+    }
+
+    return 0;
+}
+
+int swin_waddch(SWINDOW *win, const SWIN_CHTYPE ch)
+{
+    return headless_put(win, ch & HEADLESS_CHAR_MASK,
+                        ch & ~HEADLESS_CHAR_MASK);
+}
+
+int swin_wclrtoeol(SWINDOW *win)
+{
+    std::fill_n(win_cell(win, win->cury, win->curx),
+                win->cols - win->curx, blank_cell);
+    return 0;
+}
+
+int swin_waddnstr(SWINDOW *win, const char *str, int n)
+{
+    const unsigned char *s = (const unsigned char *)str;
+    const unsigned char *end;
+
+    if (n < 0)
+        n = strlen(str);
+    end = s + n;
+
+    while (s < end && *s) {
+        int ch = *s++;
+        int extra = 0;
+
+        /* Decode UTF-8, a bad sequence is taken a byte at a time */
+        if (ch >= 0xf0 && ch < 0xf8) {
+            extra = 3;
+            ch &= 0x07;
+        } else if (ch >= 0xe0) {
+            extra = 2;
+            ch &= 0x0f;
+        } else if (ch >= 0xc0) {
+            extra = 1;
+            ch &= 0x1f;
+        }
+
+        if (extra && end - s >= extra) {
+            int i;
+
+            for (i = 0; i < extra && (s[i] & 0xc0) == 0x80; ++i)
+                ch = (ch << 6) | (s[i] & 0x3f);
+
+            if (i == extra)
+                s += extra;
+            else
+                ch = s[-1];
+        } else if (extra) {
+            ch = s[-1];
+        }
+
+        if (headless_put(win, ch, 0) == -1)
+            return -1;
+    }
+
+    return 0;
+}
+
+int swin_wprintw(SWINDOW *win, const char *fmt, ...)
+{
+    char buf[4096];
+    va_list ap;
+
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+
+    return swin_waddnstr(win, buf, -1);
+}
+
+int swin_mvwprintw(SWINDOW *win, int y, int x, const char *fmt, ...)
+{
+    char buf[4096];
+    va_list ap;
+
+    if (swin_wmove(win, y, x) == -1)
+        return -1;
+
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+
+    return swin_waddnstr(win, buf, -1);
+}
+
+int swin_refresh()
+{
+    return swin_wrefresh(stdscr_win);
+}
+
+int swin_wnoutrefresh(SWINDOW *win)
+{
+    int y;
+
+    for (y = 0; y < win->lines; ++y) {
+        int sy = win->begy + y;
+        int cols = win->cols;
+
+        if (sy < 0 || sy >= headless_lines || win->begx >= headless_cols)
+            continue;
+
+        if (win->begx + cols > headless_cols)
+            cols = headless_cols - win->begx;
+
+        memcpy(&virtual_screen[sy * headless_cols + win->begx],
+               win_cell(win, y, 0), cols * sizeof(headless_cell));
+    }
+
+    /* Like curses, a scroll region is only used for whole screen lines */
+    if (win->idlok && win->scrolled && win->begx == 0 &&
+        win->cols == headless_cols && win->begy >= 0 &&
+        win->begy + win->lines <= headless_lines &&
+        abs(win->scrolled) < win->lines) {
+        headless_scroll scroll;
+
+        scroll.top = win->begy;
+        scroll.bottom = win->begy + win->lines - 1;
+        scroll.n = win->scrolled;
+        pending_scrolls.push_back(scroll);
+    }
+    win->scrolled = 0;
+
+    virtual_y = win->begy + win->cury;
+    virtual_x = win->begx + win->curx;
+
+    return 0;
+}
+
+int swin_wrefresh(SWINDOW *win)
+{
+    swin_wnoutrefresh(win);
+    return swin_doupdate();
+}
+
+/* The length of the UTF-8 encoding of a character */
+static int headless_utf8_len(int ch)
+{
+    if (ch < 0x80)
+        return 1;
+    else if (ch < 0x800)
+        return 2;
+    else if (ch < 0x10000)
+        return 3;
+    return 4;
+}
+
+/* The number of bytes in the SGR sequence that switches to attrs */
+static size_t headless_sgr_len(int attrs)
+{
+    char buf[128];
+    int pair = (attrs & HEADLESS_PAIR_MASK) >> HEADLESS_PAIR_SHIFT;
+    int len;
+
+    len = snprintf(buf, sizeof(buf), "\033[0%s%s%s%s%s",
+            (attrs & SWIN_A_BOLD) ? ";1" : "",
+            (attrs & SWIN_A_DIM) ? ";2" : "",
+            (attrs & SWIN_A_UNDERLINE) ? ";4" : "",
+            (attrs & SWIN_A_BLINK) ? ";5" : "",
+            (attrs & (SWIN_A_REVERSE | SWIN_A_STANDOUT)) ? ";7" : "");
+
+    if (pair && pair_fore[pair] >= 0)
+        len += snprintf(buf, sizeof(buf), ";38;5;%d", pair_fore[pair]);
+    if (pair && pair_back[pair] >= 0)
+        len += snprintf(buf, sizeof(buf), ";48;5;%d", pair_back[pair]);
+
+    return len + 1;
+}
+
+/* Scroll the lines of the terminal with a scroll region */
+static void headless_scroll_region(const headless_scroll &scroll)
+{
+    char buf[64];
+    int n = abs(scroll.n);
+    int y;
+
+    /* The exposed lines are cleared with the current background */
+    if (term_attrs) {
+        bytes_emitted += headless_sgr_len(0);
+        term_attrs = 0;
+    }
+
+    /* Set the region, scroll it and then reset it. Setting the region
+     * moves the cursor home. */
+    bytes_emitted += snprintf(buf, sizeof(buf), "\033[%d;%dr\033[%d%c\033[r",
+            scroll.top + 1, scroll.bottom + 1, n, scroll.n > 0 ? 'S' : 'T');
+    term_y = term_x = 0;
+
+    if (scroll.n > 0) {
+        for (y = scroll.top; y <= scroll.bottom - n; ++y)
+            std::copy_n(&physical_screen[(y + n) * headless_cols],
+                    headless_cols, &physical_screen[y * headless_cols]);
+        for (; y <= scroll.bottom; ++y)
+            std::fill_n(&physical_screen[y * headless_cols], headless_cols,
+                    blank_cell);
+    } else {
+        for (y = scroll.bottom; y >= scroll.top + n; --y)
+            std::copy_n(&physical_screen[(y - n) * headless_cols],
+                    headless_cols, &physical_screen[y * headless_cols]);
+        for (; y >= scroll.top; --y)
+            std::fill_n(&physical_screen[y * headless_cols], headless_cols,
+                    blank_cell);
+    }
+}
+
+int swin_doupdate()
+{
+    int y, x;
+
+    updates++;
+
+    for (const headless_scroll &scroll : pending_scrolls)
+        headless_scroll_region(scroll);
+    pending_scrolls.clear();
+
+    for (y = 0; y < headless_lines; ++y) {
+        for (x = 0; x < headless_cols; ++x) {
+            int i = y * headless_cols + x;
+            const headless_cell &want = virtual_screen[i];
+
+            if (want.ch == physical_screen[i].ch &&
+                want.attrs == physical_screen[i].attrs)
+                continue;
+
+            if (y != term_y || x != term_x) {
+                char buf[32];
+                bytes_emitted += snprintf(buf, sizeof(buf), "\033[%d;%dH",
+                        y + 1, x + 1);
+            }
+
+            if (want.attrs != term_attrs) {
+                bytes_emitted += headless_sgr_len(want.attrs);
+                term_attrs = want.attrs;
+            }
+
+            bytes_emitted += headless_utf8_len(want.ch);
+            physical_screen[i] = want;
+
+            term_y = y;
+            term_x = x + 1;
+        }
+    }
+
+    return 0;
+}
+
+int swin_init_pair(int pair, int f, int b)
+{
+    if (pair <= 0 || pair >= HEADLESS_COLOR_PAIRS)
+        return -1;
+
+    pair_fore[pair] = f;
+    pair_back[pair] = b;
+    return 0;
+}
+
+int swin_pair_content(int pair, int *fin, int *bin)
+{
+    if (pair < 0 || pair >= HEADLESS_COLOR_PAIRS)
+        return -1;
+
+    *fin = pair_fore[pair];
+    *bin = pair_back[pair];
+    return 0;
+}
+
+int swin_color_pair(int pair)
+{
+    return (pair << HEADLESS_PAIR_SHIFT) & HEADLESS_PAIR_MASK;
+}
+
+int swin_raw(void)
+{
+    return 0;
+}
@@ -0,0 +1,59 @@
+#ifndef __SYS_WIN_HEADLESS_H__
+#define __SYS_WIN_HEADLESS_H__
+
+/* A sys_win backend that draws into memory instead of a terminal.
+ *
+ * Link libcgdbheadless.a before libcgdbutil.a and the swin_* functions
+ * in sys_win.h draw into an in-memory grid of cells instead of curses.
+ * swin_doupdate compares the screen that was drawn with the one the
+ * terminal would already be showing, and counts the bytes a terminal
+ * would have been sent to update it. This allows the cost of drawing to
+ * be measured without a terminal.
+ */
+
+#include <stddef.h>
+
+/**
+ * Set the size of the screen swin_initscr creates.
+ *
+ * The default is 24 lines by 80 columns.
+ *
+ * @param lines
+ * The height of the screen
+ *
+ * @param cols
+ * The width of the screen
+ */
+void swin_headless_set_size(int lines, int cols);
+
+/**
+ * The number of bytes the screen updates would have written to the
+ * terminal since the screen was created.
+ *
+ * Cursor movement, attribute changes and characters are counted as an
+ * xterm would be sent them. Changes are sent cell by cell, without the
+ * scrolling and line insertion tricks curses can use.
+ */
+size_t swin_headless_bytes_emitted(void);
+
+/**
+ * The number of times swin_doupdate has been called since the screen
+ * was created.
+ */
+size_t swin_headless_updates(void);
+
+/**
+ * Get what the terminal would be showing.
+ *
+ * @param y
+ * The line of the screen
+ *
+ * @param x
+ * The column of the screen
+ *
+ * @return
+ * The character at that position, or 0 if it is off the screen.
+ */
+int swin_headless_char_at(int y, int x);
+
+#endif
@@ -1,5 +1,11 @@
 #include "vterm_internal.h"
 
+#include <string.h>
+
+#if defined(__SSE2__) && defined(__GNUC__)
+# include <emmintrin.h>
+#endif
+
 #define UNICODE_INVALID 0xFFFD
 
 #if defined(DEBUG) && DEBUG > 1
@@ -175,6 +181,51 @@ static void decode_usascii(VTermEncoding *enc, void *data,
   }
 }
 
+/* Bytes 0x20 to 0x7e are printable ASCII. SCAN_ONES is a 1 in every byte
+ * of a word, so SCAN_ONES * n is n in every byte. */
+#define SCAN_ONES ((uint64_t)0x0101010101010101ULL)
+
+size_t vterm_scan_ascii(const char bytes[], size_t len)
+{
+  size_t pos = 0;
+
+#if defined(__SSE2__) && defined(__GNUC__)
+  const __m128i below = _mm_set1_epi8(0x1f);
+  const __m128i above = _mm_set1_epi8(0x7f);
+
+  for(; pos + 16 <= len; pos += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(bytes + pos));
+    /* The compares are signed, so bytes with the high bit set are below
+     * 0x1f and fail the first one */
+    __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(v, below),
+                                      _mm_cmplt_epi8(v, above));
+    int mask = _mm_movemask_epi8(printable);
+
+    if(mask != 0xffff)
+      return pos + __builtin_ctz(~mask);
+  }
+#else
+  for(; pos + 8 <= len; pos += 8) {
+    uint64_t v;
+    memcpy(&v, bytes + pos, sizeof(v));
+
+    /* The high bit of a byte is set in the first term if it is below 0x20,
+     * in the second if it is 0x7f and in the third if it's 0x80 or above */
+    if((((v - SCAN_ONES * 0x20) & ~v) | (v + SCAN_ONES) | v) & (SCAN_ONES * 0x80))
+      break;
+  }
+#endif
+
+  for(; pos < len; pos++) {
+    unsigned char c = bytes[pos];
+
+    if(c < 0x20 || c >= 0x7f)
+      break;
+  }
+
+  return pos;
+}
+
 static VTermEncoding encoding_usascii = {
   .decode = &decode_usascii,
 };
@@ -220,6 +271,18 @@ encodings[] = {
   { 0 },
 };
 
+bool vterm_encoding_is_ascii(VTermEncoding *enc, void *data)
+{
+  if(enc == &encoding_usascii)
+    return true;
+
+  /* UTF-8 decodes ASCII to itself, unless it ends a partial codepoint */
+  if(enc == &encoding_utf8)
+    return ((struct UTF8DecoderData *)data)->bytes_remaining == 0;
+
+  return false;
+}
+
 /* This ought to be INTERNAL but isn't because it's used by unit testing */
 VTermEncoding *vterm_lookup_encoding(VTermEncodingType type, char designation)
 {
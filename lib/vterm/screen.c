@@ -199,6 +199,38 @@ static int putglyph(VTermGlyphInfo *info, VTermPos pos, void *user)
   return 1;
 }
 
+static int putglyphs(const uint32_t chars[], int count, VTermGlyphInfo *info, VTermPos pos, void *user)
+{
+  VTermScreen *screen = user;
+  ScreenCell *cell = getcell(screen, pos.row, pos.col);
+
+  if(!cell || pos.col + count > screen->cols)
+    return 0;
+
+  ScreenPen pen = screen->pen;
+  pen.protected_cell = info->protected_cell;
+  pen.dwl            = info->dwl;
+  pen.dhl            = info->dhl;
+
+  for(int i = 0; i < count; i++, cell++) {
+    cell->chars[0] = chars[i];
+    cell->chars[1] = 0;
+    cell->pen = pen;
+  }
+
+  /* One damage rect for the whole run */
+  VTermRect rect = {
+    .start_row = pos.row,
+    .end_row   = pos.row+1,
+    .start_col = pos.col,
+    .end_col   = pos.col+count,
+  };
+
+  damagerect(screen, rect);
+
+  return 1;
+}
+
 static void sb_pushline_from_row(VTermScreen *screen, int row)
 {
   VTermPos pos = { .row = row };
@@ -267,17 +299,19 @@ static int erase_internal(VTermRect rect, int selective, void *user)
 
   for(int row = rect.start_row; row < screen->state->rows && row < rect.end_row; row++) {
     const VTermLineInfo *info = vterm_state_get_lineinfo(screen->state, row);
+    ScreenCell *cell = getcell(screen, row, rect.start_col);
 
-    for(int col = rect.start_col; col < rect.end_col; col++) {
-      ScreenCell *cell = getcell(screen, row, col);
+    /* Every cell in the row gets the same pen */
+    ScreenPen pen = screen->pen;
+    pen.dwl = info->doublewidth;
+    pen.dhl = info->doubleheight;
 
+    for(int col = rect.start_col; col < rect.end_col; col++, cell++) {
       if(selective && cell->pen.protected_cell)
         continue;
 
       cell->chars[0] = 0;
-      cell->pen = screen->pen;
-      cell->pen.dwl = info->doublewidth;
-      cell->pen.dhl = info->doubleheight;
+      cell->pen = pen;
     }
   }
 
@@ -657,6 +691,7 @@ static VTermStateCallbacks state_cbs = {
   .bell        = &bell,
   .resize      = &resize,
   .setlineinfo = &setlineinfo,
+  .putglyphs   = &putglyphs,
 };
 
 static VTermScreen *screen_new(VTerm *vt)
@@ -28,6 +28,27 @@ static void putglyph(VTermState *state, const uint32_t chars[], int width, VTerm
   DEBUG_LOG("libvterm: Unhandled putglyph U+%04x at (%d,%d)\n", chars[0], pos.col, pos.row);
 }
 
+static void putglyphs(VTermState *state, const uint32_t chars[], int count, VTermPos pos)
+{
+  VTermGlyphInfo info = {
+    .chars = NULL,
+    .width = 1,
+    .protected_cell = state->protected_cell,
+    .dwl = state->lineinfo[pos.row].doublewidth,
+    .dhl = state->lineinfo[pos.row].doubleheight,
+  };
+
+  if(state->callbacks && state->callbacks->putglyphs)
+    if((*state->callbacks->putglyphs)(chars, count, &info, pos, state->cbdata))
+      return;
+
+  for(int i = 0; i < count; i++) {
+    uint32_t glyph[2] = { chars[i], 0 };
+    putglyph(state, glyph, 1, pos);
+    pos.col++;
+  }
+}
+
 static void updatecursor(VTermState *state, VTermPos *oldpos, int cancel_phantom)
 {
   if(state->pos.col == oldpos->col && state->pos.row == oldpos->row)
@@ -269,10 +290,80 @@ static void set_lineinfo(VTermState *state, int row, int force, int dwl, int dhl
     state->lineinfo[row] = info;
 }
 
+/* Printable ASCII in the US-ASCII or UTF-8 character sets needs no decoding,
+ * never combines and is always one column wide, so a run of it skips all that
+ * and is put on the screen a row at a time */
+static size_t on_text_ascii(VTermState *state, const char bytes[], size_t len)
+{
+  VTermPos oldpos = state->pos;
+  uint32_t chars[state->cols > 0 ? state->cols : 1];
+
+  for(size_t i = 0; i < len; ) {
+    if(state->at_phantom || state->pos.col + 1 > THISROWWIDTH(state)) {
+      linefeed(state);
+      state->pos.col = 0;
+      state->at_phantom = 0;
+      state->lineinfo[state->pos.row].continuation = 1;
+    }
+
+    /* As much as fits on the row, or one char at a time in insert mode */
+    int count = THISROWWIDTH(state) - state->pos.col;
+    if(state->mode.insert || count < 1)
+      count = 1;
+    if((size_t)count > len - i)
+      count = len - i;
+
+    if(state->mode.insert) {
+      VTermRect rect = {
+        .start_row = state->pos.row,
+        .end_row   = state->pos.row + 1,
+        .start_col = state->pos.col,
+        .end_col   = THISROWWIDTH(state),
+      };
+      scroll(state, rect, 0, -1);
+    }
+
+    for(int j = 0; j < count; j++)
+      chars[j] = (unsigned char)bytes[i + j];
+    putglyphs(state, chars, count, state->pos);
+
+    i += count;
+    state->pos.col += count - 1;
+
+    if(i == len) {
+      /* Save the char in case the next call starts with combining chars */
+      state->combine_chars[0] = chars[count - 1];
+      state->combine_chars[1] = 0;
+      state->combine_width = 1;
+      state->combine_pos = state->pos;
+    }
+
+    if(state->pos.col + 1 >= THISROWWIDTH(state)) {
+      if(state->mode.autowrap)
+        state->at_phantom = 1;
+    }
+    else {
+      state->pos.col++;
+    }
+  }
+
+  updatecursor(state, &oldpos, 0);
+
+  return len;
+}
+
 static int on_text(const char bytes[], size_t len, void *user)
 {
   VTermState *state = user;
 
+  if(!state->gsingle_set &&
+     vterm_encoding_is_ascii(state->encoding[state->gl_set].enc,
+                             state->encoding[state->gl_set].data)) {
+    size_t ascii = vterm_scan_ascii(bytes, len);
+    if(ascii)
+      return on_text_ascii(state, bytes, ascii);
+  }
+
   VTermPos oldpos = state->pos;
 
   // We'll have at most len codepoints
@@ -403,6 +403,10 @@ typedef struct {
   int (*bell)(void *user);
   int (*resize)(int rows, int cols, VTermStateFields *fields, void *user);
   int (*setlineinfo)(int row, const VTermLineInfo *newinfo, const VTermLineInfo *oldinfo, void *user);
+  /* Optional. Puts count glyphs of a single codepoint and width 1 on one row,
+   * starting at pos, all with the same info. info->chars is unused. If it is
+   * NULL or returns 0, putglyph is called for each glyph instead. */
+  int (*putglyphs)(const uint32_t chars[], int count, VTermGlyphInfo *info, VTermPos pos, void *user);
 } VTermStateCallbacks;
 
 typedef struct {
@@ -0,0 +1,163 @@
+/* vterm_bench: Measures how fast libvterm takes in terminal output.
+ *
+ * Usage: vterm_bench [-n iterations] [-r rows] [-c cols] [file...]
+ *
+ * Each file, or by default a few generated samples of the kind of output
+ * seen in the GDB window, is written to a screen over and over. The rate
+ * the fastest pass was taken in at is reported in MB/s.
+ */
+
+#include "vterm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* The size of each generated sample */
+#define SAMPLE_SIZE (1024 * 1024)
+
+struct sample {
+  const char *name;
+  char *bytes;
+  size_t len;
+};
+
+static double now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void append(struct sample *sample, const char *str)
+{
+  size_t len = strlen(str);
+
+  if(sample->len + len > SAMPLE_SIZE)
+    len = SAMPLE_SIZE - sample->len;
+
+  memcpy(sample->bytes + sample->len, str, len);
+  sample->len += len;
+}
+
+/* Fills sample with lines made from the given pieces, round robin */
+static void generate(struct sample *sample, const char *name,
+    const char *const pieces[], int npieces)
+{
+  int i = 0;
+
+  sample->name = name;
+  sample->bytes = malloc(SAMPLE_SIZE);
+  sample->len = 0;
+
+  while(sample->len < SAMPLE_SIZE)
+    append(sample, pieces[i++ % npieces]);
+}
+
+static int load(struct sample *sample, const char *path)
+{
+  FILE *fp = fopen(path, "rb");
+  long size;
+
+  if(!fp) {
+    fprintf(stderr, "vterm_bench: can't open %s\n", path);
+    return -1;
+  }
+
+  fseek(fp, 0, SEEK_END);
+  size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+
+  sample->name = path;
+  sample->bytes = malloc(size > 0 ? size : 1);
+  sample->len = fread(sample->bytes, 1, size > 0 ? size : 0, fp);
+  fclose(fp);
+
+  return 0;
+}
+
+static void run(const struct sample *sample, int iterations, int rows, int cols)
+{
+  VTerm *vt = vterm_new(rows, cols);
+  VTermScreen *vts;
+  double best = 0;
+
+  vterm_set_utf8(vt, 1);
+  vts = vterm_obtain_screen(vt);
+  /* The same damage merging as the GDB window */
+  vterm_screen_set_damage_merge(vts, VTERM_DAMAGE_SCREEN);
+  vterm_screen_reset(vts, 1);
+
+  /* Report the fastest pass, the others are slowed by everything else
+   * running on the machine */
+  for(int i = 0; i < iterations; i++) {
+    double start = now();
+    vterm_input_write(vt, sample->bytes, sample->len);
+    double elapsed = now() - start;
+
+    if(i == 0 || elapsed < best)
+      best = elapsed;
+  }
+
+  printf("%-12s %8.1f MB/s\n", sample->name,
+      (double)sample->len / (1024 * 1024) / best);
+
+  vterm_free(vt);
+}
+
+int main(int argc, char *argv[])
+{
+  static const char *const ascii[] = {
+    "Breakpoint 1, main (argc=1, argv=0x7fffffffe4a8) at main.c:12\r\n",
+    "12\t    int result = compute(argc, argv);\r\n",
+    "#0  compute (n=42, values=0x5555555592a0) at compute.c:87\r\n",
+    "$1 = {x = 10, y = 20, name = 0x555555556004 \"origin\"}\r\n",
+  };
+  static const char *const utf8[] = {
+    "Breakpoint 1, main () at caf\xc3\xa9.c:12\r\n",
+    "$1 = \"na\xc3\xafve \xe2\x86\x92 r\xc3\xa9sum\xc3\xa9\"\r\n",
+    "#0  \xe6\xb8\xac\xe8\xa9\xa6 (n=42) at test.c:87\r\n",
+  };
+  static const char *const sgr[] = {
+    "\x1b[1;32mBreakpoint 1\x1b[m, \x1b[33mmain\x1b[m (argc=1) at ",
+    "\x1b[32mmain.c\x1b[m:12\r\n",
+    "\x1b[34m12\x1b[m\t    int result = \x1b[1mcompute\x1b[m(argc, argv);\r\n",
+  };
+
+  struct sample samples[16];
+  int nsamples = 0;
+  int iterations = 20;
+  int rows = 50;
+  int cols = 200;
+  int i;
+
+  for(i = 1; i < argc; i++) {
+    if(strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      iterations = atoi(argv[++i]);
+    else if(strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+      rows = atoi(argv[++i]);
+    else if(strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+      cols = atoi(argv[++i]);
+    else if(argv[i][0] == '-') {
+      fprintf(stderr, "Usage: vterm_bench [-n iterations] [-r rows] [-c cols] [file...]\n");
+      return 1;
+    }
+    else if(nsamples < 16 && load(&samples[nsamples], argv[i]) == 0)
+      nsamples++;
+  }
+
+  if(nsamples == 0) {
+    generate(&samples[nsamples++], "ascii", ascii, 4);
+    generate(&samples[nsamples++], "utf8", utf8, 3);
+    generate(&samples[nsamples++], "sgr", sgr, 3);
+  }
+
+  for(i = 0; i < nsamples; i++) {
+    run(&samples[i], iterations, rows, cols);
+    free(samples[i].bytes);
+  }
+
+  return 0;
+}
@@ -286,6 +286,11 @@ void vterm_screen_free(VTermScreen *screen);
 
 VTermEncoding *vterm_lookup_encoding(VTermEncodingType type, char designation);
 
+/* The number of bytes at the start of bytes that are printable ASCII */
+size_t vterm_scan_ascii(const char bytes[], size_t len);
+/* True if enc, in its current state, decodes printable ASCII to itself */
+bool vterm_encoding_is_ascii(VTermEncoding *enc, void *data);
+
 int vterm_unicode_width(uint32_t codepoint);
 int vterm_unicode_is_combining(uint32_t codepoint);
 